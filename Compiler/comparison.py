@@ -660,15 +660,98 @@ def Mod2(a_0, a, k, kappa, signed):
     subs(a_0, t[5], t[4])
 
 @instructions_base.cisc
-def MTS(useless, res, x, spline_address, parallel, length):
-    from .types import cfix, sfix
+def MTS(res, x, breaks, n_breaks):
     """
-    res[i] = (x ?< a[i])
+    res[j * n:(j + 1) * n] = (breaks[j - 1] <= x < breaks[j])
 
-    k: bit length of a
+    breaks: clear vector of sorted breakpoints
+    n_breaks: compile-time length of breaks
     """
-    print("Calling expand of MTS, Errors will occured!")
-    return res
-        
+    raise CompilerError('multi-interval containment is only available '
+                        'as CISC instruction, compile with -C -K MTS')
+
+def keeps_cisc(name):
+    keep = program.options.keep_cisc
+    return program.options.cisc and keep is not None and \
+        name in keep.split(',')
+
+def MultiIntervalContainment(a, breaks):
+    """
+    Indicators of a being in the segments defined by sorted breakpoints,
+    that is (-inf, breaks[0]), [breaks[0], breaks[1]), ...,
+    [breaks[-1], inf).
+
+    a: sint or vector of sint
+    breaks: list of compile-time integers in the representation of a
+    """
+    from .types import sint, cint
+    n = a.size
+    m = len(breaks) + 1
+    if keeps_cisc('MTS') and breaks:
+        res = sint(size=n * m)
+        MTS(res, a, cint(breaks), len(breaks))
+        return [res.get_vector(j * n, n) for j in range(m)]
+    below = [a < x for x in breaks] + [1]
+    return [below[0]] + [below[j] - below[j - 1] for j in range(1, m)]
+
+@instructions_base.cisc
+def ReLUTrunc(res, x, m):
+    """
+    res[:n] = max(x, 0) >> m (probabilistic rounding)
+    res[n:] = (x >= 0)
+
+    m: compile-time shift
+    """
+    raise CompilerError('fused ReLU is only available as CISC instruction, '
+                        'compile with -C -K ReLUTrunc')
+
+def TruncatedReLU(a, k, m):
+    """
+    ReLU of a followed by truncation by m bits, together with the
+    derivative bit. Uses one fused FSS gate if ReLUTrunc is kept as CISC
+    instruction.
+
+    a: sint or vector of sint of bit length k
+    """
+    from .types import sint
+    if keeps_cisc('ReLUTrunc'):
+        n = a.size
+        res = sint(size=2 * n)
+        ReLUTrunc(res, a, m)
+        return res.get_vector(0, n), res.get_vector(n, n)
+    bit = 1 - (a < 0)
+    return bit * a.round(k, m, signed=True), bit
+
+@instructions_base.cisc
+def LUT(res, index, table, size):
+    """
+    res = table[index]
+
+    table: clear vector
+    size: compile-time length of table
+    """
+    raise CompilerError('FSS table lookup is only available as CISC '
+                        'instruction, compile with -C -K LUT')
+
+def TableLookup(index, table):
+    """
+    Entries of a public table at secret indices. Uses one FSS point
+    function per index if LUT is kept as CISC instruction and an equality
+    test per table entry otherwise.
+
+    index: sint or vector of sint
+    table: list of compile-time integers or Array of cint
+    """
+    from .types import sint, cint
+    if keeps_cisc('LUT'):
+        if isinstance(table, list):
+            values = cint(table)
+        else:
+            values = table.get_vector()
+        res = sint(size=index.size)
+        LUT(res, index, values, len(table))
+        return res
+    return sum((index == i) * table[i] for i in range(len(table)))
+
 # hack for circular dependency
 from .instructions import *
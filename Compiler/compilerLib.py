@@ -213,6 +213,13 @@ class Compiler:
             help="speedup inverse permutation (only use in two-party, "
             "semi-honest environment)"
         )
+        parser.add_option(
+            "--radixsort",
+            action="store_true",
+            dest="radixsort",
+            help="native radix sorting (only use with three-party "
+            "replicated secret sharing)"
+        )
         parser.add_option(
             "-C",
             "--CISC",
@@ -78,22 +78,13 @@ def At(x, breaks, coeffA, scaler):
         for j in range(degree):
             poss_res[i] += coeffA[i][j+1] * pre_muls[j] * scaler[i][j+1]
             
-    # 将 x 与断点依次比较
-    comp = sfix.Array(m)
-    for i in range(m):
-        comp[i] = (x >= breaks[i])
-
-    # 保留最后一个比较成功的位置为 1 ，其它置回 0
-    cipher_index = sfix.Array(m)
-    @for_range_opt(m-1)
-    def f(i):
-        cipher_index[i] = comp[i+regint(1)]
-    @for_range_opt(m)
-    def f(i):
-        cipher_index[i] = comp[i]*(comp[i] - cipher_index[i])
+    # 每段的指示位，使用 FSS 时 (-K MTS) 只需一次打开
+    # 否则每个断点比较一次；第一段 (-inf, breaks[0]) 不使用
+    cipher_index = x.multi_spline(breaks)[1:]
 
     # 计算每段函数值向量与位置向量的点积
-    return sfix.dot_product(cipher_index, poss_res)
+    return sfix._new(sint.dot_product(cipher_index,
+                                      [poss_res[i].v for i in range(m)]))
 
 def GFA(kmax=10, f=44, n=96, range=(-10,10), derivative=True):
     def x(func):
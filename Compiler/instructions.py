@@ -546,6 +546,15 @@ class stop_grind(base.IOInstruction):
     code = base.opcodes['STOPGRIND']
     arg_format = []
 
+class checkpoint(base.IOInstruction):
+    """ Write memory and the registers of the main thread to
+    ``Player-Data/Checkpoint-<protocol>-P<party>`` if enabled at run
+    time (``--checkpoint``). Only possible in the main thread while no
+    other thread is running. Running with ``--restore`` continues
+    after the last checkpoint. """
+    code = base.opcodes['CHECKPOINT']
+    arg_format = []
+
 @base.gf2n
 class use_prep(base.Instruction):
     """ Custom preprocessed data usage.
@@ -3077,6 +3086,9 @@ class shuffle_base(base.DataInstruction):
         return res[1], res[3]
 
     def add_gen_usage(self, req_node, n):
+        # empty shuffles are not configured
+        if n == 0:
+            return
         cost_func = program.get_cost("shufflegen")
         if cost_func == -1:
             print("The profiling results could be biased")
@@ -3203,6 +3215,54 @@ class inverse_permutation(base.VectorInstruction, shuffle_base):
         self.add_gen_usage(req_node, len(self.args[0]))
         self.add_apply_usage(req_node, len(self.args[0]), 1)
 
+class radixsort(base.VectorInstruction, shuffle_base):
+    """ Stable sort by secret key bits using the native protocol
+    (three-party replicated secret sharing only).
+
+    :param: destination (sint)
+    :param: source (sint)
+    :param: key bits, least significant first (sint, vector of size times number of bits)
+    :param: number of bits (int)
+
+    """
+    __slots__ = []
+    code = base.opcodes['RADIXSORT']
+    arg_format = ['sw','s','s','int']
+
+    def __init__(self, *args, **kwargs):
+        super(radixsort, self).__init__(*args, **kwargs)
+        assert len(args[0]) == len(args[1])
+        assert args[3] > 0
+        assert len(args[2]) == len(args[0]) * args[3]
+
+    def add_usage(self, req_node):
+        for i in range(self.args[3]):
+            self.add_gen_usage(req_node, len(self.args[0]))
+            self.add_apply_usage(req_node, len(self.args[0]), 2)
+
+class genradixperm(base.VectorInstruction, shuffle_base):
+    """ Destinations of a stable sort by secret key bits using the
+    native protocol (three-party replicated secret sharing only).
+
+    :param: destination (sint)
+    :param: key bits, least significant first (sint, vector of size times number of bits)
+    :param: number of bits (int)
+
+    """
+    __slots__ = []
+    code = base.opcodes['GENRADIXPERM']
+    arg_format = ['sw','s','int']
+
+    def __init__(self, *args, **kwargs):
+        super(genradixperm, self).__init__(*args, **kwargs)
+        assert args[2] > 0
+        assert len(args[1]) == len(args[0]) * args[2]
+
+    def add_usage(self, req_node):
+        for i in range(self.args[2] + 1):
+            self.add_gen_usage(req_node, len(self.args[0]))
+            self.add_apply_usage(req_node, len(self.args[0]), 2)
+
 
 class check(base.Instruction):
     """
@@ -72,6 +72,7 @@ opcodes = dict(
     PLAYERID = 0xE4,
     USE_EDABIT = 0xE5,
     USE_MATMUL = 0x1F,
+    CHECKPOINT = 0xEA,
     # Addition
     ADDC = 0x20,
     ADDS = 0x21,
@@ -119,6 +120,8 @@ opcodes = dict(
     APPLYSHUFFLE = 0xFC,
     DELSHUFFLE = 0xFD,
     INVPERM = 0xFE,
+    RADIXSORT = 0xE8,
+    GENRADIXPERM = 0xE9,
     # Data access
     TRIPLE = 0x50,
     BIT = 0x51,
@@ -428,6 +431,9 @@ def gf2n(instruction):
 class Mergeable:
     pass
 
+# CISC instructions without expansion in the compiler
+cisc_only = ("MTS", "ReLUTrunc", "LUT")
+
 def cisc(function):
     class MergeCISC(Mergeable):
         instructions = {}
@@ -511,7 +517,7 @@ def cisc(function):
             reset_global_vector_size()
 
         def expand_merged(self, skip):
-            if function.__name__ == "MTS":
+            if function.__name__ in cisc_only:
                 return [self], 0
             if function.__name__ in skip:
                 good = True
@@ -615,7 +621,9 @@ def cisc(function):
                 # print(same_sizes)
             except:
                 pass
-        if program.options.cisc and same_sizes:
+        # these have several outputs per input
+        if program.options.cisc and (same_sizes or
+                                     function.__name__ in cisc_only):
             return MergeCISC(*args, **kwargs)
         else:
             return function(*args, **kwargs)
@@ -66,7 +66,7 @@ from Compiler.types import *
 from Compiler.types import _unreduced_squant
 from Compiler.library import *
 from Compiler.util import is_zero, tree_reduce
-from Compiler.comparison import CarryOutRawLE
+from Compiler.comparison import CarryOutRawLE, TruncatedReLU, keeps_cisc
 from Compiler.GC.types import sbitint
 from functools import reduce
 
@@ -970,6 +970,9 @@ class Dense(DenseBase):
 
         self.debug = debug
 
+        # ReLU and truncation after multiplication in one FSS gate
+        self.fused_relu = activation == 'relu' and keeps_cisc('ReLUTrunc')
+
         l = self.activation_layer
         if l:
             self.f_input = l.X
@@ -999,6 +1002,9 @@ class Dense(DenseBase):
     def compute_f_input(self, batch):
         N = len(batch)
         assert self.d == 1
+        if self.fused_relu:
+            self.compute_fused_relu(batch)
+            return
         if self.input_bias:
             prod = MultiArray([N, self.d, self.d_out], sfix)
         else:
@@ -1027,13 +1033,36 @@ class Dense(DenseBase):
                     self.f_input[i].assign_vector(v)
         progress('f input')
 
+    def compute_fused_relu(self, batch):
+        N = len(batch)
+        prod = MultiArray([N, self.d, self.d_out], sint)
+        max_size = program.Program.prog.budget // self.d_out
+
+        @multithread(self.n_threads, N, max_size)
+        def _(base, size):
+            X_sub = sfix.Matrix(self.N, self.d_in, address=self.X.address)
+            prod.assign_part_vector(
+                X_sub.direct_mul(self.W, reduce=False, indices=(
+                    batch.get_vector(base, size), regint.inc(self.d_in),
+                    regint.inc(self.d_in), regint.inc(self.d_out))).v, base)
+
+        @for_range_multithread(self.n_threads, 100, N)
+        def _(i):
+            v = prod[i].get_vector()
+            if self.input_bias:
+                v += self.b.get_vector().v << sfix.f
+            y, bit = TruncatedReLU(v, sfix.k + sfix.f, sfix.f)
+            self.Y[i].assign_vector(sfix._new(y))
+            self.activation_layer.comparisons[i].assign_vector(bit)
+        progress('f input')
+
     @buildingblock("Dense")
     def _forward(self, batch=None):
         if batch is None:
             batch = regint.Array(self.N)
             batch.assign(regint.inc(self.N))
         self.compute_f_input(batch=batch)
-        if self.activation_layer:
+        if self.activation_layer and not self.fused_relu:
             self.activation_layer.forward(batch)
         if self.debug_output:
             print_ln('dense X %s', self.X.reveal_nested())
@@ -2874,6 +2903,7 @@ class Optimizer:
             if self.time_training:
                 time()
             i.iadd(1)
+            checkpoint()
             res = True
             if self.tol > 0:
                 res *= (1 - (loss_sum >= 0) * \
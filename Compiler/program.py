@@ -183,6 +183,7 @@ class Program(object):
         self._edabit = options.edabit
         """ Whether to use the low-level INVPERM instruction (only implemented with the assumption of a semi-honest two-party environment)"""
         self._invperm = options.invperm
+        self._radixsort = options.radixsort
         self._split = False
         if options.split:
             self.use_split(int(options.split))
@@ -628,6 +629,20 @@ class Program(object):
             self._invperm = change
 
 
+    def use_radixsort(self, change=None):
+        """ Set whether to use the low-level RADIXSORT and GENRADIXPERM
+        instructions for radix sorting (see :py:func:`Compiler.sorting.radix_sort`). These instructions are only implemented for three-party replicated secret sharing. If false, sorting uses shuffles and reveals in the high-level language.
+
+        :param change: change setting if not :py:obj:`None`
+        :returns: setting if :py:obj:`change` is :py:obj:`None`
+        """
+        if change is None:
+            if not self._radixsort:
+                self.relevant_opts.add("radixsort")
+            return self._radixsort
+        else:
+            self._radixsort = change
+
     def use_edabit_for(self, *args):
         return True
 
@@ -690,6 +705,8 @@ class Program(object):
             self.use_edabit(True)
         if "invperm" in self.args:
             self.use_invperm(True)
+        if "radixsort" in self.args:
+            self.use_radixsort(True)
         if "linear_rounds" in self.args:
             self.linear_rounds(True)
 
@@ -845,7 +862,7 @@ class Tape:
         def expand_cisc(self):
             new_instructions = []
             if self.parent.program.options.keep_cisc is not None:
-                skip = [ "Trunc", "MTS"]
+                skip = [ "Trunc", "MTS", "ReLUTrunc", "LUT"]
                 skip += self.parent.program.options.keep_cisc.split(",")
             else:
                 skip = []
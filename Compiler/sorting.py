@@ -36,7 +36,13 @@ def radix_sort(k, D, n_bits=None, signed=True):
     bs = types.Matrix.create_from(k.get_vector().bit_decompose(n_bits))
     if signed and len(bs) > 1:
         bs[-1][:] = bs[-1][:].bit_not()
-    radix_sort_from_matrix(bs, D)
+    if library.get_program().use_radixsort() and \
+       isinstance(D, types.Array) and D.value_type == types.sint:
+        res = types.sint(size=len(D))
+        instructions.radixsort(res, D.get_vector(), bs.get_vector(), len(bs))
+        D.assign_vector(res)
+    else:
+        radix_sort_from_matrix(bs, D)
 
 def radix_sort_from_matrix(bs, D):
     n = len(D)
@@ -143,6 +149,12 @@ def gen_perm_by_radix_sort(k, n_bits=None, signed=True):
     bs = types.Matrix.create_from(k.get_vector().bit_decompose(n_bits))
     if signed and len(bs) > 1:
         bs[-1][:] = bs[-1][:].bit_not()
+    if library.get_program().use_radixsort():
+        perm = SortPerm(length=len(k))
+        res = types.sint(size=len(k))
+        instructions.genradixperm(res, bs.get_vector(), len(bs))
+        perm.assign(res)
+        return perm
     perm = SortPerm(bs[0])
     @library.for_range(1,len(bs))
     def _(i):
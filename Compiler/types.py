@@ -2945,7 +2945,9 @@ class sint(_secret, _int):
 
     def secure_permute(self, shuffle, unit_size=1, reverse=False):
         res = sint(size=self.size)
-        applyshuffle(res, self, unit_size, shuffle, reverse)
+        # vector instructions cannot be empty
+        if self.size:
+            applyshuffle(res, self, unit_size, shuffle, reverse)
         return res
 
     def inverse_permutation(self):
@@ -4805,13 +4807,13 @@ class sfix(_fix):
         return self._new(self.v.prefix_sum(), k=self.k, f=self.f)
     
     def multi_spline(self, splines):
-        "patially right, how to parallel them?" 
-        t = sint.Array(len(splines))
-        for i in range(len(splines)):
-            tmp = sint()
-            comparison.MTS(tmp, self.v, splines[:][i].v, len(splines))
-            t[i] = tmp
-        return t[:]
+        """ Indicators of the segments between sorted breakpoints, see
+        :py:func:`~Compiler.comparison.MultiIntervalContainment`.
+
+        :param splines: sorted list of compile-time numbers
+        :returns: list of :py:class:`sint`, one more than breakpoints """
+        return comparison.MultiIntervalContainment(
+            self.v, [cfix.int_rep(x, self.f, self.k) for x in splines])
     
     def multi_spline_ltz(self, splines):
         t = sint.Array(len(splines))
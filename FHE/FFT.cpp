@@ -240,7 +240,16 @@ void BFFT(vector<modp>& ans,const vector<modp>& a,const FFT_Data& FFTD,bool forw
   int r=0;
   if (forward==false) { r=1; }
 
-  if (FFTD.twop>0)
+  if (FFTD.twop>0 and FFT_Data::use_rns)
+     { // exact convolution with word-size primes
+       vector<modp> x(a.size()), y;
+       for (unsigned int i=0; i<a.size(); i++)
+         { Mul(x[i],FFTD.powers[r][i],a[i],FFTD.get_prD()); }
+       FFTD.get_bluestein().convolve(y,x,r,n-1,n);
+       for (int i=0; i<n; i++)
+         { Mul(ans[i],y[i],FFTD.powers_i[r][i],FFTD.get_prD()); }
+     }
+  else if (FFTD.twop>0)
      { vector<modp> x(k2);
        for (unsigned int i=0; i<a.size(); i++)
          { Mul(x[i],FFTD.powers[r][i],a[i],FFTD.get_prD()); }
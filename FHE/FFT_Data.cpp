@@ -4,7 +4,11 @@
 #include "FHE/Subroutines.h"
 
 #include "Math/modp.hpp"
+#include "Tools/Lock.h"
 
+bool FFT_Data::use_rns = true;
+
+static Lock rns_lock;
 
 
 FFT_Data::FFT_Data() :
@@ -17,6 +21,8 @@ void FFT_Data::init(const Ring& Rg,const Zp_Data& PrD)
   R=Rg;
   prData=PrD;
   root.resize(2);
+  bluestein.reset();
+  product.reset();
 
   // Find which case we are in 
   int hwt=Hwt(Rg.m());
@@ -95,6 +101,67 @@ void FFT_Data::compute_roots(int n)
 }
 
 
+const RNS_Data& FFT_Data::get_bluestein() const
+{
+  // only the first call per object takes the lock
+  auto res = atomic_load(&bluestein);
+  if (res)
+    return *res;
+
+  rns_lock.lock();
+  res = atomic_load(&bluestein);
+  if (not res)
+    {
+      // the convolution in BFFT with the inverse transform of b[r],
+      // which also contains the factor twop
+      assert(twop > 0);
+      res.reset(new RNS_Data(twop, numBits(m()) + 2 * numBits(get_prime()),
+          prData));
+      for (int r = 0; r < 2; r++)
+        {
+          vector<modp> tmp = b[r];
+          FFT_Iter(tmp, twop, two_root[1], prData);
+          vector<bigint> kernel(twop);
+          for (int i = 0; i < twop; i++)
+            to_bigint(kernel[i], tmp[i], prData);
+          res->add_kernel(kernel);
+        }
+      atomic_store(&bluestein, res);
+    }
+  rns_lock.unlock();
+  return *res;
+}
+
+const RNS_Data& FFT_Data::get_product() const
+{
+  auto res = atomic_load(&product);
+  if (res)
+    return *res;
+
+  rns_lock.lock();
+  res = atomic_load(&product);
+  if (not res)
+    {
+      int N = phi_m();
+      if (twop != 0)
+        N = 1 << numBits(2 * phi_m() - 1);
+      // compensate for the product of two Montgomery representations
+      bigint factor = 1;
+      if (prData.get_mont())
+        {
+          factor <<= 64 * prData.get_t();
+          mpz_invert(factor.get_mpz_t(), factor.get_mpz_t(),
+              get_prime().get_mpz_t());
+        }
+      res.reset(new RNS_Data(N, numBits(phi_m()) + 2 * numBits(get_prime()),
+          prData, factor));
+      atomic_store(&product, res);
+    }
+  rns_lock.unlock();
+  return *res;
+}
+
+
 void FFT_Data::hash(octetStream& o) const
 {
   octetStream tmp;
@@ -130,6 +197,8 @@ void FFT_Data::unpack(octetStream& o)
   iphi.unpack(o);
   o.get(powers);
   o.get(powers_i);
+  bluestein.reset();
+  product.reset();
 }
 
 bool FFT_Data::operator!=(const FFT_Data& other) const
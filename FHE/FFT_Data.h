@@ -6,6 +6,9 @@
 #include "Math/gfpvar.h"
 #include "Math/fixint.h"
 #include "FHE/Ring.h"
+#include "FHE/NTT.h"
+
+#include <memory>
 
 /* Class for holding modular arithmetic data wrt the ring 
  *
@@ -35,13 +38,22 @@ class FFT_Data
   modp iphi;    // 1/phi_m mod pr
   vector< vector<modp> > powers,powers_i;
 
+  // exact convolutions with word-size primes, created on demand and
+  // accessed atomically
+  mutable shared_ptr<RNS_Data> bluestein, product;
+
   void compute_roots(int n);
 
+  const RNS_Data& get_bluestein() const;
+
   public:
   typedef gfp T;
   typedef bigint S;
   typedef fixint<gfpvar::N_LIMBS> poly_type;
 
+  // use RNS_Data instead of transforms modulo pr where possible
+  static bool use_rns;
+
   void init(const Ring& Rg,const Zp_Data& PrD);
 
   void init_field() const { gfp::init_field(prData.pr); }
@@ -71,6 +83,9 @@ class FFT_Data
 
   const Ring& get_R() const      { return R; }
 
+  // negacyclic of length phi_m if m is a power of two, linear otherwise
+  const RNS_Data& get_product() const;
+
   bool operator==(const FFT_Data& other) const { return not (*this != other); }
   bool operator!=(const FFT_Data& other) const;
 
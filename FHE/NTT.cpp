@@ -0,0 +1,394 @@
+/*
+ * NTT.cpp
+ *
+ */
+
+#include "FHE/NTT.h"
+#include "Processor/LocalWorkers.h"
+
+#include <math.h>
+
+#ifdef __AVX512IFMA__
+#include <immintrin.h>
+
+// eight values at once, same conventions as NTT_Data::mul_shoup()
+inline __m512i mul_shoup8(__m512i x, __m512i w, __m512i w_shoup, __m512i p)
+{
+    __m512i zero = _mm512_setzero_si512();
+    __m512i q = _mm512_madd52hi_epu64(zero, w_shoup, x);
+    __m512i res = _mm512_sub_epi64(_mm512_madd52lo_epu64(zero, w, x),
+            _mm512_madd52lo_epu64(zero, q, p));
+    return _mm512_and_si512(res, _mm512_set1_epi64((1ll << 52) - 1));
+}
+
+// subtract m if not below
+inline __m512i reduce_once(__m512i x, __m512i m)
+{
+    return _mm512_min_epu64(x, _mm512_sub_epi64(x, m));
+}
+#endif
+
+// Shoup multiplication for any 64-bit x, result in [0, 2p)
+inline uint64_t mul_shoup64(uint64_t x, uint64_t w, uint64_t w_shoup,
+        uint64_t p)
+{
+    uint64_t q = (__uint128_t(w_shoup) * x) >> 64;
+    return w * x - q * p;
+}
+
+inline int bit_reverse(int x, int n_bits)
+{
+    int res = 0;
+    for (int i = 0; i < n_bits; i++)
+        res |= ((x >> i) & 1) << (n_bits - 1 - i);
+    return res;
+}
+
+NTT_Data::NTT_Data(uint64_t p, int N) :
+        p(p), N(N)
+{
+    if (N & (N - 1))
+        throw runtime_error("NTT length has to be a power of two");
+    if ((p - 1) % (2 * N) != 0 or p >> MAX_PRIME_BITS)
+        throw runtime_error("unsuitable prime for NTT");
+
+    uint64_t inv = p;
+    for (int i = 0; i < 6; i++)
+        inv *= 2 - p * inv;
+    p_inv = -inv;
+    uint64_t r = (__uint128_t(1) << 64) % p;
+    r2 = __uint128_t(r) * r % p;
+
+    // element of order 2N
+    uint64_t psi = 0;
+    for (uint64_t g = 2; psi == 0; g++)
+    {
+        uint64_t candidate = power(g, (p - 1) / (2 * N));
+        if (power(candidate, N) == p - 1)
+            psi = candidate;
+    }
+    uint64_t psi_inv = power(psi, p - 2);
+
+    int n_bits = 0;
+    while ((1 << n_bits) < N)
+        n_bits++;
+    roots.resize(N);
+    roots_shoup.resize(N);
+    inv_roots.resize(N);
+    inv_roots_shoup.resize(N);
+    for (int i = 0; i < N; i++)
+    {
+        int e = bit_reverse(i, n_bits);
+        roots[i] = power(psi, e);
+        roots_shoup[i] = shoup(roots[i], p, SHOUP_BITS);
+        inv_roots[i] = power(psi_inv, e);
+        inv_roots_shoup[i] = shoup(inv_roots[i], p, SHOUP_BITS);
+    }
+    n_inv = power(N, p - 2);
+    n_inv_shoup = shoup(n_inv, p, SHOUP_BITS);
+
+    limbs.resize(MAX_MOD_SZ);
+    limbs_shoup.resize(MAX_MOD_SZ);
+    limbs[0] = 1;
+    for (int i = 0; i < MAX_MOD_SZ; i++)
+    {
+        if (i > 0)
+            limbs[i] = __uint128_t(limbs[i - 1]) * r % p;
+        limbs_shoup[i] = shoup(limbs[i], p, 64);
+    }
+}
+
+uint64_t NTT_Data::power(uint64_t x, uint64_t e) const
+{
+    uint64_t res = 1;
+    for (; e; e >>= 1)
+    {
+        if (e & 1)
+            res = __uint128_t(res) * x % p;
+        x = __uint128_t(x) * x % p;
+    }
+    return res;
+}
+
+uint64_t NTT_Data::redc(__uint128_t x) const
+{
+    uint64_t m = uint64_t(x) * p_inv;
+    uint64_t res = (x + __uint128_t(m) * p) >> 64;
+    return res >= p ? res - p : res;
+}
+
+uint64_t NTT_Data::reduce(const mp_limb_t* x, int n_limbs) const
+{
+    uint64_t two_p = 2 * p;
+    uint64_t res = 0;
+    for (int i = 0; i < n_limbs; i++)
+    {
+        res += mul_shoup64(x[i], limbs[i], limbs_shoup[i], p);
+        if (res >= two_p)
+            res -= two_p;
+    }
+    return res >= p ? res - p : res;
+}
+
+void NTT_Data::forward(uint64_t* x) const
+{
+    // Cooley-Tukey with inputs and outputs of every level in [0, 4p)
+    uint64_t two_p = 2 * p;
+    for (int m = 1, t = N / 2; m < N; m *= 2, t /= 2)
+        for (int i = 0; i < m; i++)
+        {
+            uint64_t w = roots[m + i], w_shoup = roots_shoup[m + i];
+            uint64_t* a = x + 2 * i * t;
+            uint64_t* b = a + t;
+            int j = 0;
+#ifdef __AVX512IFMA__
+            __m512i vp = _mm512_set1_epi64(p), v2p = _mm512_set1_epi64(two_p),
+                    vw = _mm512_set1_epi64(w), vws = _mm512_set1_epi64(w_shoup);
+            for (; j + 8 <= t; j += 8)
+            {
+                __m512i X = reduce_once(_mm512_loadu_si512(a + j), v2p);
+                __m512i T = mul_shoup8(_mm512_loadu_si512(b + j), vw, vws, vp);
+                _mm512_storeu_si512(a + j, _mm512_add_epi64(X, T));
+                _mm512_storeu_si512(b + j,
+                        _mm512_add_epi64(_mm512_sub_epi64(X, T), v2p));
+            }
+#endif
+            for (; j < t; j++)
+            {
+                uint64_t X = a[j];
+                if (X >= two_p)
+                    X -= two_p;
+                uint64_t T = mul_shoup(b[j], w, w_shoup);
+                a[j] = X + T;
+                b[j] = X - T + two_p;
+            }
+        }
+
+    for (int i = 0; i < N; i++)
+    {
+        if (x[i] >= two_p)
+            x[i] -= two_p;
+        if (x[i] >= p)
+            x[i] -= p;
+    }
+}
+
+void NTT_Data::backward(uint64_t* x) const
+{
+    // Gentleman-Sande with values in [0, 2p)
+    uint64_t two_p = 2 * p;
+    for (int m = N / 2, t = 1; m >= 1; m /= 2, t *= 2)
+        for (int i = 0; i < m; i++)
+        {
+            uint64_t w = inv_roots[m + i], w_shoup = inv_roots_shoup[m + i];
+            uint64_t* a = x + 2 * i * t;
+            uint64_t* b = a + t;
+            int j = 0;
+#ifdef __AVX512IFMA__
+            __m512i vp = _mm512_set1_epi64(p), v2p = _mm512_set1_epi64(two_p),
+                    vw = _mm512_set1_epi64(w), vws = _mm512_set1_epi64(w_shoup);
+            for (; j + 8 <= t; j += 8)
+            {
+                __m512i X = _mm512_loadu_si512(a + j);
+                __m512i Y = _mm512_loadu_si512(b + j);
+                _mm512_storeu_si512(a + j,
+                        reduce_once(_mm512_add_epi64(X, Y), v2p));
+                _mm512_storeu_si512(b + j,
+                        mul_shoup8(
+                                _mm512_add_epi64(_mm512_sub_epi64(X, Y), v2p),
+                                vw, vws, vp));
+            }
+#endif
+            for (; j < t; j++)
+            {
+                uint64_t X = a[j], Y = b[j];
+                uint64_t sum = X + Y;
+                a[j] = sum >= two_p ? sum - two_p : sum;
+                b[j] = mul_shoup(X - Y + two_p, w, w_shoup);
+            }
+        }
+
+    for (int i = 0; i < N; i++)
+    {
+        x[i] = mul_shoup(x[i], n_inv, n_inv_shoup);
+        if (x[i] >= p)
+            x[i] -= p;
+    }
+}
+
+void NTT_Data::mul(uint64_t* x, const uint64_t* y) const
+{
+    for (int i = 0; i < N; i++)
+        x[i] = redc(__uint128_t(x[i]) * y[i]);
+}
+
+void NTT_Data::to_montgomery(uint64_t* x) const
+{
+    for (int i = 0; i < N; i++)
+        x[i] = redc(__uint128_t(x[i]) * r2);
+}
+
+void to_limbs(vector<mp_limb_t>& res, const bigint& x, int n_limbs)
+{
+    res.resize(n_limbs);
+    for (int i = 0; i < n_limbs; i++)
+        res[i] = mpz_getlimbn(x.get_mpz_t(), i);
+}
+
+RNS_Data::RNS_Data(int N, int n_bits, const Zp_Data& ZpD,
+        const bigint& factor) :
+        N(N), n_limbs(ZpD.get_t())
+{
+    // leave room for rounding the CRT coefficient and the sign
+    bigint Q = 1;
+    uint64_t step = 2 * N;
+    uint64_t candidate = ((~0ull >> (64 - NTT_Data::MAX_PRIME_BITS)) / step)
+            * step + 1;
+    while (numBits(Q) <= n_bits + 12)
+    {
+        if (candidate <= step)
+            throw runtime_error("not enough primes for RNS");
+        if (probPrime(bigint(candidate)))
+        {
+            primes.push_back({candidate, N});
+            Q *= candidate;
+        }
+        candidate -= step;
+    }
+
+    const bigint& pr = ZpD.pr;
+    int k = primes.size();
+    crt.resize(k);
+    for (int j = 0; j < k; j++)
+    {
+        uint64_t p = primes[j].get_prime();
+        bigint tmp = Q / p, prime = p;
+        to_limbs(crt[j], tmp * factor % pr, n_limbs);
+        mpz_invert(tmp.get_mpz_t(), tmp.get_mpz_t(), prime.get_mpz_t());
+        q_inv.push_back(tmp.get_ui());
+        q_inv_shoup.push_back((__uint128_t(q_inv.back()) << 64) / p);
+        p_inv.push_back(1.0L / p);
+    }
+    bigint tmp = Q * factor % pr;
+    to_limbs(q_mod, tmp, n_limbs);
+    tmp = (pr - tmp * k % pr) % pr;
+    to_limbs(correction, tmp, n_limbs);
+    to_limbs(modulus, pr, n_limbs);
+}
+
+void RNS_Data::decompose(vector<uint64_t>& res, const vector<modp>& a) const
+{
+    assert(a.size() <= size_t(N));
+    res.clear();
+    res.resize(primes.size() * N);
+    LocalWorkers::run_local(a.size(), [&](int begin, int end)
+    {
+        for (int i = begin; i < end; i++)
+            for (size_t j = 0; j < primes.size(); j++)
+                res[j * N + i] = primes[j].reduce(a[i].get(), n_limbs);
+    });
+}
+
+void RNS_Data::recompose(vector<modp>& res, const vector<uint64_t>& x,
+        int begin, int n) const
+{
+    int k = primes.size();
+    res.resize(n);
+    LocalWorkers::run_local(n, [&](int start, int end)
+    {
+        // sum_j y_j * Q/p_j = v + alpha * Q with |v| small,
+        // so alpha is the rounded sum of y_j / p_j
+        vector<mp_limb_t> acc(n_limbs + 2), q(3);
+        for (int i = start; i < end; i++)
+        {
+            fill(acc.begin(), acc.end(), 0);
+            long double sum = 0;
+            for (int j = 0; j < k; j++)
+            {
+                uint64_t p = primes[j].get_prime();
+                uint64_t y = mul_shoup64(x[j * N + begin + i], q_inv[j],
+                        q_inv_shoup[j], p);
+                if (y >= p)
+                    y -= p;
+                sum += y * p_inv[j];
+                mp_limb_t carry = mpn_addmul_1(acc.data(), crt[j].data(),
+                        n_limbs, y);
+                mpn_add_1(acc.data() + n_limbs, acc.data() + n_limbs, 2,
+                        carry);
+            }
+            // add (k - alpha) * Q - k * Q to remain positive
+            mp_limb_t carry = mpn_addmul_1(acc.data(), q_mod.data(), n_limbs,
+                    k - llroundl(sum));
+            mpn_add_1(acc.data() + n_limbs, acc.data() + n_limbs, 2, carry);
+            mpn_add(acc.data(), acc.data(), n_limbs + 2, correction.data(),
+                    n_limbs);
+            mpn_tdiv_qr(q.data(), acc.data(), 0, acc.data(), n_limbs + 2,
+                    modulus.data(), n_limbs);
+            res[i].assign(acc.data(), n_limbs);
+        }
+    });
+}
+
+void RNS_Data::forward(vector<uint64_t>& x) const
+{
+    LocalWorkers::run_local(primes.size(), [&](int begin, int end)
+    {
+        for (int j = begin; j < end; j++)
+            primes[j].forward(&x[j * N]);
+    });
+}
+
+int RNS_Data::add_kernel(const vector<bigint>& kernel)
+{
+    assert(kernel.size() <= size_t(N));
+    vector<uint64_t> res(primes.size() * N);
+    for (size_t j = 0; j < primes.size(); j++)
+    {
+        uint64_t p = primes[j].get_prime();
+        for (size_t i = 0; i < kernel.size(); i++)
+            res[j * N + i] = mpz_fdiv_ui(kernel[i].get_mpz_t(), p);
+    }
+    forward(res);
+    for (size_t j = 0; j < primes.size(); j++)
+        primes[j].to_montgomery(&res[j * N]);
+    kernels.push_back(res);
+    return kernels.size() - 1;
+}
+
+void RNS_Data::convolve(vector<modp>& res, const vector<modp>& a, int kernel,
+        int begin, int n) const
+{
+    vector<uint64_t> x;
+    decompose(x, a);
+    auto& y = kernels.at(kernel);
+    LocalWorkers::run_local(primes.size(), [&](int start, int end)
+    {
+        for (int j = start; j < end; j++)
+        {
+            primes[j].forward(&x[j * N]);
+            primes[j].mul(&x[j * N], &y[j * N]);
+            primes[j].backward(&x[j * N]);
+        }
+    });
+    recompose(res, x, begin, n);
+}
+
+void RNS_Data::multiply(vector<modp>& res, const vector<modp>& a,
+        const vector<modp>& b) const
+{
+    vector<uint64_t> x, y;
+    decompose(x, a);
+    decompose(y, b);
+    LocalWorkers::run_local(primes.size(), [&](int start, int end)
+    {
+        for (int j = start; j < end; j++)
+        {
+            primes[j].forward(&x[j * N]);
+            primes[j].forward(&y[j * N]);
+            primes[j].to_montgomery(&y[j * N]);
+            primes[j].mul(&x[j * N], &y[j * N]);
+            primes[j].backward(&x[j * N]);
+        }
+    });
+    recompose(res, x, 0, N);
+}
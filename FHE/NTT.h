@@ -0,0 +1,134 @@
+/*
+ * NTT.h
+ *
+ */
+
+#ifndef FHE_NTT_H_
+#define FHE_NTT_H_
+
+#include "Math/modp.h"
+#include "Math/Zp_Data.h"
+
+#include <stdint.h>
+#include <assert.h>
+#include <vector>
+using namespace std;
+
+/**
+ * Negacyclic number-theoretic transform of length ``N`` modulo a prime
+ * ``p`` that fits in a machine word and satisfies ``p = 1 mod 2N``.
+ * The butterflies follow Harvey (J. Symb. Comput. 2014): twiddle factors
+ * come with precomputed Shoup quotients, and intermediate values are only
+ * reduced to ``[0, 4p)``. With AVX-512 IFMA, the primes are below 2^50 and
+ * the butterflies run on eight values at once, otherwise they use 62-bit
+ * primes and 64-bit multiplication.
+ */
+class NTT_Data
+{
+#ifdef __AVX512IFMA__
+    static const int SHOUP_BITS = 52;
+#else
+    static const int SHOUP_BITS = 64;
+#endif
+    static const uint64_t SHOUP_MASK = ~0ull >> (64 - SHOUP_BITS);
+
+    uint64_t p, p_inv, r2;
+    int N;
+
+    // powers of the 2N-th root and its inverse in bit-reversed order
+    vector<uint64_t> roots, roots_shoup, inv_roots, inv_roots_shoup;
+    uint64_t n_inv, n_inv_shoup;
+
+    // 2^(64i) mod p for reducing limbs
+    vector<uint64_t> limbs, limbs_shoup;
+
+    static uint64_t shoup(uint64_t w, uint64_t p, int bits)
+    {
+        return (__uint128_t(w) << bits) / p;
+    }
+
+    // result in [0, 2p), x has to be below 2^SHOUP_BITS
+    uint64_t mul_shoup(uint64_t x, uint64_t w, uint64_t w_shoup) const
+    {
+        uint64_t q = (__uint128_t(w_shoup) * x) >> SHOUP_BITS;
+        return (w * x - q * p) & SHOUP_MASK;
+    }
+
+    // Montgomery reduction with respect to 2^64, result in [0, p)
+    uint64_t redc(__uint128_t x) const;
+
+    uint64_t power(uint64_t x, uint64_t e) const;
+
+public:
+    static const int MAX_PRIME_BITS = SHOUP_BITS - 2;
+
+    NTT_Data(uint64_t p, int N);
+
+    uint64_t get_prime() const { return p; }
+
+    /// reduce raw limbs of a ``modp``
+    uint64_t reduce(const mp_limb_t* x, int n_limbs) const;
+
+    /// in place from natural to bit-reversed order, values in ``[0, p)``
+    void forward(uint64_t* x) const;
+    /// in place from bit-reversed to natural order, values in ``[0, p)``
+    void backward(uint64_t* x) const;
+
+    /// ``x[i] = x[i] * y[i] / 2^64``
+    void mul(uint64_t* x, const uint64_t* y) const;
+    /// ``x[i] = x[i] * 2^64``, which compensates ``mul()``
+    void to_montgomery(uint64_t* x) const;
+};
+
+/**
+ * Exact negacyclic convolution of ``modp`` vectors by means of several
+ * word-size primes (residue number system). The product of the primes
+ * exceeds the absolute value of the integer result, which is then
+ * reconstructed modulo the prime of the ``modp`` values by CRT.
+ * The transforms for the different primes run on the local threads
+ * (``--local-threads``).
+ */
+class RNS_Data
+{
+    int N, n_limbs;
+    vector<NTT_Data> primes;
+
+    // (Q/p_j)^-1 mod p_j with Shoup quotient
+    vector<uint64_t> q_inv, q_inv_shoup;
+    vector<long double> p_inv;
+    // Q/p_j * factor, Q * factor, and -k * Q * factor mod the output prime
+    vector<vector<mp_limb_t>> crt;
+    vector<mp_limb_t> q_mod, correction, modulus;
+
+    // transformed fixed operands
+    vector<vector<uint64_t>> kernels;
+
+    void decompose(vector<uint64_t>& res, const vector<modp>& a) const;
+    void recompose(vector<modp>& res, const vector<uint64_t>& x, int begin,
+            int n) const;
+
+    void forward(vector<uint64_t>& x) const;
+
+public:
+    /**
+     * Set up transforms of length ``N`` for results up to ``2^n_bits`` in
+     * absolute value modulo ``ZpD.pr``. The results are multiplied by
+     * ``factor``, which allows to compensate Montgomery representation.
+     */
+    RNS_Data(int N, int n_bits, const Zp_Data& ZpD, const bigint& factor = 1);
+
+    int size() const { return N; }
+    int num_primes() const { return primes.size(); }
+
+    /// store a fixed operand for ``convolve()``, returns its index
+    int add_kernel(const vector<bigint>& kernel);
+
+    /// ``res[i]`` is entry ``begin + i`` of the product with a fixed operand
+    void convolve(vector<modp>& res, const vector<modp>& a, int kernel,
+            int begin, int n) const;
+    /// negacyclic product of length ``N``
+    void multiply(vector<modp>& res, const vector<modp>& a,
+            const vector<modp>& b) const;
+};
+
+#endif /* FHE_NTT_H_ */
@@ -172,6 +172,17 @@ void mul(Ring_Element& ans,const Ring_Element& a,const Ring_Element& b)
       for (int i=0; i<(*ans.FFTD).phi_m(); i++)
         ans.element.push_back(a.element[i].mul(b.element[i], a.FFTD->get_prD()));
     }
+  else if (FFT_Data::use_rns)
+    { // Exact product over the integers with word-size primes,
+      // negacyclic if m is a power of two
+      vector<modp> aa;
+      a.FFTD->get_product().multiply(aa, a.element, b.element);
+      if ((*a.FFTD).get_twop()!=0)
+        reduce(aa, 2*(*a.FFTD).phi_m(), (*a.FFTD).phi_m(), *a.FFTD);
+      ans.partial_assign(a);
+      for (int i=0; i<(*ans.FFTD).phi_m(); i++)
+        { ans.element[i]=aa[i]; }
+    }
   else if ((*a.FFTD).get_twop()!=0)
     { // This is the case where m is not a power of two
 
@@ -202,6 +213,7 @@ void mul(Ring_Element& ans,const Ring_Element& a,const Ring_Element& b)
     { // m a power of two case
       ans.partial_assign(a);
       Ring_Element aa(*ans.FFTD,ans.rep);
+      aa.allocate();
       modp temp;
       for (int i=0; i<(*ans.FFTD).phi_m(); i++)
         { for (int j=0; j<(*ans.FFTD).phi_m(); j++)
@@ -5,6 +5,7 @@
 
 #include "EncCommit.h"
 #include "FHE/P2Data.h"
+#include "Processor/LocalWorkers.h"
 
 #include <math.h>
 
@@ -96,17 +97,20 @@ void covert_generation(Plaintext_<FD>& mess, vector<Ciphertext>& C,
   // Generate the messages and ciphertexts
   vector< Plaintext_<FD> > m(num_runs,mess.get_field());
   vector<Ciphertext>   c(num_runs,params);
-  Random_Coins rc(params);
-  for (int i=0; i<num_runs; i++)
-    { m[i].randomize(G[i],cond);
-      rc.generate(G[i]);
-      (*pks[P->my_num()]).encrypt(c[i],m[i],rc);
-      //cout << "xxxxxxxxxxxxxxxxxxxxx" << endl;
-      //cout << i << "\t" << (*P).socket(P.my_num()) << endl;
-      //cout << i << "\t" << m[i] << endl;
-      //cout << i << "\t" << rc << endl;
-      //cout << i << "\t" << c[i] << endl;
-    }
+  LocalWorkers::run_local(num_runs, [&](int begin, int end)
+  {
+    Random_Coins rc(params);
+    for (int i=begin; i<end; i++)
+      { m[i].randomize(G[i],cond);
+        rc.generate(G[i]);
+        (*pks[P->my_num()]).encrypt(c[i],m[i],rc);
+        //cout << "xxxxxxxxxxxxxxxxxxxxx" << endl;
+        //cout << i << "\t" << (*P).socket(P.my_num()) << endl;
+        //cout << i << "\t" << m[i] << endl;
+        //cout << i << "\t" << rc << endl;
+        //cout << i << "\t" << c[i] << endl;
+      }
+  });
 
   // Broadcast and receive ciphertexts
   vector< vector<octetStream> > ctx(num_runs, vector<octetStream> ((*P).num_players()));
@@ -127,33 +131,37 @@ void covert_generation(Plaintext_<FD>& mess, vector<Ciphertext>& C,
   // Open seeds, but not the challenge run
   Open(seeds,Comm_seeds,Open_seeds,*P,num_runs,challenge);
 
-  // Now check all the prior executions
-  Plaintext_<FD> mm(mess.get_field());
-  Ciphertext cc(params);
-  octetStream occ;
-  for (int i=0; i<num_runs; i++)
-    { if (i!=challenge)
-        { for (int j=0; j<(*P).num_players(); j++)
-            { if (j!=(*P).my_num())
-	        { PRNG G;
-                  G.SetSeed(seeds[i][j].get_data());
-	          //cout << "GOT SEED : " << i << " " << j << " " << P.socket(j) << seeds[i][j] << endl;
-                  mm.randomize(G,cond);
-                  rc.generate(G);
-                  (*pks[j]).encrypt(cc,mm,rc);
-                  occ.reset_write_head();
-                  cc.pack(occ);
-                  if (!occ.equals(ctx[i][j]))
-                    { //cout << "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz" << endl;
-                      //cout << i << " " << j << " " << P.socket(j) << " " << mm << endl;
-                      //cout << i << " " << j << " " << P.socket(j) << " " << rc << endl;
-                      //cout << i << " " << j << " " << P.socket(j) << " " << cc << endl;
-                      throw bad_enccommit(); 
-                    }
-		}
-	    }
-        }
-    }
+  // Now check all the prior executions, which are independent
+  LocalWorkers::run_local(num_runs, [&](int begin, int end)
+  {
+    Plaintext_<FD> mm(mess.get_field());
+    Ciphertext cc(params);
+    Random_Coins rc(params);
+    octetStream occ;
+    for (int i=begin; i<end; i++)
+      { if (i!=challenge)
+          { for (int j=0; j<(*P).num_players(); j++)
+              { if (j!=(*P).my_num())
+                  { PRNG G;
+                    G.SetSeed(seeds[i][j].get_data());
+                    //cout << "GOT SEED : " << i << " " << j << " " << P.socket(j) << seeds[i][j] << endl;
+                    mm.randomize(G,cond);
+                    rc.generate(G);
+                    (*pks[j]).encrypt(cc,mm,rc);
+                    occ.reset_write_head();
+                    cc.pack(occ);
+                    if (!occ.equals(ctx[i][j]))
+                      { //cout << "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz" << endl;
+                        //cout << i << " " << j << " " << P.socket(j) << " " << mm << endl;
+                        //cout << i << " " << j << " " << P.socket(j) << " " << rc << endl;
+                        //cout << i << " " << j << " " << P.socket(j) << " " << cc << endl;
+                        throw bad_enccommit();
+                      }
+                  }
+              }
+          }
+      }
+  });
 
   // Set output
   mess=m[challenge];
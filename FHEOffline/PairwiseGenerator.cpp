@@ -9,6 +9,7 @@
 #include "Protocols/SemiShare.h"
 #include "GC/SemiSecret.h"
 #include "GC/SemiPrep.h"
+#include "Processor/BaseMachine.h"
 
 #include "Protocols/MAC_Check.hpp"
 #include "Protocols/SemiInput.hpp"
@@ -22,11 +23,14 @@ PairwiseGenerator<FD>::PairwiseGenerator(int thread_num,
     GeneratorBase(thread_num, machine.N, player),
     producer(machine.setup<FD>().FieldD, P.my_num(),
             thread_num, machine.output, machine.get_prep_dir<FD>(P)),
-    EC(P, machine.other_pks, machine.setup<FD>().FieldD, timers, machine, *this),
+    EC(P, machine.other_pks, machine.setup<FD>().FieldD, timers, machine,
+            *this),
+    proof_EC(P, machine.other_pks, machine.setup<FD>().FieldD, proof_timers,
+            machine, *this),
     MC(machine.setup<FD>().alphai),
     n_ciphertexts(EC.proof.U),
     C(n_ciphertexts, machine.setup<FD>().params), volatile_memory(0),
-    machine(machine)
+    job(*this), pending(false), machine(machine)
 {
     for (int i = 1; i < P.num_players(); i++)
         multipliers.push_back(new Multiplier<FD>(i, *this));
@@ -34,7 +38,9 @@ PairwiseGenerator<FD>::PairwiseGenerator(int thread_num,
     a.resize(n_ciphertexts, FieldD);
     b.resize(n_ciphertexts, FieldD);
     c.resize(n_ciphertexts, FieldD);
+    a_next.resize(n_ciphertexts, FieldD);
     a.allocate_slots(FieldD.get_prime());
+    a_next.allocate_slots(FieldD.get_prime());
     b.allocate_slots(FieldD.get_prime());
     // extra limb for addition
     c.allocate_slots((bigint)FieldD.get_prime() << 64);
@@ -45,10 +51,36 @@ PairwiseGenerator<FD>::PairwiseGenerator(int thread_num,
 template <class FD>
 PairwiseGenerator<FD>::~PairwiseGenerator()
 {
+    // an unused proof cannot fail the computation
+    if (pending)
+        prover.done();
     for (auto m : multipliers)
         delete m;
 }
 
+template <class FD>
+int PairwiseGenerator<FD>::ProofJob::run()
+{
+    // keep away from the queues of thread 0
+    BaseMachine::thread_num = -1;
+    error = nullptr;
+    try
+    {
+        auto& timers = generator.proof_timers;
+        timers["Randomization"].start();
+        generator.a_next.randomize(G);
+        timers["Randomization"].stop();
+        memory = generator.proof_EC.generate_proof(generator.C,
+                generator.a_next, generator.next_ciphertexts,
+                generator.next_cleartexts);
+    }
+    catch (...)
+    {
+        error = current_exception();
+    }
+    return 0;
+}
+
 template <class FD>
 void PairwiseGenerator<FD>::run()
 {
@@ -57,13 +89,39 @@ void PairwiseGenerator<FD>::run()
     total = 0;
     producer.triples.clear();
 
+    // The proof only depends on local data, so the one for the next round
+    // runs in the background while exchanging and checking the current one
+    // and producing triples. It uses its own proof object and buffers.
+    // A proof still running at the end is used by the next call.
+    long long last_round = 0;
+
     while (total < machine.nTriplesPerThread)
     {
+        if (not pending)
+            prover.request(job);
+        prover.done();
+        pending = false;
+        for (auto& timer : proof_timers)
+            timers[timer.first] += timer.second;
+        proof_timers.clear();
+        if (job.error)
+            rethrow_exception(job.error);
+        a.swap(a_next);
+        swap(ciphertexts, next_ciphertexts);
+        swap(cleartexts, next_cleartexts);
+        size_t prover_memory = job.memory;
+
+        // Skip the next proof if the previous round indicates that this one
+        // reaches the target. Without a previous round, the proof is kept
+        // for the next call if not needed here.
+        pending = last_round == 0
+                or total + last_round < machine.nTriplesPerThread;
+        if (pending)
+            prover.request(job);
+
         timers["Randomization"].start();
-        a.randomize(G);
         b.randomize(G);
         timers["Randomization"].stop();
-        size_t prover_memory = EC.generate_proof(C, a, ciphertexts, cleartexts);
         timers["Plaintext multiplication"].start();
         c.mul(a, b);
         timers["Plaintext multiplication"].stop();
@@ -74,7 +132,9 @@ void PairwiseGenerator<FD>::run()
         timers["Proof exchange"].start();
         size_t verifier_memory = EC.create_more(ciphertexts, cleartexts);
         timers["Proof exchange"].stop();
-        volatile_memory = max(prover_memory, verifier_memory);
+        volatile_memory = prover_memory + verifier_memory;
+
+        long long before = total;
 
         Rq_Element values({machine.setup<FD>().params, evaluation, evaluation});
         for (int k = 0; k < n_ciphertexts; k++)
@@ -108,12 +168,12 @@ void PairwiseGenerator<FD>::run()
         timers["Checking"].start();
         MC.Check(P);
         timers["Checking"].stop();
+        last_round = total - before;
     }
 
 #ifdef FHE_MEMORY
     cerr << "Could save " << 1e-9 * a.report_size(CAPACITY) << " GB" << endl;
 #endif
-    timers.insert(EC.timers.begin(), EC.timers.end());
     timers.insert(producer.timers.begin(), producer.timers.end());
     timers["Networking"] = P.timer;
 }
@@ -160,14 +220,18 @@ void PairwiseGenerator<FD>::generate_inputs(int player)
 template <class FD>
 size_t PairwiseGenerator<FD>::report_size(ReportType type)
 {
-    size_t res = a.report_size(type) + b.report_size(type) + c.report_size(type);
+    size_t res = a.report_size(type) + b.report_size(type) + c.report_size(type)
+            + a_next.report_size(type);
     for (auto m : multipliers)
         res += m->report_size(type);
     res += producer.report_size(type);
     res += multipliers[0]->report_volatile();
     res += volatile_memory + C.report_size(type);
     res += ciphertexts.get_max_length() + cleartexts.get_max_length();
+    res += next_ciphertexts.get_max_length()
+            + next_cleartexts.get_max_length();
     res += EC.report_size(type) + EC.volatile_memory;
+    res += proof_EC.report_size(type) + proof_EC.volatile_memory;
     res += b_mod_q.report_size(type);
     return res;
 }
@@ -183,7 +247,8 @@ void PairwiseGenerator<FD>::report_size(ReportType type, MemoryUsage& res)
 {
     multipliers[0]->report_size(type, res);
     res.add("shares",
-            a.report_size(type) + b.report_size(type) + c.report_size(type));
+            a.report_size(type) + b.report_size(type) + c.report_size(type)
+                    + a_next.report_size(type));
     res.add("producer", producer.report_size(type));
     res.add("my ciphertexts", C.report_size(CAPACITY));
     res.add("serialized ciphertexts", ciphertexts.get_max_length());
@@ -191,6 +256,7 @@ void PairwiseGenerator<FD>::report_size(ReportType type, MemoryUsage& res)
     res.add("generator volatile", volatile_memory);
     res.add("b mod p", b_mod_q.report_size(type));
     res += EC.memory_usage;
+    res += proof_EC.memory_usage;
 }
 
 template class PairwiseGenerator<FFT_Data>;
@@ -7,10 +7,12 @@
 #define FHEOFFLINE_PAIRWISEGENERATOR_H_
 
 #include <vector>
+#include <exception>
 using namespace std;
 
 #include "FHEOffline/Multiplier.h"
 #include "FHEOffline/SimpleGenerator.h"
+#include "Tools/Worker.h"
 
 class PairwiseMachine;
 
@@ -22,21 +24,47 @@ class PairwiseGenerator : public GeneratorBase
     friend MultiEncCommit<FD>;
     template<class U> friend class CowGearPrep;
 
-    PlaintextVector<FD> a, b, c;
+    // proof of the next round while producing triples
+    class ProofJob
+    {
+    public:
+        PairwiseGenerator& generator;
+        SeededPRNG G;
+        size_t memory;
+        exception_ptr error;
+
+        ProofJob(PairwiseGenerator& generator) :
+                generator(generator), memory(0)
+        {
+        }
+
+        int run();
+    };
+
+    PlaintextVector<FD> a, b, c, a_next;
     AddableVector<Rq_Element> b_mod_q;
     vector<Multiplier<FD>*> multipliers;
     TripleProducer_<FD> producer;
     MultiEncCommit<FD> EC;
+    // separate proof state and timers for the background thread
+    TimerMap proof_timers;
+    MultiEncCommit<FD> proof_EC;
     MAC_Check<T> MC;
 
     int n_ciphertexts;
 
     // temporary data
     AddableVector<Ciphertext> C;
-    octetStream ciphertexts, cleartexts;
+    octetStream ciphertexts, cleartexts, next_ciphertexts, next_cleartexts;
 
     size_t volatile_memory;
 
+    // the proof for the next round may outlive run() so that the
+    // following call uses it
+    ProofJob job;
+    Worker<ProofJob> prover;
+    bool pending;
+
 public:
     PairwiseMachine& machine;
 
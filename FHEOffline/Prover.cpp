@@ -7,6 +7,7 @@
 #include "Math/Z2k.hpp"
 #include "Math/modp.hpp"
 #include "FHE/AddableVector.hpp"
+#include "Processor/LocalWorkers.h"
 
 
 template <class FD, class U>
@@ -16,8 +17,14 @@ Prover<FD,U>::Prover(Proof& proof, const FD& FieldD) :
   s.resize(proof.V, proof.pk->get_params());
   y.resize(proof.V, FieldD);
 #ifdef LESS_ALLOC_MORE_MEM
-  t = s[0];
-  z = y[0];
+  int n_threads = LocalWorkers::local_size();
+  z.resize(n_threads);
+  t.resize(n_threads);
+  for (int i = 0; i < n_threads; i++)
+    {
+      t[i] = s[0];
+      z[i] = y[0];
+    }
   // extra limb to prevent reallocation
   t.allocate_slots(bigint(1) << (proof.B_rand_length + 64));
   z.allocate_slots(bigint(1) << (proof.B_plain_length + 64));
@@ -42,24 +49,38 @@ void Prover<FD,U>::Stage_1(const Proof& P, octetStream& ciphertexts,
 //  ZZX rd;
 //  ZZ pr=(*AE.A).prime();
 //  ZZ bd=B_plain/(pr+1);
-  PRNG G;
-  G.ReSeed();
-  Random_Coins rc(pk.get_params());
-  Ciphertext ciphertext(pk.get_params());
   ciphertexts.store(V);
-  for (int i=0; i<V; i++)
+  // chunks of one commitment per thread, serialized in order
+  int n_threads = LocalWorkers::local_size();
+  vector<octetStream> parts(n_threads);
+  for (int start=0; start<V; start+=n_threads)
     {
-//      AE.randomize(Diag,binary);
-//      rd=RandPoly(phim,bd<<1);
-//      y[i]=AE.plaintext()+pr*rd;
-      y[i].randomize(G, P.B_plain_length, P.get_diagonal());
-      if (P.get_diagonal())
-        assert(y[i].is_diagonal());
-      s[i].resize(3, P.phim);
-      s[i].generateUniform(G, P.B_rand_length);
-      rc.assign(s[i][0], s[i][1], s[i][2]);
-      pk.encrypt(ciphertext,y[i],rc);
-      ciphertext.pack(ciphertexts);
+      int n = min(n_threads, V - start);
+      LocalWorkers::run_local(n, [&](int begin, int end)
+      {
+        PRNG G;
+        G.ReSeed();
+        Random_Coins rc(pk.get_params());
+        Ciphertext ciphertext(pk.get_params());
+        for (int k=begin; k<end; k++)
+          {
+            int i = start + k;
+//            AE.randomize(Diag,binary);
+//            rd=RandPoly(phim,bd<<1);
+//            y[i]=AE.plaintext()+pr*rd;
+            y[i].randomize(G, P.B_plain_length, P.get_diagonal());
+            if (P.get_diagonal())
+              assert(y[i].is_diagonal());
+            s[i].resize(3, P.phim);
+            s[i].generateUniform(G, P.B_rand_length);
+            rc.assign(s[i][0], s[i][1], s[i][2]);
+            pk.encrypt(ciphertext,y[i],rc);
+            parts[k].reset_write_head();
+            ciphertext.pack(parts[k]);
+          }
+      });
+      for (int k=0; k<n; k++)
+        ciphertexts.concat(parts[k]);
     }
 }
 
@@ -75,30 +96,62 @@ bool Prover<FD,U>::Stage_2(Proof& P, octetStream& cleartexts,
   cleartexts.resize_precise(allocate);
   cleartexts.reset_write_head();
 
-  unsigned int i;
-#ifndef LESS_ALLOC_MORE_MEM
-  AddableVector<fixint<gfp::N_LIMBS>> z;
-  AddableMatrix<fixint<gfp::N_LIMBS>> t;
-#endif
   cleartexts.reset_write_head();
   cleartexts.store(P.V);
   if (P.get_diagonal())
     for (auto& xx : x)
       assert(xx.is_diagonal());
-  for (i=0; i<P.V; i++)
-    { z=y[i];
-      t=s[i];
-      P.apply_challenge(i, z, x, pk);
-      Check_Decoding(z, P.get_diagonal(), x[0].get_field());
-      P.apply_challenge(i, t, r, pk);
-      if (not P.check_bounds(z, t, i))
-          return false;
-      z.pack(cleartexts);
-      t.pack(cleartexts);
-   }
+  // responses in chunks as in Stage_1
+  int n_threads = LocalWorkers::local_size();
+  vector<octetStream> parts(n_threads);
+  vector<size_t> memory(n_threads);
+  vector<char> in_bounds(n_threads);
+#ifdef LESS_ALLOC_MORE_MEM
+  z.resize(n_threads);
+  t.resize(n_threads);
+#endif
+  volatile_memory = 0;
+  for (int start=0; start<int(P.V); start+=n_threads)
+    {
+      int n = min(n_threads, int(P.V) - start);
+      memory.assign(n_threads, 0);
+      LocalWorkers::run_local(n, [&](int begin, int end)
+      {
+#ifdef LESS_ALLOC_MORE_MEM
+        auto& z = this->z[begin];
+        auto& t = this->t[begin];
+#else
+        AddableVector<Proof::bound_type> z;
+        AddableMatrix<Int_Random_Coins::value_type::value_type> t;
+#endif
+        for (int k=begin; k<end; k++)
+          { int i = start + k;
+            z=y[i];
+            t=s[i];
+            P.apply_challenge(i, z, x, pk);
+            Check_Decoding(z, P.get_diagonal(), x[0].get_field());
+            P.apply_challenge(i, t, r, pk);
+            in_bounds[k] = P.check_bounds(z, t, i);
+            if (not in_bounds[k])
+              return;
+            parts[k].reset_write_head();
+            z.pack(parts[k]);
+            t.pack(parts[k]);
+          }
 #ifndef LESS_ALLOC_MORE_MEM
-  volatile_memory = t.report_size(CAPACITY) + z.report_size(CAPACITY);
+        memory[begin] = t.report_size(CAPACITY) + z.report_size(CAPACITY);
 #endif
+      });
+      size_t chunk_memory = 0;
+      for (int k=0; k<n; k++)
+        {
+          if (not in_bounds[k])
+            return false;
+          cleartexts.concat(parts[k]);
+          chunk_memory += memory[k];
+        }
+      volatile_memory = max(volatile_memory, chunk_memory);
+    }
 #ifdef PRINT_MIN_DIST
   cout << "Minimal distance (log) " << log2(P.dist) << ", compare to " <<
       log2(P.plain_check.get_d() / pow(2, P.B_plain_length))  << endl;
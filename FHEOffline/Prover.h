@@ -14,8 +14,9 @@ class Prover
   AddableVector< Plaintext_<FD> > y;
 
 #ifdef LESS_ALLOC_MORE_MEM
-  AddableVector<typename Proof::bound_type> z;
-  AddableMatrix<Int_Random_Coins::value_type::value_type> t;
+  // responses to one commitment per thread
+  AddableVector<AddableVector<typename Proof::bound_type>> z;
+  AddableVector<AddableMatrix<Int_Random_Coins::value_type::value_type>> t;
 #endif
 
 public:
@@ -9,6 +9,7 @@
 #include "FHEOffline/PairwiseGenerator.h"
 #include "Tools/Subroutines.h"
 #include "Protocols/MAC_Check.h"
+#include "Processor/LocalWorkers.h"
 
 #include "Protocols/MAC_Check.hpp"
 #include "Math/modp.hpp"
@@ -113,17 +114,25 @@ void SimpleEncCommitBase<T, FD, S>::generate_ciphertexts(
     PRNG G;
     G.ReSeed();
     prepare_plaintext(G);
-    Random_Coins rc(pk.get_params());
     c.resize(proof.U, pk);
     r.resize(proof.U, pk);
-    for (unsigned i = 0; i < proof.U; i++)
+    size_t coins_size = 0;
+    LocalWorkers::run_local(proof.U, [&](int begin, int end)
     {
-        r[i].sample(G);
-        rc.assign(r[i]);
-        pk.encrypt(c[i], m.at(i), rc);
-    }
+        PRNG G;
+        G.ReSeed();
+        Random_Coins rc(pk.get_params());
+        for (int i = begin; i < end; i++)
+        {
+            r[i].sample(G);
+            rc.assign(r[i]);
+            pk.encrypt(c[i], m.at(i), rc);
+        }
+        if (begin == 0)
+            coins_size = rc.report_size(CAPACITY);
+    });
     timers["Generating"].stop();
-    memory_usage.update("random coins", rc.report_size(CAPACITY));
+    memory_usage.update("random coins", coins_size);
 }
 
 template <class FD>
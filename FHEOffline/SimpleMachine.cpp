@@ -12,6 +12,7 @@
 #include "Tools/ezOptionParser.h"
 #include "Protocols/MAC_Check.h"
 #include "Protocols/fake-stuff.h"
+#include "Processor/OnlineOptions.h"
 
 #include "Protocols/fake-stuff.hpp"
 #include "Protocols/mac_key.hpp"
@@ -87,6 +88,15 @@ void MachineBase::parse_options(int argc, const char** argv)
           "-2", // Flag token.
           "--gf2n" // Flag token.
     );
+    opt.add(
+          "1", // Default.
+          0, // Required?
+          1, // Number of args expected.
+          0, // Delimiter if expecting multiple args.
+          "Threads per generator thread for proofs and encryption (default: 1)", // Help description.
+          "-lt", // Flag token.
+          "--local-threads" // Flag token.
+    );
 
     OfflineMachineBase::parse_options(argc, argv);
     opt.get("-h")->getString(hostname);
@@ -94,6 +104,7 @@ void MachineBase::parse_options(int argc, const char** argv)
     opt.get("-s")->getInt(sec);
     opt.get("-f")->getInt(field_size);
     use_gf2n = opt.isSet("-2");
+    opt.get("-lt")->getInt(OnlineOptions::singleton.local_threads);
     if (use_gf2n)
     {
         cout << "Using GF(2^40)" << endl;
@@ -2,15 +2,19 @@
 #include "FHE/P2Data.h"
 #include "Math/Z2k.hpp"
 #include "Math/modp.hpp"
+#include "Processor/LocalWorkers.h"
 
 template <class FD>
 Verifier<FD>::Verifier(Proof& proof, const FD& FieldD) :
     P(proof), FieldD(FieldD)
 {
 #ifdef LESS_ALLOC_MORE_MEM
-  z.resize(proof.phim);
+  int n_threads = LocalWorkers::local_size();
+  z.resize(n_threads, AddableVector<typename Proof::bound_type>(proof.phim));
   z.allocate_slots(bigint(1) << proof.B_plain_length);
-  t.resize(3, proof.phim);
+  t.resize(n_threads);
+  for (auto& tt : t)
+    tt.resize(3, proof.phim);
   t.allocate_slots(bigint(1) << proof.B_rand_length);
 #endif
 }
@@ -67,45 +71,64 @@ void Verifier<FD>::Stage_2(
                           octetStream& cleartexts,
                           const FHE_PK& pk)
 {
-  unsigned int i, V;
+  unsigned int V;
 
   c.unpack(ciphertexts, pk);
   if (c.size() != P.U)
     throw length_error("number of received ciphertexts incorrect");
 
   // Now check the encryptions are correct
-  Ciphertext d1(pk.get_params()), d2(pk.get_params());
-  Random_Coins rc(pk.get_params());
   ciphertexts.get(V);
   if (V != P.V)
     throw length_error("number of received commitments incorrect");
   cleartexts.get(V);
   if (V != P.V)
     throw length_error("number of received cleartexts incorrect");
-  for (i=0; i<V; i++)
+  // the commitments are independent, so check one per thread at a time
+  int n_threads = LocalWorkers::local_size();
+  z.resize(n_threads);
+  t.resize(n_threads);
+  vector<Ciphertext> d1(n_threads, pk.get_params());
+  for (int start=0; start<int(V); start+=n_threads)
     {
-      z.unpack(cleartexts);
-      t.unpack(cleartexts);
-      if (!P.check_bounds(z, t, i))
-        throw runtime_error("preimage out of bounds");
-      d1.unpack(ciphertexts);
-      P.apply_challenge(i, d1, c, pk);
-      rc.assign(t[0], t[1], t[2]);
-      pk.encrypt(d2,z,rc);
-      if (!(d1 == d2))
+      int n = min(n_threads, int(V) - start);
+      for (int k=0; k<n; k++)
         {
+          z[k].unpack(cleartexts);
+          t[k].unpack(cleartexts);
+          d1[k].unpack(ciphertexts);
+        }
+
+      LocalWorkers::run_local(n, [&](int begin, int end)
+      {
+        Ciphertext d2(pk.get_params());
+        Random_Coins rc(pk.get_params());
+        for (int k=begin; k<end; k++)
+          {
+            int i = start + k;
+            auto& z = this->z[k];
+            auto& t = this->t[k];
+            if (!P.check_bounds(z, t, i))
+              throw runtime_error("preimage out of bounds");
+            P.apply_challenge(i, d1[k], c, pk);
+            rc.assign(t[0], t[1], t[2]);
+            pk.encrypt(d2,z,rc);
+            if (!(d1[k] == d2))
+              {
 #ifdef VERBOSE
-          cout << "Fail Check 6 " << i << endl;
+                cout << "Fail Check 6 " << i << endl;
 #endif
-          throw runtime_error("ciphertexts don't match");
-        }
-      if (!Check_Decoding(z,P.get_diagonal(),FieldD))
-         {
+                throw runtime_error("ciphertexts don't match");
+              }
+            if (!Check_Decoding(z,P.get_diagonal(),FieldD))
+              {
 #ifdef VERBOSE
-          cout << "\tCheck : " << i << endl;
+                cout << "\tCheck : " << i << endl;
 #endif
-           throw runtime_error("cleartext isn't diagonal");
-         }
+                throw runtime_error("cleartext isn't diagonal");
+              }
+          }
+      });
     }
 }
 
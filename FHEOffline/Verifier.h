@@ -10,8 +10,9 @@ bool Check_Decoding(const vector<Proof::bound_type>& AE, bool Diag, FD& FieldD);
 template <class FD>
 class Verifier
 {
-  AddableVector<typename Proof::bound_type> z;
-  AddableMatrix<Int_Random_Coins::value_type::value_type> t;
+  // responses to one commitment per thread
+  AddableVector<AddableVector<typename Proof::bound_type>> z;
+  AddableVector<AddableMatrix<Int_Random_Coins::value_type::value_type>> t;
 
   Proof& P;
   const FD& FieldD;
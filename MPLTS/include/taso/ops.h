@@ -46,6 +46,7 @@ using DNNLNet = std::vector<std::pair<dnnl::primitive, std::unordered_map<int, d
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <semaphore.h>
 using namespace std;
 
@@ -63,6 +64,7 @@ typedef float DATATYPE;
 
 class Model;
 class OpBase;
+class GraphXfer;
 
 enum {
   GUID_INVALID = 0,
@@ -486,6 +488,100 @@ public:
 #endif
 };
 
+//This must be consistent with python/taso/_cython/CCore.pxd
+enum MPCProtocol {
+  MPC_NONE,
+  MPC_REP3,    // replicated secret sharing (ABY3)
+  MPC_SEMI2K,  // two-party additive sharing with OT-based triples
+  MPC_SPDZ2K,  // two-party additive sharing with MACs
+};
+
+// Communication of a secure computation step, in bits summed over all
+// parties and in sequential rounds, split into online and offline phase.
+// This follows the (bits, rounds, offline bits, offline rounds) tuples of
+// Compiler/cost_config.py.
+struct MPCCost {
+  MPCCost(void)
+  : bits(0), rounds(0), offlineBits(0), offlineRounds(0) {}
+  MPCCost(double _bits, double _rounds,
+          double _offlineBits = 0, double _offlineRounds = 0)
+  : bits(_bits), rounds(_rounds),
+    offlineBits(_offlineBits), offlineRounds(_offlineRounds) {}
+  // sequential composition
+  MPCCost operator+(const MPCCost& b) const {
+    return MPCCost(bits + b.bits, rounds + b.rounds,
+                   offlineBits + b.offlineBits,
+                   offlineRounds + b.offlineRounds);
+  }
+  // n independent instances in parallel
+  MPCCost operator*(double n) const {
+    if (n <= 0) return MPCCost();
+    return MPCCost(bits * n, rounds, offlineBits * n, offlineRounds);
+  }
+  double bits, rounds, offlineBits, offlineRounds;
+};
+
+// Analytic cost of operators under MPC instead of measured plaintext
+// kernel time: communication per operator for the selected protocol,
+// converted to time with a bandwidth/latency network model, plus the
+// plaintext runtime scaled by the number of share components.
+class MPCCostModel {
+public:
+  MPCCostModel(MPCProtocol _protocol, int _bitLength, int _precision,
+               double _bandwidth, double _latency, bool _offline = true);
+  MPCCost op_cost(const OpBase* op) const;
+  // milliseconds
+  float runtime(const OpBase* op) const;
+  float runtime(const MPCCost& cost) const;
+  // protocol primitives, per instance
+  MPCCost muls(void) const;
+  MPCCost matmuls(double p, double q, double r) const;
+  MPCCost trunc(void) const;
+  MPCCost ltz(void) const;
+private:
+  MPCCost activation(ActiMode mode, double n) const;
+  MPCCost tree_max(double n, double k) const;
+  MPCCost nonlinear(double n) const;
+public:
+  MPCProtocol protocol;
+  int bitLength, precision, security;
+  double bandwidth; // bits per second
+  double latency;   // seconds per round
+  bool offline;
+  // local work relative to the plaintext kernel
+  float cpuFactor;
+};
+
+// Measured kernel runtimes persisted across runs, keyed by backend,
+// operator type and the operator key (shapes and parameters). The file
+// is loaded once and new measurements are appended to it.
+class CostDatabase {
+public:
+  CostDatabase(void);
+  ~CostDatabase(void);
+  void open(const std::string& file_name);
+  // set op->runtime from a previous measurement
+  template<typename K>
+  bool lookup(OpBase* op, const K& key) {
+    return lookup(op, key.keys, K::KEY_LENGTH);
+  }
+  template<typename K>
+  void store(const OpBase* op, const K& key) {
+    store(op, key.keys, K::KEY_LENGTH);
+  }
+private:
+  struct Entry {
+    float runtime;
+    // backend-specific choice made while measuring (e.g., cuDNN algorithm)
+    int algo;
+  };
+  std::string entry_key(OpType type, const int* keys, int length) const;
+  bool lookup(OpBase* op, const int* keys, int length);
+  void store(const OpBase* op, const int* keys, int length);
+  std::map<std::string, Entry> costs;
+  std::ofstream file;
+};
+
 class Graph {
 public:
   Graph();
@@ -642,6 +738,7 @@ public:
   // Helper Functions for Cython
   Op find_op_or_fail(size_t guid);
   Graph* optimize(float alpha, int budget, bool print_subst);
+  static void create_xfers(Model* model, std::vector<GraphXfer*>& xfers);
   Graph* preprocess_weights(void);
   int get_operator_list(Op* opList, size_t maxNumOps);
   int get_input_edges(Edge* opList, size_t guid);
@@ -682,6 +779,8 @@ public:
   std::vector<GraphSubst> subst_history;
   // MPC INTERFACES
   float mpcCost;
+  void set_mpc_cost_model(MPCProtocol protocol, int bitLength, int precision,
+                          float bandwidth, float latency);
   // static sem_t COST_READY, GRAPH_READY;
   // Graph* graph_to_eval;
   // float cost_to_load;
@@ -1458,9 +1557,19 @@ public:
   bool copy_memory(DATATYPE* dst, const DATATYPE* src, size_t size);
   float measure_oplist_runtime(const std::vector<OpBase*>& list);
   bool broadcastable(const Tensor& t1, const Tensor& t2);
+  // measured runtime or analytic MPC cost in milliseconds
+  float op_cost(const OpBase* op);
 public:
+  // NULL for plaintext kernel timings
+  MPCCostModel* mpcCostModel = NULL;
+  // empty unless TASO_COST_DB is set
+  CostDatabase costDatabase;
+  // guards the operator caches and measurement buffers
+  std::mutex mutex;
   bool isTraining;
   bool print_cost;
+  // set while Graph::optimize runs its search threads
+  bool searching = false;
   size_t global_unique_id;
   size_t workSpaceSize;
   void* workSpace;
@@ -140,6 +140,9 @@ public:
 class GraphXfer {
 public:
   GraphXfer(Model* _model);
+  // copy without matching state, for use in another thread
+  GraphXfer(const GraphXfer& xfer);
+  ~GraphXfer();
   static void load_graph_xfer_from_pb_file(Model* model,
                                            std::vector<GraphXfer*>& xfers,
                                            std::string filename);
@@ -196,8 +199,10 @@ public:
   bool map_output(TensorX src, TensorX dst);
   void run(int depth, Graph* graph,
            std::priority_queue<Graph*, std::vector<Graph*>, GraphCompare>&,
-           std::set<size_t>&, float threshold, int maxNumOps);
+           std::set<size_t>&, float threshold, int maxNumOps,
+           bool incremental = false);
   Graph* create_new_graph(Graph* graph);
+  float incremental_cost(Graph* graph, Graph* newGraph);
   bool create_new_operator(const OpX* opx, Op& op);
 
   // built-in substitutions
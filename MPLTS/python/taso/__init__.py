@@ -1041,7 +1041,12 @@ def MPCprofiling(subGraphs, in_size, norm_rate=1):
     # print(comm_list)
     return cost_list
 
-def optimize(graph, input_size, alpha = 1.0, budget = 1000, inMPL = False, print_subst = False):
+def optimize(graph, input_size, alpha = 1.0, budget = 1000, inMPL = False, print_subst = False,
+             mpc_protocol = None, bit_length = 64, precision = 16):
+    # analytic MPC cost (rep3, semi2k or spdz2k) instead of compiling every candidate
+    if mpc_protocol is not None:
+        graph.set_mpc_cost_model(mpc_protocol, bit_length, precision, bandwidth, ping_time)
+        return graph.optimize(alpha, budget, print_subst)
     if not inMPL:
         return graph.optimize(alpha, budget, print_subst)
 
@@ -124,6 +124,13 @@ cdef extern from "taso/ops.h" namespace "taso":
         AC_MODE_RELU
         AC_MODE_TANH
 
+    # This must be consistent with include/taso/ops.h
+    cdef enum MPCProtocol:
+        MPC_NONE
+        MPC_REP3
+        MPC_SEMI2K
+        MPC_SPDZ2K
+
     # This must be consistent with include/taso/ops.h
     cdef enum PaddingMode:
         PD_MODE_SAME
@@ -275,6 +282,8 @@ cdef extern from "taso/ops.h" namespace "taso":
         float run()
         bool optimize_next_step(float alpha, int budget)
         void optimize_on_step(float alpha, int budget)
+        void set_mpc_cost_model(MPCProtocol protocol, int bitLength, int precision,
+                                float bandwidth, float latency)
         vector[Graph*] transGraphs
         float totalCost
         Graph* preprocess_weights()
@@ -33,6 +33,18 @@ def get_padding_mode(padding):
     else:
         assert(False)
 
+def get_mpc_protocol(protocol):
+    if protocol is None:
+        return MPC_NONE
+    elif protocol in ("rep3", "aby3"):
+        return MPC_REP3
+    elif protocol == "semi2k":
+        return MPC_SEMI2K
+    elif protocol == "spdz2k":
+        return MPC_SPDZ2K
+    else:
+        assert(False)
+
 def get_data_type(datatype):
     if datatype == "FLOAT":
         return DT_FLOAT
@@ -568,6 +580,12 @@ cdef class PyGraph:
     def optimize_on_step(self, float alpha, int budget):
         self.p_graph.optimize_on_step(alpha, budget);
 
+    def set_mpc_cost_model(self, protocol, int bit_length, int precision,
+                           float bandwidth, float latency):
+        self.p_graph.set_mpc_cost_model(get_mpc_protocol(protocol),
+                                        bit_length, precision,
+                                        bandwidth, latency)
+
     def optimize(self, float alpha, int budget, bool print_subst):
         cdef Graph* new_graph = self.p_graph.optimize(alpha, budget, print_subst)
         graph = ctypes.cast(<unsigned long long>new_graph, ctypes.c_void_p)
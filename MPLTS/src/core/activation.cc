@@ -65,7 +65,10 @@ Op Model::get_or_create_activation(Tensor _input, OpType _type, bool _inPlace)
     actOp = activation[key];
   } else {
     actOp = new Activation(this, _input, _type, _inPlace);
-    measure_activation_cost(actOp);
+    if (!costDatabase.lookup(actOp, key)) {
+      measure_activation_cost(actOp);
+      costDatabase.store(actOp, key);
+    }
     activation[key] = actOp;
   }
   Op ret;
@@ -49,7 +49,10 @@ Op Model::get_or_create_batchnorm(const Tensor& _input,
     bnOp = batchnorm[key];
   } else {
     bnOp = new BatchNorm(this, _input, _scale, _bias, _mean, _var, _epsilon);
-    measure_batchnorm_cost(bnOp);
+    if (!costDatabase.lookup(bnOp, key)) {
+      measure_batchnorm_cost(bnOp);
+      costDatabase.store(bnOp, key);
+    }
     batchnorm[key] = bnOp;
   }
   Op ret;
@@ -34,7 +34,10 @@ Op Model::get_or_create_cast(const Tensor& _input, DataType _datatype)
     castOp = cast[key];
   } else {
     castOp = new Cast(this, _input, _datatype);
-    measure_cast_cost(castOp);
+    if (!costDatabase.lookup(castOp, key)) {
+      measure_cast_cost(castOp);
+      costDatabase.store(castOp, key);
+    }
     cast[key] = castOp;
   }
   Op ret;
@@ -135,7 +135,10 @@ Op Model::get_or_create_conv2d(Tensor _input, Tensor _weight,
   } else {
     convOp = new Conv2D(this, _input, _weight, _strideH, _strideW,
                         _padding, _activation);
-    measure_conv2d_cost(convOp);
+    if (!costDatabase.lookup(convOp, key)) {
+      measure_conv2d_cost(convOp);
+      costDatabase.store(convOp, key);
+    }
     conv2d[key] = convOp;
   }
   Op ret;
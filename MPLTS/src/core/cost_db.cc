@@ -0,0 +1,104 @@
+/* Copyright 2019 Stanford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "taso/ops.h"
+#include <sstream>
+using namespace taso;
+
+#ifdef USE_CUDNN
+static const char* COST_BACKEND = "cudnn";
+#else
+static const char* COST_BACKEND = "dnnl";
+#endif
+
+CostDatabase::CostDatabase(void)
+{
+}
+
+CostDatabase::~CostDatabase(void)
+{
+  if (file.is_open())
+    file.close();
+}
+
+// each line is "runtime algo backend type keys...", where trailing
+// zeros of the keys are dropped
+void CostDatabase::open(const std::string& file_name)
+{
+  std::ifstream input(file_name);
+  std::string line;
+  int num_entries = 0;
+  while (std::getline(input, line)) {
+    std::istringstream stream(line);
+    Entry entry;
+    std::string key;
+    if (!(stream >> entry.runtime >> entry.algo))
+      continue;
+    std::getline(stream >> std::ws, key);
+    costs[key] = entry;
+    num_entries++;
+  }
+  file.open(file_name, std::ios::app);
+  if (!file.is_open())
+    fprintf(stderr, "Warning: cannot write operator costs to %s\n",
+            file_name.c_str());
+  else if (num_entries > 0)
+    printf("Loaded %d operator costs from %s\n", num_entries,
+           file_name.c_str());
+}
+
+std::string CostDatabase::entry_key(OpType type, const int* keys,
+                                    int length) const
+{
+  while (length > 0 && keys[length - 1] == 0)
+    length--;
+  std::ostringstream res;
+  res << COST_BACKEND << " " << type;
+  for (int i = 0; i < length; i++)
+    res << " " << keys[i];
+  return res.str();
+}
+
+bool CostDatabase::lookup(OpBase* op, const int* keys, int length)
+{
+  if (costs.empty())
+    return false;
+  std::map<std::string, Entry>::const_iterator it
+      = costs.find(entry_key(op->type, keys, length));
+  if (it == costs.end())
+    return false;
+  op->runtime = it->second.runtime;
+#ifdef USE_CUDNN
+  if (op->type == OP_CONV2D)
+    ((Conv2D*) op)->fwdAlgo = (cudnnConvolutionFwdAlgo_t) it->second.algo;
+#endif
+  return true;
+}
+
+void CostDatabase::store(const OpBase* op, const int* keys, int length)
+{
+  if (!file.is_open())
+    return;
+  Entry entry;
+  entry.runtime = op->runtime;
+  entry.algo = 0;
+#ifdef USE_CUDNN
+  if (op->type == OP_CONV2D)
+    entry.algo = ((const Conv2D*) op)->fwdAlgo;
+#endif
+  std::string key = entry_key(op->type, keys, length);
+  costs[key] = entry;
+  file << entry.runtime << " " << entry.algo << " " << key << std::endl;
+}
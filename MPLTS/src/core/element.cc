@@ -62,7 +62,10 @@ Op Model::get_or_create_element(OpType type,
     eleOp = element[key];
   } else {
     eleOp = new Element(this, type, t1, t2);
-    measure_element_cost(eleOp);
+    if (!costDatabase.lookup(eleOp, key)) {
+      measure_element_cost(eleOp);
+      costDatabase.store(eleOp, key);
+    }
     element[key] = eleOp;
   }
   Op ret;
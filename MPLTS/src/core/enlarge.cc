@@ -49,7 +49,10 @@ Op Model::get_or_create_enlarge(Tensor _w1, Tensor _w2)
     enlargeOp = enlarge[key];
   } else {
     enlargeOp = new Enlarge(this, _w1, _w2);
-    measure_enlarge_cost(enlargeOp);
+    if (!costDatabase.lookup(enlargeOp, key)) {
+      measure_enlarge_cost(enlargeOp);
+      costDatabase.store(enlargeOp, key);
+    }
     enlarge[key] = enlargeOp;
   }
   Op ret;
@@ -62,7 +62,10 @@ Op Model::get_or_create_matmul(Tensor _input, Tensor _weight,
     matmulOp = matmul[key];
   } else {
     matmulOp = new Matmul(this, _input, _weight, _acti);
-    measure_matmul_cost(matmulOp);
+    if (!costDatabase.lookup(matmulOp, key)) {
+      measure_matmul_cost(matmulOp);
+      costDatabase.store(matmulOp, key);
+    }
     matmul[key] = matmulOp;
   }
   Op ret;
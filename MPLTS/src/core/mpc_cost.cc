@@ -0,0 +1,306 @@
+/* Copyright 2019 Stanford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "taso/ops.h"
+#include <cmath>
+using namespace taso;
+
+// computational and statistical security parameters
+const int MPC_KAPPA = 128;
+const int MPC_SPDZ2K_SECURITY = 64;
+// multiply-and-truncate steps per iteration of approximations (exp, div, ...)
+const int MPC_NONLINEAR_STEPS = 2;
+
+MPCCostModel::MPCCostModel(MPCProtocol _protocol, int _bitLength,
+                           int _precision, double _bandwidth,
+                           double _latency, bool _offline)
+: protocol(_protocol), bitLength(_bitLength), precision(_precision),
+  security(MPC_SPDZ2K_SECURITY), bandwidth(_bandwidth), latency(_latency),
+  offline(_offline)
+{
+  assert(bandwidth > 0);
+  switch (protocol) {
+    case MPC_REP3:
+    case MPC_SPDZ2K:
+      // two ring elements per share (replicated or value and MAC)
+      cpuFactor = 2.0f;
+      break;
+    case MPC_SEMI2K:
+      cpuFactor = 1.0f;
+      break;
+    default:
+      assert(false);
+  }
+}
+
+MPCCost MPCCostModel::muls(void) const
+{
+  double k = bitLength, s = security, n = 2;
+  switch (protocol) {
+    case MPC_REP3:
+      return MPCCost(k * 3, 1);
+    case MPC_SEMI2K:
+      return MPCCost(k * 4, 1, k * (k + MPC_KAPPA), 1);
+    case MPC_SPDZ2K:
+    {
+      double mac = (s * k + k + s) * n * (n - 1);
+      return MPCCost((k + s) * n * (n - 1) * 2, 1,
+                     mac * 2 + n * (n - 1) * (18 * s * s + 4 * k * k + 17 * k * s), 8);
+    }
+    default:
+      assert(false);
+  }
+  return MPCCost();
+}
+
+MPCCost MPCCostModel::matmuls(double p, double q, double r) const
+{
+  double k = bitLength;
+  switch (protocol) {
+    case MPC_REP3:
+      // dot products only communicate the outputs
+      return MPCCost(p * r * k * 3, 1);
+    case MPC_SEMI2K:
+      // matrix triples open both masked operands
+      return MPCCost((p * q + q * r) * k * 2, 1,
+                     p * q * r * k * (k + MPC_KAPPA), 1);
+    case MPC_SPDZ2K:
+      return muls() * (p * q * r);
+    default:
+      assert(false);
+  }
+  return MPCCost();
+}
+
+MPCCost MPCCostModel::trunc(void) const
+{
+  double k = bitLength, s = security, n = 2;
+  switch (protocol) {
+    case MPC_REP3:
+      return MPCCost(k, 1);
+    case MPC_SEMI2K:
+      // local truncation
+      return MPCCost();
+    case MPC_SPDZ2K:
+    {
+      // one authenticated random bit per truncated bit
+      double f = precision;
+      double mac = (s * k + k + s) * n * (n - 1);
+      double triple = mac * 2 + n * (n - 1) * (18 * s * s + 4 * k * k + 17 * k * s);
+      return MPCCost((k + s) * n * (n - 1), 1,
+                     f * ((s + k) * (n - 1) + mac + (k + s) * n * (n - 1) * 2 + triple), 13);
+    }
+    default:
+      assert(false);
+  }
+  return MPCCost();
+}
+
+MPCCost MPCCostModel::ltz(void) const
+{
+  double k = bitLength;
+  double depth = std::log2(k) + 2;
+  switch (protocol) {
+    case MPC_REP3:
+      return MPCCost(k * 9, depth);
+    case MPC_SEMI2K:
+      return MPCCost(k * MPC_KAPPA * 2 + MPC_KAPPA + k, 4,
+                     k * MPC_KAPPA * 4 + MPC_KAPPA, 2);
+    case MPC_SPDZ2K:
+    {
+      // carry circuit over k bits
+      MPCCost res = muls() * k;
+      res.rounds = depth;
+      return res;
+    }
+    default:
+      assert(false);
+  }
+  return MPCCost();
+}
+
+MPCCost MPCCostModel::activation(ActiMode mode, double n) const
+{
+  switch (mode) {
+    case AC_MODE_RELU:
+      return (ltz() + muls()) * n;
+    case AC_MODE_SIGMOID:
+    case AC_MODE_TANH:
+      return nonlinear(n);
+    default:
+      return MPCCost();
+  }
+}
+
+// n independent maxima over k values each, as a tree of comparisons
+MPCCost MPCCostModel::tree_max(double n, double k) const
+{
+  if (k <= 1) return MPCCost();
+  MPCCost level = ltz() + muls();
+  MPCCost res = level * (n * (k - 1));
+  double depth = std::ceil(std::log2(k));
+  res.rounds = level.rounds * depth;
+  res.offlineRounds = level.offlineRounds * depth;
+  return res;
+}
+
+MPCCost MPCCostModel::nonlinear(double n) const
+{
+  // the iterations double the number of correct fractional bits
+  int iterations = std::ceil(std::log2(std::max(precision, 2)));
+  MPCCost res = ltz();
+  for (int i = 0; i < MPC_NONLINEAR_STEPS * iterations; i++)
+    res = res + muls() + trunc();
+  return res * n;
+}
+
+MPCCost MPCCostModel::op_cost(const OpBase* op) const
+{
+  double volume = op->outputs[0].volume();
+  switch (op->type) {
+    case OP_CONV2D:
+    {
+      const Conv2D* conv = (const Conv2D*) op;
+      const Tensor& input = op->inputs[0];
+      const Tensor& weight = op->inputs[1];
+      const Tensor& output = op->outputs[0];
+      double groups = input.dim[1] / weight.dim[1];
+      double p = (double) output.dim[0] * output.dim[2] * output.dim[3];
+      double q = (double) weight.dim[1] * weight.dim[2] * weight.dim[3];
+      double r = weight.dim[0] / groups;
+      return matmuls(p, q, r) * groups + trunc() * volume
+          + activation(conv->activation, volume);
+    }
+    case OP_MATMUL:
+    {
+      const Matmul* matmul = (const Matmul*) op;
+      const Tensor& output = op->outputs[0];
+      int nd = output.numDim;
+      double p = output.dim[nd - 2], r = output.dim[nd - 1];
+      double q = op->inputs[0].dim[nd - 1];
+      return matmuls(p, q, r) * (volume / (p * r)) + trunc() * volume
+          + activation(matmul->activation, volume);
+    }
+    case OP_MUL:
+    case OP_EW_MUL:
+    case OP_BATCHNORM:
+    case OP_FUSE_CONV_BATCHNORM:
+    case OP_FUSE_CONV_BATCHNORM_ALPHA_VAR:
+    case OP_FUSE_CONV_BATCHNORM_BIAS:
+      return (muls() + trunc()) * volume;
+    case OP_WHERE:
+      return muls() * volume;
+    case OP_RELU:
+      return (ltz() + muls()) * volume;
+    case OP_LEAKYRELU:
+    case OP_PRELU:
+      return (ltz() + muls() + trunc()) * volume;
+    case OP_SIGMOID:
+    case OP_TANH:
+    case OP_EXP:
+    case OP_LOG:
+    case OP_SQRT:
+    case OP_EW_DIV:
+      return nonlinear(volume);
+    case OP_CEIL:
+    case OP_ROUND:
+    case OP_EW_GREATER:
+    case OP_EW_LESS:
+      return ltz() * volume;
+    case OP_EW_EQUAL:
+      return ltz() * (2 * volume);
+    case OP_EW_MAX:
+    case OP_EW_MIN:
+      return (ltz() + muls()) * volume;
+    case OP_POOL2D_MAX:
+    {
+      const Pool2D* pool = (const Pool2D*) op;
+      return tree_max(volume, pool->kernelH * pool->kernelW)
+          + activation(pool->activation, volume);
+    }
+    case OP_POOL2D_AVG:
+    {
+      const Pool2D* pool = (const Pool2D*) op;
+      return trunc() * volume + activation(pool->activation, volume);
+    }
+    case OP_REDUCE_MAX:
+    case OP_REDUCE_MIN:
+    case OP_REDUCE_ARGMAX:
+    case OP_REDUCE_ARGMIN:
+      return tree_max(volume, op->inputs[0].volume() / volume);
+    case OP_REDUCE_MEAN:
+      return trunc() * volume;
+    case OP_REDUCE_PROD:
+    {
+      double k = op->inputs[0].volume() / volume;
+      if (k <= 1) return MPCCost();
+      MPCCost level = muls() + trunc();
+      MPCCost res = level * (volume * (k - 1));
+      res.rounds = level.rounds * std::ceil(std::log2(k));
+      res.offlineRounds = level.offlineRounds * std::ceil(std::log2(k));
+      return res;
+    }
+    case OP_TOPK:
+    {
+      // bitonic sorting network along the axis
+      const TopK* topk = (const TopK*) op;
+      double n = op->inputs[0].dim[topk->axis];
+      if (n <= 1) return MPCCost();
+      double depth = std::ceil(std::log2(n));
+      double rows = op->inputs[0].volume() / n;
+      MPCCost level = ltz() + muls() + muls();
+      MPCCost res = level * (rows * n / 2 * depth * (depth + 1) / 2);
+      res.rounds = level.rounds * depth * (depth + 1) / 2;
+      res.offlineRounds = level.offlineRounds * depth * (depth + 1) / 2;
+      return res;
+    }
+    default:
+      // linear or data movement only
+      return MPCCost();
+  }
+}
+
+float MPCCostModel::runtime(const MPCCost& cost) const
+{
+  double bits = cost.bits, rounds = cost.rounds;
+  if (offline) {
+    bits += cost.offlineBits;
+    rounds += cost.offlineRounds;
+  }
+  return 1e3 * (bits / bandwidth + rounds * latency);
+}
+
+float MPCCostModel::runtime(const OpBase* op) const
+{
+  return runtime(op_cost(op)) + cpuFactor * op->runtime;
+}
+
+float Model::op_cost(const OpBase* op)
+{
+  if (mpcCostModel == NULL)
+    return op->runtime;
+  return mpcCostModel->runtime(op);
+}
+
+void Graph::set_mpc_cost_model(MPCProtocol protocol, int bitLength,
+                               int precision, float bandwidth, float latency)
+{
+  delete model->mpcCostModel;
+  model->mpcCostModel = NULL;
+  if (protocol != MPC_NONE)
+    model->mpcCostModel = new MPCCostModel(protocol, bitLength, precision,
+                                           bandwidth, latency);
+  totalCost = -1.0f;
+}
@@ -36,7 +36,10 @@ Op Model::get_or_create_mul(const Tensor& x,
     mulOp = mul[key];
   } else {
     mulOp = new Mul(this, x, y);
-    measure_mul_cost(mulOp);
+    if (!costDatabase.lookup(mulOp, key)) {
+      measure_mul_cost(mulOp);
+      costDatabase.store(mulOp, key);
+    }
     mul[key] = mulOp;
   }
   Op ret;
@@ -21,6 +21,9 @@
 #include <semaphore.h>
 #include <vector>
 #include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 using namespace taso;
 
@@ -361,9 +364,15 @@ Graph::Graph()
 {
   if (model_singleton == NULL) {
     model_singleton = new Model();
+    char* cost_db = getenv("TASO_COST_DB");
+    if (cost_db != NULL)
+      model_singleton->costDatabase.open(cost_db);
   }
   model = model_singleton;
-  model->print_cost = false;
+  // graphs created by the search threads leave the shared flag alone,
+  // optimize() clears it before starting them
+  if (!model->searching)
+    model->print_cost = false;
   //size_t inputSize = sizeof(DATATYPE) * n * c * h * w;
   //checkCUDA(cudaMalloc(&input.ptr, inputSize));
   //printf("Initialize a graph\n");
@@ -414,39 +423,7 @@ int counter;
 int maxNumOps;
 
 void Graph::optimize_on_step(float alpha, int budget){
-  for (int i = 1; i < 3; i++)
-    for (int j = 0; j < 2; j++) {
-      PaddingMode pad_mode = (j == 0) ? PD_MODE_SAME : PD_MODE_VALID;
-      xfers.push_back(GraphXfer::create_conv_relu(model, i, i, pad_mode));
-      xfers.push_back(GraphXfer::create_conv_batch(model, i, i, pad_mode));
-      xfers.push_back(GraphXfer::create_conv_mul(model, i, i, pad_mode));
-      // xfers.push_back(GraphXfer::create_conv_add(model, i, i, pad_mode));
-    }
-  xfers.push_back(GraphXfer::create_enlarge_merge_convs(model, AC_MODE_NONE));
-  xfers.push_back(GraphXfer::create_enlarge_merge_convs(model, AC_MODE_RELU));
-  xfers.push_back(GraphXfer::create_merge_group_convs(model, 1, 1, AC_MODE_NONE));
-  xfers.push_back(GraphXfer::create_merge_group_convs(model, 1, 1, AC_MODE_RELU));
-  xfers.push_back(GraphXfer::create_merge_group_convs(model, 2, 2, AC_MODE_NONE));
-  xfers.push_back(GraphXfer::create_merge_group_convs(model, 2, 2, AC_MODE_RELU));
-
-  //xfers.push_back(create_avg_pool_conv(model));
-  //xfers.push_back(create_two_pools(model));
-  //xfers.push_back(create_merge_seperable_convs(model));
-  char* taso_path = getenv("TASO_HOME");
-  if (taso_path == NULL) {
-    fprintf(stderr, "Error: environment variable TASO_HOME is not set. "
-           "Please set TASO_HOME to the home directory of TASO source code.\n");
-    assert(false);
-  }
-  std::string graph_subst_file = std::string(taso_path) + "/graph_subst.pb";
-  GraphXfer::load_graph_xfer_from_pb_file(model, xfers, graph_subst_file);
-  //xfers.push_back(create_fuse_conv_batch_xfer(model));
-  //xfers.push_back(create_fuse_conv_relu_xfer(model));
-  //xfers.push_back(create_merge_conv_xfer(model));
-  //xfers.push_back(create_exclusive_concat_xfer(model));
-  //xfers.push_back(create_enlarge_conv_xfer(model));
-  //xfers.push_back(create_resnet_merge_xfer(model));
-  
+  create_xfers(model, xfers);
 
   // candidates.push(this);
   hashmap.insert(hash());
@@ -519,9 +496,8 @@ bool Graph::optimize_next_step(float alpha, int budget){
   return 0;
 }
 
-Graph* Graph::optimize(float alpha, int budget, bool print_subst)
+void Graph::create_xfers(Model* model, std::vector<GraphXfer*>& xfers)
 {
-  std::vector<GraphXfer*> xfers;
   for (int i = 1; i < 3; i++)
     for (int j = 0; j < 2; j++) {
       PaddingMode pad_mode = (j == 0) ? PD_MODE_SAME : PD_MODE_VALID;
@@ -554,6 +530,27 @@ Graph* Graph::optimize(float alpha, int budget, bool print_subst)
   //xfers.push_back(create_exclusive_concat_xfer(model));
   //xfers.push_back(create_enlarge_conv_xfer(model));
   //xfers.push_back(create_resnet_merge_xfer(model));
+}
+
+Graph* Graph::optimize(float alpha, int budget, bool print_subst)
+{
+  // Candidates are expanded by several threads that share the priority
+  // queue and the hash set; each thread applies its own copy of the
+  // substitutions since matching keeps state in GraphXfer
+  int numThreads = std::thread::hardware_concurrency();
+  char* num_threads = getenv("TASO_NUM_THREADS");
+  if (num_threads != NULL)
+    numThreads = atoi(num_threads);
+  numThreads = std::max(numThreads, 1);
+  std::vector<std::vector<GraphXfer*> > xfers(numThreads);
+  create_xfers(model, xfers[0]);
+  for (int i = 1; i < numThreads; i++)
+    for (size_t j = 0; j < xfers[0].size(); j++)
+      xfers[i].push_back(new GraphXfer(*xfers[0][j]));
+  // graphs created during the search do not print their costs, and the
+  // flag is shared by all threads
+  model->print_cost = false;
+  model->searching = true;
 
   std::priority_queue<Graph*, std::vector<Graph*>, GraphCompare> candidates;
   std::set<size_t> hashmap;
@@ -568,40 +565,79 @@ Graph* Graph::optimize(float alpha, int budget, bool print_subst)
 
   int counter = 0;
   int maxNumOps = inEdges.size();
+  // graphs popped but not fully expanded yet
+  std::set<Graph*> expanding;
+  bool finished = false;
+  std::mutex mutex;
+  std::condition_variable cond;
   //long long start_time = microsecond_timer();
   ofstream timer_fs;
   timer_fs.open("timer.txt");
   printf("\n        ===== Start Cost-Based Backtracking Search =====\n");
-  while (!candidates.empty()) {
-    Graph *subGraph = candidates.top();
-    candidates.pop();
-    if (subGraph->total_cost() < bestCost) {
-      delete bestGraph;
-      bestCost = subGraph->total_cost();
-      bestGraph = subGraph;
-    }
-    if (counter > budget) {
-      // TODO: free all remaining candidates when budget exhausted 
-      break;
-    }
-    if (counter % 1 == 0) {
-      printf("        [%d] cost = %.4lf bestCost = %.4lf candidates.size() = %zu\n", counter, subGraph->total_cost(), bestCost, candidates.size());
-      //timer_fs << microsecond_timer() - start_time << ", " << bestCost << std::endl;
-    }
-    counter ++;
-    for (size_t i = 0; i < xfers.size(); i++) {
-      //for (size_t j = 0; j < xfers[i]->srcOps.size(); j++) {
-      //  printf("srcOps[%zu]: type(%d)\n", j, xfers[i]->srcOps[j]->type);
-      //}
-      //for (size_t j = 0; j < xfers[i]->dstOps.size(); j++) {
-      //  printf("dstOps[%zu]: type(%d)\n", j, xfers[i]->dstOps[j]->type);
-      //}
-      xfers[i]->run(0, subGraph, candidates, hashmap, bestCost * alpha, 2 * maxNumOps);
-    }
-    if (bestGraph != subGraph) {
-      delete subGraph;
+  auto search = [&](std::vector<GraphXfer*>& xfers) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      while (!finished && candidates.empty() && !expanding.empty())
+        cond.wait(lock);
+      if (finished || candidates.empty())
+        break;
+      Graph *subGraph = candidates.top();
+      candidates.pop();
+      if (subGraph->total_cost() < bestCost) {
+        if (expanding.find(bestGraph) == expanding.end())
+          delete bestGraph;
+        bestCost = subGraph->total_cost();
+        bestGraph = subGraph;
+      }
+      if (counter > budget) {
+        // TODO: free all remaining candidates when budget exhausted
+        finished = true;
+        break;
+      }
+      if (counter % 1 == 0) {
+        printf("        [%d] cost = %.4lf bestCost = %.4lf candidates.size() = %zu\n", counter, subGraph->total_cost(), bestCost, candidates.size());
+        //timer_fs << microsecond_timer() - start_time << ", " << bestCost << std::endl;
+      }
+      counter ++;
+      float threshold = bestCost * alpha;
+      expanding.insert(subGraph);
+      lock.unlock();
+
+      // costs of new graphs are derived from the rewritten operators only
+      std::priority_queue<Graph*, std::vector<Graph*>, GraphCompare> newGraphs;
+      std::set<size_t> newHashes;
+      for (size_t i = 0; i < xfers.size(); i++) {
+        xfers[i]->run(0, subGraph, newGraphs, newHashes, threshold,
+                      2 * maxNumOps, true);
+      }
+
+      lock.lock();
+      while (!newGraphs.empty()) {
+        Graph* newGraph = newGraphs.top();
+        newGraphs.pop();
+        if (hashmap.insert(newGraph->hash()).second)
+          candidates.push(newGraph);
+        else
+          delete newGraph;
+      }
+      expanding.erase(subGraph);
+      if (bestGraph != subGraph) {
+        delete subGraph;
+      }
+      cond.notify_all();
     }
-  }
+    cond.notify_all();
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; i++)
+    threads.push_back(std::thread(search, std::ref(xfers[i])));
+  search(xfers[0]);
+  for (auto& thread : threads)
+    thread.join();
+  model->searching = false;
+  for (int i = 1; i < numThreads; i++)
+    for (size_t j = 0; j < xfers[i].size(); j++)
+      delete xfers[i][j];
   bestGraph = bestGraph->preprocess_weights();
   printf("        ===== Finish Cost-Based Backtracking Search =====\n\n");
   //printf("bestCost = %.4lf\n", bestGraph->total_cost());
@@ -1230,7 +1266,7 @@ float Graph::total_cost(void)
   std::map<Op, std::set<Edge, EdgeCompare>, OpCompare>::const_iterator it;
   float total = 0.0f;
   for (it = inEdges.begin(); it != inEdges.end(); it++) {
-    if (it->first.ptr != NULL) total += it->first.ptr->runtime;
+    if (it->first.ptr != NULL) total += model->op_cost(it->first.ptr);
   }
   totalCost = total;
   return total;
@@ -1517,5 +1553,16 @@ void Graph::print_costs(void)
          "memory_access(%.4lf) kernel_launches(%d)\n",
          exe_time, flops / 1024.0 / 1024.0 / 1024.0,
          mem_acc * 4.0 / 1024.0 / 1024.0, num_kernels);
+  if (model->mpcCostModel != NULL) {
+    MPCCost mpc;
+    for (it = inEdges.begin(); it != inEdges.end(); it++) {
+      if (it->first.ptr != NULL)
+        mpc = mpc + model->mpcCostModel->op_cost(it->first.ptr);
+    }
+    printf("        MPC cost metrics: online_comm(%.4lf MB) online_rounds(%.0lf) "
+           "offline_comm(%.4lf MB) offline_rounds(%.0lf) secure_time(%.4lf)\n",
+           mpc.bits / 8e6, mpc.rounds, mpc.offlineBits / 8e6,
+           mpc.offlineRounds, total_cost());
+  }
 }
 
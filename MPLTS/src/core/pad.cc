@@ -42,7 +42,10 @@ Op Model::get_or_create_pad(const Tensor& _input,
     padOp = pad[key];
   } else {
     padOp = new Pad(this, _input, _pad_before, _pad_after, _pad_value);
-    measure_pad_cost(padOp);
+    if (!costDatabase.lookup(padOp, key)) {
+      measure_pad_cost(padOp);
+      costDatabase.store(padOp, key);
+    }
     pad[key] = padOp;
   }
   Op ret;
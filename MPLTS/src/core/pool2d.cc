@@ -108,7 +108,10 @@ Op Model::get_or_create_pool2d(Tensor _input, Tensor _weight,
   } else {
     poolOp = new Pool2D(this, _input, _weight, _type, _kernelH, _kernelW,
                         _strideH, _strideW, _padding, _activation);
-    measure_pool2d_cost(poolOp);
+    if (!costDatabase.lookup(poolOp, key)) {
+      measure_pool2d_cost(poolOp);
+      costDatabase.store(poolOp, key);
+    }
     pool2d[key] = poolOp;
   }
   Op ret;
@@ -93,7 +93,10 @@ Op Model::get_or_create_reduce(const Tensor& _input,
     reduceOp = reduce[key];
   } else {
     reduceOp = new Reduce(this, _input, _type, axes, keepdims);
-    measure_reduce_cost(reduceOp);
+    if (!costDatabase.lookup(reduceOp, key)) {
+      measure_reduce_cost(reduceOp);
+      costDatabase.store(reduceOp, key);
+    }
     reduce[key] = reduceOp;
   }
   Op ret;
@@ -53,7 +53,10 @@ Op Model::get_or_create_reshape(Tensor _input,
     reshapeOp = reshape[key];
   } else {
     reshapeOp = new Reshape(this, _input, _shape);
-    measure_reshape_cost(reshapeOp);
+    if (!costDatabase.lookup(reshapeOp, key)) {
+      measure_reshape_cost(reshapeOp);
+      costDatabase.store(reshapeOp, key);
+    }
     reshape[key] = reshapeOp;
   }
   Op ret;
@@ -38,7 +38,10 @@ Op Model::get_or_create_resize(const Tensor& _input,
     resizeOp = resize[key];
   } else {
     resizeOp = new Resize(this, _input, _shape);
-    measure_resize_cost(resizeOp);
+    if (!costDatabase.lookup(resizeOp, key)) {
+      measure_resize_cost(resizeOp);
+      costDatabase.store(resizeOp, key);
+    }
     resize[key] = resizeOp;
   }
   Op ret;
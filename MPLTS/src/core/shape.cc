@@ -36,7 +36,10 @@ Op Model::get_or_create_shape(const Tensor& _input,
     shapeOp = shape[key];
   } else {
     shapeOp = new Shape(this, _input, _type);
-    measure_shape_cost(shapeOp);
+    if (!costDatabase.lookup(shapeOp, key)) {
+      measure_shape_cost(shapeOp);
+      costDatabase.store(shapeOp, key);
+    }
     shape[key] = shapeOp;
   }
   Op ret;
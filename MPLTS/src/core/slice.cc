@@ -47,7 +47,10 @@ Op Model::get_or_create_slice(const Tensor& _input,
     sliceOp = slice[key];
   } else {
     sliceOp = new Slice(this, _input, _start, _end, _axes, _steps);
-    measure_slice_cost(sliceOp);
+    if (!costDatabase.lookup(sliceOp, key)) {
+      measure_slice_cost(sliceOp);
+      costDatabase.store(sliceOp, key);
+    }
     slice[key] = sliceOp;
   }
   Op ret;
@@ -88,7 +88,10 @@ Op Model::get_or_create_split(const Tensor& _input, int _axis,
     splitOp = split[key];
   } else {
     splitOp = new Split(this, _input, _axis, _sizes);
-    measure_split_cost(splitOp);
+    if (!costDatabase.lookup(splitOp, key)) {
+      measure_split_cost(splitOp);
+      costDatabase.store(splitOp, key);
+    }
     split[key] = splitOp;
   }
   Op ret;
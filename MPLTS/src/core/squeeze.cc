@@ -36,7 +36,10 @@ Op Model::get_or_create_squeeze(const Tensor& input,
     squeezeOp = squeeze[key];
   } else {
     squeezeOp = new Squeeze(this, input, axes);
-    measure_squeeze_cost(squeezeOp);
+    if (!costDatabase.lookup(squeezeOp, key)) {
+      measure_squeeze_cost(squeezeOp);
+      costDatabase.store(squeezeOp, key);
+    }
     squeeze[key] = squeezeOp;
   }
   Op ret;
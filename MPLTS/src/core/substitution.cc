@@ -671,6 +671,43 @@ GraphXfer::GraphXfer(Model* _model)
 : model(_model), tensorId(10)
 {}
 
+GraphXfer::GraphXfer(const GraphXfer& xfer)
+: model(xfer.model), tensorId(xfer.tensorId)
+{
+  // operators are cloned and their tensors redirected to the clones;
+  // pattern inputs have no operator
+  std::map<const OpX*, OpX*> clones;
+  for (size_t i = 0; i < xfer.srcOps.size(); i++) {
+    srcOps.push_back(new OpX(*xfer.srcOps[i]));
+    clones[xfer.srcOps[i]] = srcOps.back();
+  }
+  for (size_t i = 0; i < xfer.dstOps.size(); i++) {
+    dstOps.push_back(new OpX(*xfer.dstOps[i]));
+    clones[xfer.dstOps[i]] = dstOps.back();
+  }
+  auto clone = [&](TensorX tensor) {
+    if (tensor.op != NULL)
+      tensor.op = clones.at(tensor.op);
+    return tensor;
+  };
+  for (auto& it : clones) {
+    for (size_t i = 0; i < it.second->inputs.size(); i++)
+      it.second->inputs[i] = clone(it.second->inputs[i]);
+    for (size_t i = 0; i < it.second->outputs.size(); i++)
+      it.second->outputs[i] = clone(it.second->outputs[i]);
+  }
+  for (auto& it : xfer.mappedOutputs)
+    mappedOutputs[clone(it.first)] = clone(it.second);
+}
+
+GraphXfer::~GraphXfer()
+{
+  for (size_t i = 0; i < srcOps.size(); i++)
+    delete srcOps[i];
+  for (size_t i = 0; i < dstOps.size(); i++)
+    delete dstOps[i];
+}
+
 OpX* GraphXfer::create_activation(TensorX input, OpType type, bool isSrcOp)
 {
   OpX* activation = new OpX(type, input);
@@ -1093,18 +1130,23 @@ void GraphXfer::unmatch(OpX* srcOp, Op op, Graph* graph)
 
 void GraphXfer::run(int depth, Graph* graph,
                     std::priority_queue<Graph*, std::vector<Graph*>, GraphCompare>& candidates,
-                    std::set<size_t>& hashmap, float threshold, int maxNumOps)
+                    std::set<size_t>& hashmap, float threshold, int maxNumOps,
+                    bool incremental)
 {
   //printf("run: depth(%d) srcOps.size(%zu) graph.size(%zu) candidates(%zu)\n", depth, srcOps.size(), graph->inEdges.size(), candidates.size());
   if (depth >= (int)srcOps.size()) {
     // Create dst operators
     bool pass = true;
     std::vector<OpX*>::const_iterator dstIt;
-    for (dstIt = dstOps.begin(); dstIt != dstOps.end(); dstIt++)
-      if (pass) {
-        OpX* dstOp = *dstIt;
-        pass = (pass & create_new_operator(dstOp, dstOp->mapOp));
-      }
+    {
+      // the model's operator cache is shared by all search threads
+      std::lock_guard<std::mutex> lock(model->mutex);
+      for (dstIt = dstOps.begin(); dstIt != dstOps.end(); dstIt++)
+        if (pass) {
+          OpX* dstOp = *dstIt;
+          pass = (pass & create_new_operator(dstOp, dstOp->mapOp));
+        }
+    }
     if (!pass) return;
     // Check that output tensors with external edges are mapped
     std::map<Op, OpX*, OpCompare>::const_iterator opIt;
@@ -1133,6 +1175,8 @@ void GraphXfer::run(int depth, Graph* graph,
     }
     // TODO: remove me for better performance
     assert(newGraph->check_correctness());
+    if (incremental)
+      newGraph->totalCost = incremental_cost(graph, newGraph);
     // if (newGraph->total_cost() < threshold && (int)newGraph->inEdges.size() < maxNumOps) {
     if ((int)newGraph->inEdges.size() < maxNumOps) {
         if (hashmap.find(newGraph->hash()) == hashmap.end()) {
@@ -1152,7 +1196,8 @@ void GraphXfer::run(int depth, Graph* graph,
         Op op = it->first;
         // Check mapOutput
         match(srcOp, op, graph);
-        run(depth + 1, graph, candidates, hashmap, threshold, maxNumOps);
+        run(depth + 1, graph, candidates, hashmap, threshold, maxNumOps,
+            incremental);
         unmatch(srcOp, op, graph);
       }
     }
@@ -1217,6 +1262,25 @@ Graph* GraphXfer::create_new_graph(Graph* graph)
   return newGraph;
 }
 
+// Cost of newGraph from the cost of graph and the rewritten operators
+// only, or -1 (recompute) if the rewrite also dropped unmapped operators
+float GraphXfer::incremental_cost(Graph* graph, Graph* newGraph)
+{
+  size_t expected = graph->inEdges.size() - mappedOps.size() + dstOps.size();
+  if (newGraph->inEdges.size() != expected)
+    return -1.0f;
+  float cost = graph->total_cost();
+  std::map<Op, OpX*, OpCompare>::const_iterator opIt;
+  for (opIt = mappedOps.begin(); opIt != mappedOps.end(); opIt++)
+    if (opIt->first.ptr != NULL)
+      cost -= model->op_cost(opIt->first.ptr);
+  std::vector<OpX*>::const_iterator dstIt;
+  for (dstIt = dstOps.begin(); dstIt != dstOps.end(); dstIt++)
+    if ((*dstIt)->mapOp.ptr != NULL)
+      cost += model->op_cost((*dstIt)->mapOp.ptr);
+  return cost > 0 ? cost : -1.0f;
+}
+
 bool GraphXfer::create_new_operator(const OpX* opx, Op& op)
 {
   switch (opx->type) {
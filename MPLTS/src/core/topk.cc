@@ -40,7 +40,10 @@ Op Model::get_or_create_topk(const Tensor& _input,
     topkOp = topk[key];
   } else {
     topkOp = new TopK(this, _input, _axis, _numk, _largest, _sorted);
-    measure_topk_cost(topkOp);
+    if (!costDatabase.lookup(topkOp, key)) {
+      measure_topk_cost(topkOp);
+      costDatabase.store(topkOp, key);
+    }
     topk[key] = topkOp;
   }
   Op ret;
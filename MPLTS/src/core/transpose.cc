@@ -75,7 +75,10 @@ Op Model::get_or_create_transpose(Tensor _input,
     transposeOp = transpose[key];
   } else {
     transposeOp = new Transpose(this, _input, perm, _shuffle);
-    measure_transpose_cost(transposeOp);
+    if (!costDatabase.lookup(transposeOp, key)) {
+      measure_transpose_cost(transposeOp);
+      costDatabase.store(transposeOp, key);
+    }
     transpose[key] = transposeOp;
   }
   Op ret;
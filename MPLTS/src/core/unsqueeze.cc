@@ -35,7 +35,10 @@ Op Model::get_or_create_unsqueeze(const Tensor& input,
     unsqzOp = unsqueeze[key];
   } else {
     unsqzOp = new Unsqueeze(this, input, axes);
-    measure_unsqueeze_cost(unsqzOp);
+    if (!costDatabase.lookup(unsqzOp, key)) {
+      measure_unsqueeze_cost(unsqzOp);
+      costDatabase.store(unsqzOp, key);
+    }
     unsqueeze[key] = unsqzOp;
   }
   Op ret;
@@ -64,7 +64,10 @@ Op Model::get_or_create_where(const Tensor& _cond,
     whereOp = where[key];
   } else {
     whereOp = new Where(this, _cond, _x, _y);
-    measure_where_cost(whereOp);
+    if (!costDatabase.lookup(whereOp, key)) {
+      measure_where_cost(whereOp);
+      costDatabase.store(whereOp, key);
+    }
     where[key] = whereOp;
   }
   Op ret;
@@ -0,0 +1,56 @@
+/*
+ * PackedShamir.hpp
+ *
+ */
+
+#ifndef MACHINES_PACKEDSHAMIR_HPP_
+#define MACHINES_PACKEDSHAMIR_HPP_
+
+#include "Protocols/PackedShamirShare.h"
+#include "Protocols/PackedShamirPrep.h"
+
+#include "ShamirMachine.hpp"
+#include "Protocols/PackedShamir.hpp"
+#include "Protocols/PackedShamirMC.hpp"
+#include "Protocols/PackedShamirInput.hpp"
+
+PackedShamirOptions PackedShamirOptions::singleton;
+
+int PackedShamirOptions::max_pack(const ShamirOptions& opts)
+{
+    // products of degree 2t + 3k - 3 need that many parties plus one
+    return max(1, (opts.nparties - 2 * opts.threshold + 2) / 3);
+}
+
+PackedShamirOptions::PackedShamirOptions(int pack) :
+        pack(pack)
+{
+}
+
+PackedShamirOptions::PackedShamirOptions(ez::ezOptionParser& opt, int argc,
+        const char** argv)
+{
+    opt.add(
+            "", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Number of secrets per polynomial (default: as many as the "
+            "number of parties and threshold allow)", // Help description.
+            "-K", // Flag token.
+            "--pack" // Flag token.
+    );
+    opt.parse(argc, argv);
+    int max = max_pack(ShamirOptions::s());
+    if (opt.isSet("-K"))
+        opt.get("-K")->getInt(pack);
+    else
+        pack = max;
+    if (pack < 1 or pack > max)
+        throw runtime_error(
+                "number of secrets per polynomial has to be between 1 and "
+                        + to_string(max));
+    opt.resetArgs();
+}
+
+#endif /* MACHINES_PACKEDSHAMIR_HPP_ */
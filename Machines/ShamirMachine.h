@@ -27,6 +27,22 @@ class ShamirMachine : public ShamirOptions
 {
 };
 
+/**
+ * Number of secrets per polynomial in packed Shamir secret sharing
+ */
+class PackedShamirOptions
+{
+public:
+    static PackedShamirOptions singleton;
+
+    int pack;
+
+    static int max_pack(const ShamirOptions& opts);
+
+    PackedShamirOptions(int pack = 1);
+    PackedShamirOptions(ez::ezOptionParser& opt, int argc, const char** argv);
+};
+
 template<template<class U> class T>
 class ShamirMachineSpec
 {
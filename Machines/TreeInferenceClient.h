@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <vector>
+#include <thread>
 #include "seal/seal.h"
 #include "seal/util/polyarithsmallmod.h"
 
@@ -52,14 +53,25 @@ public:
   Encryptor* encryptor;
   Evaluator* evaluator;
   Decryptor* decryptor;
+  BatchEncoder* encoder;
+
+  bool batched;
+  uint64_t plain_mod;
+  // queries per round trip
+  int batch_size;
 
   RealTwoPartyPlayer* player;
-  TreeInferenceClient();
+  TreeInferenceClient(bool batched = false);
   void start_networking(ez::ezOptionParser& opt);
   void send_single_query(vector<vector<Ciphertext> >& query);
   int recv_single_answer();
   void read_meta_and_sample();
   void generate_single_query(vector<int> &features,  vector<vector<Ciphertext> >& query);
+  void generate_batched_query(int begin, int end, vector<vector<Ciphertext> >& query);
+  void recv_batched_answer(vector<int> &answers);
+  bool query_entry(int feature_id, int value, int position);
+  int position_number(int feature_id);
+  int decode_label(int answer);
   void run();
   void send_keys();
 };
@@ -6,11 +6,9 @@
 #include "TreeInferenceServer.h"
 
 
-TreeInferenceClient::TreeInferenceClient() {
-  EncryptionParameters parms(scheme_type::bfv);
-  parms.set_poly_modulus_degree(poly_modulus_degree);
-  parms.set_coeff_modulus(CoeffModulus::BFVDefault(poly_modulus_degree));
-  parms.set_plain_modulus(plain_modulus);
+TreeInferenceClient::TreeInferenceClient(bool batched) : batched(batched) {
+  EncryptionParameters parms = tree_inference_parameters(batched);
+  plain_mod = parms.plain_modulus().value();
   context = new SEALContext(parms);
   keygen = new KeyGenerator(*context);
   secret_key = &keygen->secret_key();
@@ -21,6 +19,13 @@ TreeInferenceClient::TreeInferenceClient() {
   encryptor = new Encryptor(*context, *public_key);
   evaluator = new Evaluator(*context);
   decryptor = new Decryptor(*context, *secret_key);
+  if (batched) {
+    encoder = new BatchEncoder(*context);
+    batch_size = encoder->slot_count();
+  } else {
+    encoder = nullptr;
+    batch_size = 1;
+  }
 }
 
 void TreeInferenceClient::start_networking(ez::ezOptionParser &opt) {
@@ -54,21 +59,41 @@ void TreeInferenceClient::run() {
   read_meta_and_sample();
   timer.start(player->total_comm());
   send_keys();
-  for (int i = 0; i < test_sample_number; i++){
-    vector<vector<Ciphertext> > query;
-    generate_single_query(samples[i].features,  query);
-    send_single_query(query);
-  }
+  // answers are received while queries are still being sent
+  // so that the server can stream
   double right = 0;
-  for (int i = 0; i < test_sample_number; i++){
-    int answer = recv_single_answer();
-    cout << "recv answer = "  << answer << endl;
-    if (answer > int(plain_modulus / 2))
-      answer = answer - plain_modulus;
-    int label = round(answer * 1.0 / scale_for_decimal_part);
-    cout << "pred label =  "  << label << " real label = " <<  samples[i].label << endl;
-    right += label == samples[i].label;
+  thread receiver;
+  if (batched) {
+    receiver = thread([&]() {
+      for (int i = 0; i < test_sample_number; i += batch_size){
+        vector<int> answers;
+        recv_batched_answer(answers);
+        for (int j = i; j < min(i + batch_size, test_sample_number); j++)
+          right += decode_label(answers[j - i]) == samples[j].label;
+      }
+    });
+    for (int i = 0; i < test_sample_number; i += batch_size){
+      vector<vector<Ciphertext> > query;
+      generate_batched_query(i, min(i + batch_size, test_sample_number), query);
+      send_single_query(query);
+    }
+  } else {
+    receiver = thread([&]() {
+      for (int i = 0; i < test_sample_number; i++){
+        int answer = recv_single_answer();
+        cout << "recv answer = "  << answer << endl;
+        int label = decode_label(answer);
+        cout << "pred label =  "  << label << " real label = " <<  samples[i].label << endl;
+        right += label == samples[i].label;
+      }
+    });
+    for (int i = 0; i < test_sample_number; i++){
+      vector<vector<Ciphertext> > query;
+      generate_single_query(samples[i].features,  query);
+      send_single_query(query);
+    }
   }
+  receiver.join();
   cout << "test accuracy: " << right / test_sample_number << endl;
 
   timer.stop(player->total_comm());
@@ -134,6 +159,28 @@ void TreeInferenceClient::read_meta_and_sample() {
 //  }
 //}
 
+int TreeInferenceClient::position_number(int feature_id) {
+  if (max_values[feature_id] < value_max_threhold)
+    return max_values[feature_id];
+  int row = ceil(sqrt(max_values[feature_id]));
+  int col = ceil(max_values[feature_id] / row);
+  return row + col;
+}
+
+// prefix sum for small domains, column one-hot followed by row one-hot otherwise
+bool TreeInferenceClient::query_entry(int feature_id, int value, int position) {
+  if (max_values[feature_id] < value_max_threhold)
+    return value <= position;
+  int row = ceil(sqrt(max_values[feature_id]));
+  int col = ceil(max_values[feature_id] / row);
+  int row_index = value / col;
+  int col_index = value - (row_index * col);
+  if (position < col)
+    return position == col_index;
+  else
+    return position - col == row_index;
+}
+
 void TreeInferenceClient::generate_single_query(vector<int> &features,  vector<vector<Ciphertext> >& query) {
   int size = features.size();
   const std::uint64_t temp_1 = 1;
@@ -141,54 +188,32 @@ void TreeInferenceClient::generate_single_query(vector<int> &features,  vector<v
   Plaintext one(seal::util::uint_to_hex_string(&temp_1, std::size_t(1)));
   Plaintext zero(seal::util::uint_to_hex_string(&temp_0, std::size_t(1)));
   for (int i = 0; i < size; i++){
-
-    if (max_values[i] < value_max_threhold){
-      vector<Ciphertext> prefix_sum;
-      for (int j = 0; j < max_values[i]; j++){
-        if (features[i] <= j){
-          Ciphertext x_encrypted;
-          encryptor->encrypt(one, x_encrypted);
-          prefix_sum.push_back(x_encrypted);
-        }else{
-          Ciphertext x_encrypted;
-          encryptor->encrypt(zero, x_encrypted);
-          prefix_sum.push_back(x_encrypted);
-        }
-      }
-      query.push_back(prefix_sum);
+    vector<Ciphertext> encoded_feature(position_number(i));
+    for (int j = 0; j < position_number(i); j++){
+      if (query_entry(i, features[i], j))
+        encryptor->encrypt(one, encoded_feature[j]);
+      else
+        encryptor->encrypt(zero, encoded_feature[j]);
     }
-    else{
-      vector<Ciphertext> row_and_col_vector;
-      int row = ceil(sqrt(max_values[i]));
-      int col = ceil(max_values[i] / row);
-      int row_index = features[i] / col;
-      int col_index = features[i] - (row_index * col);
-//      cout << row << " " << col << endl;
-//      cout << row_index << " " << col_index << endl;
-      for (int j = 0; j < col; j++){
-        if (j == col_index){
-          Ciphertext x_encrypted;
-          encryptor->encrypt(one, x_encrypted);
-          row_and_col_vector.push_back(x_encrypted);
-        } else{
-          Ciphertext x_encrypted;
-          encryptor->encrypt(zero, x_encrypted);
-          row_and_col_vector.push_back(x_encrypted);
-        }
-      }
-      for (int j = 0; j < row; j++){
-        if (j == row_index){
-          Ciphertext x_encrypted;
-          encryptor->encrypt(one, x_encrypted);
-          row_and_col_vector.push_back(x_encrypted);
-        } else{
-          Ciphertext x_encrypted;
-          encryptor->encrypt(zero, x_encrypted);
-          row_and_col_vector.push_back(x_encrypted);
-        }
-      }
-      query.push_back(row_and_col_vector);
+    query.push_back(encoded_feature);
+  }
+}
+
+// slot k of every ciphertext belongs to sample begin + k
+void TreeInferenceClient::generate_batched_query(int begin, int end, vector<vector<Ciphertext> >& query) {
+  assert(end - begin <= batch_size);
+  vector<uint64_t> slots(batch_size);
+  Plaintext plain;
+  for (int i = 0; i < feature_number; i++){
+    vector<Ciphertext> encoded_feature(position_number(i));
+    for (int j = 0; j < position_number(i); j++){
+      fill(slots.begin(), slots.end(), 0);
+      for (int k = begin; k < end; k++)
+        slots[k - begin] = query_entry(i, samples[k].features[i], j);
+      encoder->encode(slots, plain);
+      encryptor->encrypt(plain, encoded_feature[j]);
     }
+    query.push_back(encoded_feature);
   }
 }
 
@@ -233,4 +258,31 @@ int TreeInferenceClient::recv_single_answer() {
   decryptor->decrypt(received_ciphertext, answer);
 
   return std::stoi(answer.to_string(), nullptr, 16);
-}
\ No newline at end of file
+}
+
+
+void TreeInferenceClient::recv_batched_answer(vector<int> &answers) {
+  octetStream os;
+  player->receive(os);
+  string s = os.str();
+  std::stringstream received_ciphertext_stream(s);
+  seal::Ciphertext received_ciphertext;
+  received_ciphertext.load(*context, received_ciphertext_stream);
+  int budget = decryptor->invariant_noise_budget(received_ciphertext);
+  if (budget <= 0){
+    cout << "  noise budget in the recv answer: " << budget << " bits, error may be wrong."
+       << endl;
+  }
+
+  Plaintext answer;
+  decryptor->decrypt(received_ciphertext, answer);
+  vector<uint64_t> slots;
+  encoder->decode(answer, slots);
+  answers.assign(slots.begin(), slots.end());
+}
+
+int TreeInferenceClient::decode_label(int answer) {
+  if (answer > int(plain_mod / 2))
+    answer = answer - plain_mod;
+  return round(answer * 1.0 / scale_for_decimal_part);
+}
@@ -19,12 +19,26 @@ using namespace seal;
 #include "../Networking/PlayerBuffer.h"
 #include "../Tools/int.h"
 #include "Tools/TimerWithComm.h"
+#include "Tools/WaitQueue.h"
+
+#include <deque>
+#include <thread>
 
 
 const size_t poly_modulus_degree = 8192;
 const uint64_t plain_modulus = 1024; // 满足十分类
 const int scale_for_decimal_part = 100;
 const int value_max_threhold = 10;
+// batched mode needs a prime plaintext modulus that is 1 modulo 2 * poly_modulus_degree
+const int batching_plain_modulus_bits = 20;
+
+/**
+ * BFV parameters shared by client and server. In batched mode, every
+ * ciphertext carries the same one-hot position of up to
+ * ``poly_modulus_degree`` queries, one per slot, and constants such as the
+ * leaf labels are broadcast to all slots as constant polynomials.
+ */
+EncryptionParameters tree_inference_parameters(bool batched);
 
 class EncryptedSample{
 public:
@@ -42,6 +56,9 @@ public:
   Ciphertext get_final_result();
 };
 
+// evaluation state of one query, freed as a whole after the query
+typedef deque<PredictValue> PredictArena;
+
 class Node{
 public:
   Node(int feature_id, int value, bool is_leaf);
@@ -51,7 +68,7 @@ public:
   bool is_leaf;
   Node* left_child_node = nullptr;
   Node* right_child_node = nullptr;
-  PredictValue* predict(vector<vector<Ciphertext> > &features_vector);
+  PredictValue* predict(vector<vector<Ciphertext> > &features_vector, PredictArena &arena);
 };
 
 class TreeInferenceServer {
@@ -65,15 +82,27 @@ public:
   int test_sample_number;
   RealTwoPartyPlayer* player;
 
+  bool batched;
+  uint64_t plain_mod;
+  // queries per round trip
+  int batch_size;
+  int n_threads;
+  // queries received but not answered yet
+  int max_in_flight;
 
   vector<Node*> roots;
 
 
 
-  TreeInferenceServer();
+  TreeInferenceServer(bool batched = false, int n_threads = 0);
   void start_networking(ez::ezOptionParser& opt);
   void recv_single_query(vector<vector<Ciphertext> > &features_vector);
-  Ciphertext process_single_query(vector<vector<Ciphertext> > &features_vector);
+  Ciphertext process_single_query(vector<vector<Ciphertext> > &features_vector, int n_parts = 1);
+  Ciphertext process_trees(vector<vector<Ciphertext> > &features_vector, int part, int n_parts);
+  void recv_queries(int n_queries, WaitQueue<pair<int, int> > &free_slots,
+      WaitQueue<pair<int, int> > &queries, vector<EncryptedSample> &slots);
+  void evaluate_queries(WaitQueue<pair<int, int> > &queries,
+      WaitQueue<pair<int, int> > &answers, vector<EncryptedSample> &slots, int n_parts);
   void expend_index();
   void read_tree_structure();
   void run();
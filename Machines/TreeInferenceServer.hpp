@@ -7,6 +7,7 @@
 
 #include "TreeInferenceServer.h"
 #include <cmath>
+#include <map>
 
 RelinKeys* relin_keys;
 PublicKey* public_key;
@@ -53,13 +54,14 @@ Node::Node(int feature_id, int value, bool is_leaf) {
 
 
 
-PredictValue *Node::predict(vector<vector<Ciphertext> > &features_vector) {
-  PredictValue* predict_value = new PredictValue();
+PredictValue *Node::predict(vector<vector<Ciphertext> > &features_vector, PredictArena &arena) {
+  arena.emplace_back();
+  PredictValue* predict_value = &arena.back();
   if (!is_leaf){
     if (this->left_child_node != nullptr)
-      predict_value->left_value = this->left_child_node->predict(features_vector);
+      predict_value->left_value = this->left_child_node->predict(features_vector, arena);
     if (this->right_child_node != nullptr)
-      predict_value->right_value = this->right_child_node->predict(features_vector);
+      predict_value->right_value = this->right_child_node->predict(features_vector, arena);
 
     if (max_values[feature_id] < value_max_threhold){
       vector<Ciphertext> feature_prefix_sum = features_vector[feature_id];
@@ -112,12 +114,30 @@ PredictValue *Node::predict(vector<vector<Ciphertext> > &features_vector) {
 }
 
 
-TreeInferenceServer::TreeInferenceServer() {
+EncryptionParameters tree_inference_parameters(bool batched) {
   EncryptionParameters parms(scheme_type::bfv);
   parms.set_poly_modulus_degree(poly_modulus_degree);
   parms.set_coeff_modulus(CoeffModulus::BFVDefault(poly_modulus_degree));
-  parms.set_plain_modulus(plain_modulus);
+  if (batched)
+    parms.set_plain_modulus(PlainModulus::Batching(poly_modulus_degree,
+        batching_plain_modulus_bits));
+  else
+    parms.set_plain_modulus(plain_modulus);
+  return parms;
+}
+
+
+TreeInferenceServer::TreeInferenceServer(bool batched, int n_threads) :
+    batched(batched), n_threads(n_threads) {
+  if (this->n_threads <= 0)
+    this->n_threads = max(1u, thread::hardware_concurrency());
+  max_in_flight = 2 * this->n_threads;
+  EncryptionParameters parms = tree_inference_parameters(batched);
+  plain_mod = parms.plain_modulus().value();
   context = new SEALContext(parms);
+  if (batched and not context->first_context_data()->qualifiers().using_batching)
+    throw runtime_error("BFV parameters do not support batching");
+  batch_size = batched ? poly_modulus_degree : 1;
   evaluator = new Evaluator(*context);
 }
 
@@ -161,24 +181,54 @@ void TreeInferenceServer::send_single_answer(Ciphertext &answer) {
 
 void TreeInferenceServer::run() {
   read_tree_structure_and_feature_info();
+  if (roots.empty())
+    throw runtime_error("no trees to evaluate");
   recv_keys();
   timer.start(player->total_comm());
 
-  vector<EncryptedSample> samples;
-  cout << "receiving queries" << endl;
-  for (int i = 0; i < test_sample_number; i++){
-    EncryptedSample sample;
-    recv_single_query(sample.features_vector);
-    samples.push_back(sample);
-  }
-  cout << "processing queries" << endl;
-  for (int i = 0; i < test_sample_number; i++){
-    samples[i].label = process_single_query(samples[i].features_vector);
-  }
-  for (int i = 0; i < test_sample_number; i++){
-    send_single_answer(samples[i].label);
+  // one query per slot in batched mode
+  int n_batches = DIV_CEIL(test_sample_number, batch_size);
+  // split the trees of a query if there are fewer queries than threads
+  int n_parts = max(1, n_threads / max(1, n_batches));
+  int n_evaluators = min(n_threads, n_batches);
+
+  // receiving, evaluation and sending overlap, and at most max_in_flight
+  // queries are held in memory
+  vector<EncryptedSample> slots(max_in_flight);
+  WaitQueue<pair<int, int> > free_slots, queries, answers;
+  for (int i = 0; i < max_in_flight; i++)
+    free_slots.push({-1, i});
+
+  thread receiver(&TreeInferenceServer::recv_queries, this, n_batches,
+      ref(free_slots), ref(queries), ref(slots));
+  vector<thread> evaluators;
+  for (int i = 0; i < n_evaluators; i++)
+    evaluators.push_back(thread(&TreeInferenceServer::evaluate_queries, this,
+        ref(queries), ref(answers), ref(slots), n_parts));
+
+  // answers are sent in query order
+  map<int, int> done;
+  int next = 0;
+  while (next < n_batches){
+    auto answer = answers.pop();
+    done[answer.first] = answer.second;
+    while (done.count(next)){
+      int slot = done[next];
+      send_single_answer(slots[slot].label);
+      slots[slot].features_vector.clear();
+      free_slots.push({-1, slot});
+      done.erase(next++);
+    }
   }
 
+  // stop the evaluators only after the last query because the queue is
+  // first in, first out
+  receiver.join();
+  for (int i = 0; i < n_evaluators; i++)
+    queries.push({-1, -1});
+  for (auto& evaluator : evaluators)
+    evaluator.join();
+
   timer.stop(player->total_comm());
   cout << "Server total time = " << timer.elapsed() << " seconds" << endl;
   cout << "Server data sent = " << timer.mb_sent() << " MB";
@@ -222,18 +272,56 @@ void TreeInferenceServer::recv_single_query(vector<vector<Ciphertext> > &feature
   }
 }
 
-Ciphertext TreeInferenceServer::process_single_query(vector<vector<Ciphertext> > &features_vector) {
-
-  int tree_number = roots.size();
+void TreeInferenceServer::recv_queries(int n_queries, WaitQueue<pair<int, int> > &free_slots,
+    WaitQueue<pair<int, int> > &queries, vector<EncryptedSample> &slots) {
+  for (int i = 0; i < n_queries; i++){
+    int slot = free_slots.pop().second;
+    recv_single_query(slots[slot].features_vector);
+    queries.push({i, slot});
+  }
+}
 
-  PredictValue* root_values[tree_number];
-  for (int i = 0; i < tree_number; i++){
-    root_values[i] = roots[i]->predict(features_vector);
+void TreeInferenceServer::evaluate_queries(WaitQueue<pair<int, int> > &queries,
+    WaitQueue<pair<int, int> > &answers, vector<EncryptedSample> &slots, int n_parts) {
+  while (true){
+    auto query = queries.pop();
+    if (query.first < 0)
+      return;
+    EncryptedSample& sample = slots[query.second];
+    sample.label = process_single_query(sample.features_vector, n_parts);
+    answers.push(query);
+  }
+}
 
+Ciphertext TreeInferenceServer::process_single_query(vector<vector<Ciphertext> > &features_vector, int n_parts) {
+  n_parts = min(n_parts, int(roots.size()));
+  vector<Ciphertext> partial_answers(n_parts);
+  vector<thread> threads;
+  for (int i = 1; i < n_parts; i++)
+    threads.push_back(thread([&, i]() {
+      partial_answers[i] = process_trees(features_vector, i, n_parts);
+    }));
+  partial_answers[0] = process_trees(features_vector, 0, n_parts);
+  for (auto& t : threads)
+    t.join();
+
+  Ciphertext answer = partial_answers[0];
+  for (int i = 1; i < n_parts; i++){
+    evaluator->add_inplace(answer, partial_answers[i]);
   }
-  Ciphertext answer = root_values[0]->get_final_result();
-  for (int i = 1; i < tree_number; i++){
-    evaluator->add_inplace(answer, root_values[i]->get_final_result());
+
+  return answer;
+}
+
+Ciphertext TreeInferenceServer::process_trees(vector<vector<Ciphertext> > &features_vector, int part, int n_parts) {
+  Ciphertext answer;
+  for (size_t i = part; i < roots.size(); i += n_parts){
+    PredictArena arena;
+    PredictValue* root_value = roots[i]->predict(features_vector, arena);
+    if (i == size_t(part))
+      answer = root_value->get_final_result();
+    else
+      evaluator->add_inplace(answer, root_value->get_final_result());
   }
 
   return answer;
@@ -310,7 +398,7 @@ void TreeInferenceServer::read_tree_structure_and_feature_info() {
         if (node_id < 0)
             continue;
         int scale_label = round(label*scale_for_decimal_part);
-        scale_label = (scale_label + plain_modulus) % plain_modulus;
+        scale_label = (scale_label + plain_mod) % plain_mod;
         Node* node = new Node(attr_id, scale_label, true);
         node_of_current_layer[node_id] = node;
       }
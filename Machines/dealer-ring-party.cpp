@@ -6,6 +6,7 @@
 #include "Protocols/DealerShare.h"
 #include "Protocols/DealerInput.h"
 #include "Protocols/Dealer.h"
+#include "Protocols/DealerFss.h"
 
 #include "Processor/RingMachine.hpp"
 #include "Processor/Machine.hpp"
@@ -14,6 +15,7 @@
 #include "Protocols/DealerInput.hpp"
 #include "Protocols/DealerMC.hpp"
 #include "Protocols/DealerMatrixPrep.hpp"
+#include "Protocols/DealerFss.hpp"
 #include "Protocols/Beaver.hpp"
 #include "Protocols/SemiInput.hpp"
 #include "Protocols/MAC_Check_Base.hpp"
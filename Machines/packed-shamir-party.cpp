@@ -0,0 +1,19 @@
+/*
+ * packed-shamir-party.cpp
+ *
+ */
+
+#include "Machines/ShamirMachine.h"
+#include "Protocols/PackedShamirShare.h"
+
+#include "PackedShamir.hpp"
+
+int main(int argc, const char** argv)
+{
+    auto& opts = ShamirOptions::singleton;
+    ez::ezOptionParser opt;
+    opts = {opt, argc, argv};
+    PackedShamirOptions::singleton = {opt, argc, argv};
+    HonestMajorityFieldMachine<PackedShamirShare>(argc, argv, opt,
+            opts.nparties);
+}
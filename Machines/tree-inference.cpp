@@ -68,6 +68,24 @@ void parse_argv(int argc, const char** argv){
           "-ip", // Flag token.
           "--ip-file-name" // Flag token.
   );
+  opt.add(
+          "", // Default.
+          0, // Required?
+          0, // Number of args expected.
+          0, // Delimiter if expecting multiple args.
+          "Pack one query per plaintext slot (both parties must use this)", // Help description.
+          "-b", // Flag token.
+          "--batched" // Flag token.
+  );
+  opt.add(
+          "0", // Default.
+          0, // Required?
+          1, // Number of args expected.
+          0, // Delimiter if expecting multiple args.
+          "Number of evaluation threads on the server (default: number of cores)", // Help description.
+          "-t", // Flag token.
+          "--threads" // Flag token.
+  );
   opt.parse(argc, argv);
   if (opt.isSet("-p"))
     opt.get("-p")->getInt(playerno);
@@ -106,13 +124,16 @@ void parse_argv(int argc, const char** argv){
 int main(int argc, const char** argv){
    parse_argv(argc, argv);
 
+   bool batched = opt.isSet("--batched");
    if (playerno == 0){
-     TreeInferenceServer server;
+     int n_threads;
+     opt.get("--threads")->getInt(n_threads);
+     TreeInferenceServer server(batched, n_threads);
      server.start_networking(opt);
      server.run();
    }
   else{
-    TreeInferenceClient client;
+    TreeInferenceClient client(batched);
     client.start_networking(opt);
     client.run();
   }
@@ -0,0 +1,416 @@
+/*
+ * FieldKernels.h
+ *
+ */
+
+#ifndef MATH_FIELDKERNELS_H_
+#define MATH_FIELDKERNELS_H_
+
+#include "Math/gfp.h"
+#include "Tools/Exceptions.h"
+
+#include <type_traits>
+
+/**
+ * Montgomery arithmetic on eight elements of ``gfp_<X, L>`` at a time with
+ * AVX-512 IFMA. The ``L`` 64-bit limbs of an element are split into
+ * ``N`` 52-bit digits, one vector per digit. ``Zp_Data`` uses
+ * ``R = 2^(64 L)`` whereas the digit-wise reduction divides by
+ * ``2^(52 N)``, so one operand is shifted up by the difference before
+ * multiplying, which leaves the product in the representation of
+ * ``Zp_Data`` without further correction.
+ */
+template<int L>
+class Mont52
+{
+#ifdef __AVX512IFMA__
+    typedef __m512i V;
+
+    static const int N = (64 * L + 51) / 52;
+    static const int SHIFT = 52 * N - 64 * L;
+    // columns of the double-length product plus one for lazy sums
+    static const int N_COLUMNS = 2 * N + 1;
+    // batches of products that fit the 64-bit columns between carries
+    static const int LAZY_BATCHES = 128;
+
+    const Zp_Data& ZpD;
+    V p[N], p_inv, mask, zero;
+
+    static V shift_left(V x, int n)
+    {
+        return _mm512_sll_epi64(x, _mm_cvtsi32_si128(n));
+    }
+
+    static V shift_right(V x, int n)
+    {
+        return _mm512_srl_epi64(x, _mm_cvtsi32_si128(n));
+    }
+
+    static V lanes(size_t start, size_t step)
+    {
+        long long x = start * step, s = step;
+        return _mm512_set_epi64(x + 7 * s, x + 6 * s, x + 5 * s, x + 4 * s,
+                x + 3 * s, x + 2 * s, x + s, x);
+    }
+
+    static __mmask8 active(size_t start, size_t n)
+    {
+        return n - start >= 8 ? 0xFF : (1 << (n - start)) - 1;
+    }
+
+    // split limbs into digits, shifting up by ``shift`` bits
+    void split(V (&res)[N], const V (&limbs)[L], int shift) const
+    {
+        for (int k = 0; k < N; k++)
+        {
+            int start = 52 * k - shift;
+            V digit;
+            if (start < 0)
+                digit = shift_left(limbs[0], -start);
+            else
+            {
+                int w = start / 64, offset = start % 64;
+                digit = shift_right(limbs[w], offset);
+                if (offset > 12 and w + 1 < L)
+                    digit = _mm512_or_si512(digit,
+                            shift_left(limbs[w + 1], 64 - offset));
+            }
+            res[k] = _mm512_and_si512(digit, mask);
+        }
+    }
+
+    void load(V (&res)[N], const uint64_t* base, V index, __mmask8 lanes,
+            int shift) const
+    {
+        V limbs[L];
+        for (int l = 0; l < L; l++)
+            limbs[l] = _mm512_mask_i64gather_epi64(zero, lanes,
+                    _mm512_add_epi64(index, _mm512_set1_epi64(l)),
+                    (const long long*) base, 8);
+        split(res, limbs, shift);
+    }
+
+    // digits have to be normalized and the value below 2^(64 L)
+    void store(uint64_t* base, V index, __mmask8 lanes,
+            const V (&digits)[N]) const
+    {
+        for (int l = 0; l < L; l++)
+        {
+            V limb = zero;
+            for (int k = 0; k < N; k++)
+            {
+                int offset = 52 * k - 64 * l;
+                if (offset >= 0 and offset < 64)
+                    limb = _mm512_or_si512(limb,
+                            shift_left(digits[k], offset));
+                else if (offset < 0 and offset > -52)
+                    limb = _mm512_or_si512(limb,
+                            shift_right(digits[k], -offset));
+            }
+            _mm512_mask_i64scatter_epi64((long long*) base, lanes,
+                    _mm512_add_epi64(index, _mm512_set1_epi64(l)), limb, 8);
+        }
+    }
+
+    void multiply_add(V (&C)[N_COLUMNS], const V (&a)[N],
+            const V (&b)[N]) const
+    {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+            {
+                C[i + j] = _mm512_madd52lo_epu64(C[i + j], a[i], b[j]);
+                C[i + j + 1] = _mm512_madd52hi_epu64(C[i + j + 1], a[i], b[j]);
+            }
+    }
+
+    void carry(V (&C)[N_COLUMNS]) const
+    {
+        for (int k = 0; k < N_COLUMNS - 1; k++)
+        {
+            C[k + 1] = _mm512_add_epi64(C[k + 1], _mm512_srli_epi64(C[k], 52));
+            C[k] = _mm512_and_si512(C[k], mask);
+        }
+    }
+
+    // divide by 2^(52 N) modulo p, the result is in C[N..2N]
+    void reduce(V (&C)[N_COLUMNS]) const
+    {
+        for (int i = 0; i < N; i++)
+        {
+            V m = _mm512_madd52lo_epu64(zero, C[i], p_inv);
+            for (int j = 0; j < N; j++)
+            {
+                C[i + j] = _mm512_madd52lo_epu64(C[i + j], m, p[j]);
+                C[i + j + 1] = _mm512_madd52hi_epu64(C[i + j + 1], m, p[j]);
+            }
+            C[i + 1] = _mm512_add_epi64(C[i + 1], _mm512_srli_epi64(C[i], 52));
+        }
+    }
+
+    // fully reduced digits from a result below 2p
+    void finalize(V (&res)[N], const V (&C)[N_COLUMNS]) const
+    {
+        V carry = zero, borrow = zero, diff[N];
+        for (int k = 0; k < N; k++)
+        {
+            V x = _mm512_add_epi64(C[N + k], carry);
+            res[k] = _mm512_and_si512(x, mask);
+            carry = _mm512_srli_epi64(x, 52);
+            x = _mm512_add_epi64(_mm512_sub_epi64(res[k], p[k]), borrow);
+            diff[k] = _mm512_and_si512(x, mask);
+            borrow = _mm512_srai_epi64(x, 52);
+        }
+        __mmask8 not_below = _mm512_cmpeq_epi64_mask(borrow, zero);
+        for (int k = 0; k < N; k++)
+            res[k] = _mm512_mask_mov_epi64(res[k], not_below, diff[k]);
+    }
+
+public:
+    static bool usable(const Zp_Data& ZpD)
+    {
+        return L > 1 and L <= 4 and ZpD.get_mont() and ZpD.get_t() == L;
+    }
+
+    Mont52(const Zp_Data& ZpD) :
+            ZpD(ZpD)
+    {
+        mask = _mm512_set1_epi64((1ll << 52) - 1);
+        zero = _mm512_setzero_si512();
+        V limbs[L];
+        for (int l = 0; l < L; l++)
+            limbs[l] = _mm512_set1_epi64(ZpD.get_prA()[l]);
+        split(p, limbs, 0);
+        // -p^-1 modulo 2^64 by Newton iteration
+        uint64_t inverse = 1, p0 = ZpD.get_prA()[0];
+        for (int i = 0; i < 6; i++)
+            inverse *= 2 - p0 * inverse;
+        p_inv = _mm512_set1_epi64(-inverse & ((1ll << 52) - 1));
+    }
+
+    /// ``dest[i] = x[i] * y[(i / m) * y_step]`` for ``n`` elements
+    void mul(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+            size_t n, int m, int y_step) const
+    {
+        long long y_index[8] __attribute__((aligned(64)));
+        for (size_t i = 0; i < n; i += 8)
+        {
+            auto in_use = active(i, n);
+            for (int j = 0; j < 8; j++)
+                y_index[j] = (i + j) / m * y_step * L;
+            V a[N], b[N], C[N_COLUMNS], res[N];
+            load(a, x, lanes(i, L), in_use, SHIFT);
+            load(b, y, _mm512_load_si512(y_index), in_use, 0);
+            for (auto& c : C)
+                c = zero;
+            multiply_add(C, a, b);
+            reduce(C);
+            finalize(res, C);
+            store(dest, lanes(i, L), in_use, res);
+        }
+    }
+
+    /// ``sum_i x[i] * y[i]`` reduced only once per lane
+    void inner_product(uint64_t* res, const uint64_t* x, const uint64_t* y,
+            size_t n) const
+    {
+        V C[N_COLUMNS];
+        for (auto& c : C)
+            c = zero;
+        for (size_t i = 0; i < n; i += 8)
+        {
+            V a[N], b[N];
+            load(a, x, lanes(i, L), active(i, n), SHIFT);
+            load(b, y, lanes(i, L), active(i, n), 0);
+            multiply_add(C, a, b);
+            if (i / 8 % LAZY_BATCHES == LAZY_BATCHES - 1)
+                carry(C);
+        }
+        carry(C);
+        reduce(C);
+
+        // the lanes hold at most n multiples of p each
+        const int M = L + 2;
+        mp_limb_t sum[M] = {}, q[M];
+        uint64_t digits[N + 1][8];
+        for (int k = 0; k <= N; k++)
+            _mm512_storeu_si512(digits[k], C[N + k]);
+        for (int j = 0; j < 8; j++)
+            for (int k = 0; k <= N; k++)
+            {
+                int w = 52 * k / 64, offset = 52 * k % 64;
+                uint64_t digit = digits[k][j];
+                mpn_add_1(sum + w, sum + w, M - w, digit << offset);
+                if (offset)
+                    mpn_add_1(sum + w + 1, sum + w + 1, M - w - 1,
+                            digit >> (64 - offset));
+            }
+        mpn_tdiv_qr(q, res, 0, sum, M, ZpD.get_prA(), L);
+    }
+#else
+public:
+    static bool usable(const Zp_Data&)
+    {
+        return false;
+    }
+
+    Mont52(const Zp_Data&)
+    {
+    }
+
+    void mul(uint64_t*, const uint64_t*, const uint64_t*, size_t, int,
+            int) const
+    {
+        throw not_implemented();
+    }
+
+    void inner_product(uint64_t*, const uint64_t*, const uint64_t*,
+            size_t) const
+    {
+        throw not_implemented();
+    }
+#endif
+};
+
+template<class T>
+class gfp_limbs
+{
+public:
+    static const int N_LIMBS = 1;
+
+    static bool usable()
+    {
+        return false;
+    }
+
+    static const Zp_Data& get_ZpD()
+    {
+        throw not_implemented();
+    }
+};
+
+template<int X, int L>
+class gfp_limbs<gfp_<X, L>>
+{
+public:
+    static const int N_LIMBS = L;
+
+    static bool usable()
+    {
+        return Mont52<L>::usable(get_ZpD());
+    }
+
+    static const Zp_Data& get_ZpD()
+    {
+        return gfp_<X, L>::get_ZpD();
+    }
+};
+
+/**
+ * Vector kernels for field values ``T`` and shares thereof. Prime
+ * fields of two to four limbs use ``Mont52`` if the CPU supports it,
+ * everything else falls back to element-wise arithmetic.
+ */
+template<class T>
+class FieldKernels
+{
+    typedef Mont52<gfp_limbs<T>::N_LIMBS> K;
+
+    static uint64_t* limbs(void* x) { return (uint64_t*) x; }
+    static const uint64_t* limbs(const void* x) { return (const uint64_t*) x; }
+
+    static K kernel()
+    {
+        return K(gfp_limbs<T>::get_ZpD());
+    }
+
+    // the batches read eight elements ahead of writing
+    template<class U, class W>
+    static bool safe_to_batch(const U* dest, const W* x, size_t size)
+    {
+        return (void*) dest <= (void*) x or (void*) dest >= (void*) (x + size);
+    }
+
+    // shares that consist of values in T only
+    template<class U>
+    static bool native_share()
+    {
+        return native() and is_same<typename U::clear, T>::value
+                and not U::packed
+                and (not U::has_mac
+                        or is_same<typename U::mac_type, T>::value)
+                and sizeof(U) % sizeof(T) == 0;
+    }
+
+public:
+    static bool native()
+    {
+        return gfp_limbs<T>::usable();
+    }
+
+    /// ``dest = x * y`` element-wise
+    static void mul(T* dest, const T* x, const T* y, size_t size)
+    {
+        if (native() and safe_to_batch(dest, x, size)
+                and safe_to_batch(dest, y, size))
+            kernel().mul(limbs(dest), limbs(x), limbs(y), size, 1, 1);
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y[i];
+    }
+
+    /// ``dest = x * y`` for a single ``y``
+    static void mul(T* dest, const T* x, const T& y, size_t size)
+    {
+        if (native() and safe_to_batch(dest, x, size)
+                and safe_to_batch(dest, &y, 1))
+            kernel().mul(limbs(dest), limbs(x), limbs(&y), size, 1, 0);
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y;
+    }
+
+    /// ``dest = x * y`` element-wise for shares ``x``
+    template<class U>
+    static void mul(U* dest, const U* x, const T* y, size_t size)
+    {
+        const int m = sizeof(U) / sizeof(T);
+        if (native_share<U>() and safe_to_batch(dest, x, size)
+                and safe_to_batch(dest, y, size))
+            kernel().mul(limbs(dest), limbs(x), limbs(y), size * m,
+                    m, 1);
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y[i];
+    }
+
+    /// ``dest = x * y`` for shares ``x`` and a single ``y``
+    template<class U>
+    static void mul(U* dest, const U* x, const T& y, size_t size)
+    {
+        const int m = sizeof(U) / sizeof(T);
+        if (native_share<U>() and safe_to_batch(dest, x, size))
+            kernel().mul(limbs(dest), limbs(x), limbs(&y), size * m,
+                    1, 0);
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y;
+    }
+
+    /// ``sum_i x[i] * y[i]``
+    template<class U, class V>
+    static T inner_product(const U* x, const V* y, size_t size)
+    {
+        T res;
+        if (native() and is_same<U, T>::value and is_same<V, T>::value)
+        {
+            // raw copy so that this compiles for non-field types too
+            kernel().inner_product(limbs(&res), limbs(x), limbs(y), size);
+        }
+        else
+            for (size_t i = 0; i < size; i++)
+                res += x[i] * y[i];
+        return res;
+    }
+};
+
+#endif /* MATH_FIELDKERNELS_H_ */
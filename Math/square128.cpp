@@ -139,6 +139,31 @@ inline void square32::transpose(square128& output, int x, int y)
 }
 #endif
 
+#ifdef __AVX512BW__
+union matrix64x8
+{
+    __m512i whole;
+
+    matrix64x8(__m256i low, __m256i high) :
+            whole(_mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1))
+    {
+    }
+
+    void transpose(square128& output, int x, int y);
+};
+
+UNROLL_LOOPS
+inline void matrix64x8::transpose(square128& output, int x, int y)
+{
+    for (int j = 0; j < 8; j++)
+    {
+        __mmask64 row = _mm512_movepi8_mask(whole);
+        whole = _mm512_slli_epi64(whole, 1);
+        output.dwords[8*x+7-j][y] = row;
+    }
+}
+#endif
+
 #ifdef __AVX2__
 typedef square32 subsquare;
 #define N_SUBSQUARES 4
@@ -232,8 +257,15 @@ void square128::transpose()
 
     for (int i = 0; i < 16; i++)
     {
+#ifdef __AVX512BW__
+        // two 32-bit columns at once
+        for (int k = 0; k < 2; k++)
+            matrix64x8(tmp.doublerows[2 * k * 16 + i],
+                    tmp.doublerows[(2 * k + 1) * 16 + i]).transpose(*this, i, k);
+#else
         for (int k = 0; k < 4; k++)
             matrix32x8(tmp.doublerows[k * 16 + i]).transpose(*this, i, k);
+#endif
     }
 #else // __AVX2__
     square128 tmp;
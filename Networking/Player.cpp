@@ -688,16 +688,22 @@ RealTwoPartyPlayer::~RealTwoPartyPlayer()
 void VirtualTwoPartyPlayer::send(octetStream& o) const
 {
   VirtualTwoPartyPlayer_Round++;
-  TimeScope ts(comm_stats["Sending one-to-one"].add(o));
-  P.send_to_no_stats(other_player, o);
+  // allow sending and receiving in different threads
+  lock.lock();
+  Timer& send_timer = comm_stats["Sending one-to-one"].add(o);
   comm_stats.sent += o.get_length();
+  lock.unlock();
+  TimeScope ts(send_timer);
+  P.send_to_no_stats(other_player, o);
 }
 
 void VirtualTwoPartyPlayer::receive(octetStream& o) const
 {
   TimeScope ts(timer);
   P.receive_player_no_stats(other_player, o);
+  lock.lock();
   comm_stats["Receiving one-to-one"].add(o, ts);
+  lock.unlock();
 }
 
 void VirtualTwoPartyPlayer::send_receive_player(vector<octetStream>& o) const
@@ -789,6 +795,14 @@ NamedCommStats NamedCommStats::operator -(const NamedCommStats& other) const
   return res;
 }
 
+size_t NamedCommStats::total_rounds() const
+{
+  size_t res = 0;
+  for (auto& x : *this)
+    res += x.second.rounds;
+  return res;
+}
+
 void NamedCommStats::print(bool newline)
 {
   for (auto it = begin(); it != end(); it++)
@@ -819,5 +833,16 @@ NamedCommStats Player::total_comm() const
   return res;
 }
 
+void Player::comm_counters(size_t& sent, size_t& rounds) const
+{
+  sent = comm_stats.sent;
+  rounds = comm_stats.total_rounds();
+  for (auto& x : thread_stats)
+    {
+      sent += x.sent;
+      rounds += x.total_rounds();
+    }
+}
+
 template class MultiPlayer<int>;
 template class MultiPlayer<ssl_socket*> ;
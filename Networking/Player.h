@@ -172,6 +172,7 @@ public:
   NamedCommStats& operator+=(const NamedCommStats& other);
   NamedCommStats operator+(const NamedCommStats& other) const;
   NamedCommStats operator-(const NamedCommStats& other) const;
+  size_t total_rounds() const;
   void print(bool newline = false);
   void reset();
 #ifdef VERBOSE_COMM
@@ -404,6 +405,8 @@ public:
   { receive_player(i, o); }
 
   NamedCommStats total_comm() const;
+  // same totals as total_comm() without copying
+  void comm_counters(size_t& sent, size_t& rounds) const;
 };
 
 /**
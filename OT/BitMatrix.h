@@ -40,6 +40,7 @@ union square128 {
     octet bytes[128][16];
     int16_t doublebytes[128][8];
     int32_t words[128][4];
+    int64_t dwords[128][2];
 
     bool get_bit(int x, int y)
     { return (bytes[x][y/8] >> (y % 8)) & 1; }
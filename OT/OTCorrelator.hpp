@@ -24,7 +24,7 @@ void OTCorrelator<U>::resize(int nOTs)
 }
 
 template <class U>
-void OTCorrelator<U>::expand(int start, int slice)
+void OTCorrelator<U>::expand(int start, int slice, int begin_row, int end_row)
 {
     (void)start, (void)slice;
     Slice<U> receiverOutputSlice(receiverOutputMatrix, start, slice);
@@ -34,10 +34,13 @@ void OTCorrelator<U>::expand(int start, int slice)
     };
     Slice<U> t1Slice(t1, start, slice);
 
+    if (end_row < 0)
+        end_row = nbaseOTs;
+
     // expand with PRG
     if (ot_role & RECEIVER)
     {
-        for (int i = 0; i < nbaseOTs; i++)
+        for (int i = begin_row; i < end_row; i++)
         {
             receiverOutputSlice.randomize(i, G_sender[i][0]);
             t1Slice.randomize(i, G_sender[i][1]);
@@ -46,7 +49,7 @@ void OTCorrelator<U>::expand(int start, int slice)
 
     if (ot_role & SENDER)
     {
-        for (int i = 0; i < nbaseOTs; i++)
+        for (int i = begin_row; i < end_row; i++)
             // randomize base receiver output
             senderOutputSlices[0].randomize(i, G_receiver[i]);
     }
@@ -129,7 +132,6 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs, vector<V>& senderOutput,
         V& receiverOutput, bool correlated)
 {
     //cout << "Hashing... " << flush;
-    MMO mmo;
 #ifdef OTEXT_TIMER
     timeval startv, endv;
     gettimeofday(&startv, NULL);
@@ -144,36 +146,41 @@ void OTExtensionWithMatrix::hash_outputs(int nOTs, vector<V>& senderOutput,
     if (nOTs % 8 != 0)
         throw runtime_error("number of OTs must be divisible by 8");
 
-    for (int i = 0; i < nOTs; i += 8)
+    // blocks of eight OTs are independent
+    run_local(nOTs / 8, [&](int begin, int end)
     {
-        int i_outer_input = i / 128;
-        int i_inner_input = i % 128;
-        int i_outer_output = i / n_rows;
-        int i_inner_output = i % n_rows;
-        if (ot_role & SENDER)
+        MMO mmo;
+        for (int i = 8 * begin; i < 8 * end; i += 8)
         {
-            int128 tmp[2][8];
-            for (int j = 0; j < 8; j++)
+            int i_outer_input = i / 128;
+            int i_inner_input = i % 128;
+            int i_outer_output = i / n_rows;
+            int i_inner_output = i % n_rows;
+            if (ot_role & SENDER)
             {
-                tmp[0][j] = senderOutputMatrices[0].squares[i_outer_input].rows[i_inner_input + j];
-                if (correlated)
-                    tmp[1][j] = tmp[0][j] ^ baseReceiverInput.get_int128(0);
-                else
-                    tmp[1][j] =
-                            senderOutputMatrices[1].squares[i_outer_input].rows[i_inner_input + j];
+                int128 tmp[2][8];
+                for (int j = 0; j < 8; j++)
+                {
+                    tmp[0][j] = senderOutputMatrices[0].squares[i_outer_input].rows[i_inner_input + j];
+                    if (correlated)
+                        tmp[1][j] = tmp[0][j] ^ baseReceiverInput.get_int128(0);
+                    else
+                        tmp[1][j] =
+                                senderOutputMatrices[1].squares[i_outer_input].rows[i_inner_input + j];
+                }
+                for (int j = 0; j < 2; j++)
+                    mmo.hashEightBlocks(
+                            &senderOutput[j].squares[i_outer_output].rows[i_inner_output],
+                            &tmp[j]);
             }
-            for (int j = 0; j < 2; j++)
+            if (ot_role & RECEIVER)
+            {
                 mmo.hashEightBlocks(
-                        &senderOutput[j].squares[i_outer_output].rows[i_inner_output],
-                        &tmp[j]);
-        }
-        if (ot_role & RECEIVER)
-        {
-            mmo.hashEightBlocks(
-                    &receiverOutput.squares[i_outer_output].rows[i_inner_output],
-                    &receiverOutputMatrix.squares[i_outer_input].rows[i_inner_input]);
+                        &receiverOutput.squares[i_outer_output].rows[i_inner_output],
+                        &receiverOutputMatrix.squares[i_outer_input].rows[i_inner_input]);
+            }
         }
-    }
+    });
     //cout << "done.\n";
 #ifdef OTEXT_TIMER
     gettimeofday(&endv, NULL);
@@ -4,7 +4,11 @@
  */
 
 #include "OTExtensionWithMatrix.h"
+#include "SilentOT.h"
 #include "Tools/Bundle.h"
+#include "Tools/Worker.h"
+#include "Processor/LocalWorkers.h"
+#include "Processor/OnlineOptions.h"
 
 #ifndef USE_KOS
 #include "Networking/PlayerCtSocket.h"
@@ -34,6 +38,9 @@ OTExtensionWithMatrix::OTExtensionWithMatrix(BaseOT &baseOT, TwoPartyPlayer *pla
     G.ReSeed();
     nsubloops = 1;
     agreed = false;
+    silent = 0;
+    workers = 0;
+    n_requested = 0;
 #ifndef USE_KOS
     channel = 0;
 #endif
@@ -41,6 +48,10 @@ OTExtensionWithMatrix::OTExtensionWithMatrix(BaseOT &baseOT, TwoPartyPlayer *pla
 
 OTExtensionWithMatrix::~OTExtensionWithMatrix()
 {
+    if (silent)
+        delete silent;
+    if (workers)
+        delete workers;
 #ifndef USE_KOS
     if (channel)
         delete channel;
@@ -57,6 +68,9 @@ void OTExtensionWithMatrix::protocol_agreement()
     bundle.mine = string("KOS15");
 #else
     bundle.mine = string("SoftSpokenOT");
+#endif
+#ifdef USE_SILENT_OT
+    bundle.mine.store(string("Ferret"));
 #endif
     player->unchecked_broadcast(bundle);
 
@@ -67,9 +81,12 @@ void OTExtensionWithMatrix::protocol_agreement()
     catch (mismatch_among_parties &)
     {
         cerr << "Parties compiled with different OT extensions" << endl;
-        cerr << "Set \"USE_KOS\" to the same value on all parties" << endl;
+        cerr << "Set \"USE_KOS\" and \"USE_SILENT_OT\" to the same value "
+                "on all parties" << endl;
         exit(1);
     }
+
+    agreed = true;
 }
 
 void OTExtensionWithMatrix::transfer(int nOTs,
@@ -109,6 +126,15 @@ void OTExtensionWithMatrix::extend(int nOTs_requested, const BitVector &newRecei
 {
     protocol_agreement();
 
+#ifdef USE_SILENT_OT
+    if (passive_only)
+    {
+        extend_correlated(nOTs_requested, newReceiverInput);
+        hash_outputs(nOTs_requested);
+        return;
+    }
+#endif
+
 #ifdef USE_KOS
     extend_correlated(nOTs_requested, newReceiverInput);
     hash_outputs(nOTs_requested);
@@ -208,6 +234,40 @@ void OTExtensionWithMatrix::extend_correlated(const BitVector &newReceiverInput)
 }
 
 void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVector &newReceiverBits)
+{
+#ifdef USE_SILENT_OT
+    // LPN-based extension is only implemented for semi-honest security,
+    // and it only pays off once the requests exceed its reserve
+    if (passive_only)
+    {
+        if (nOTs_requested == 0)
+            return;
+        protocol_agreement();
+        n_requested += nOTs_requested;
+        if (not silent and n_requested > size_t(SilentOT::reserve()))
+        {
+            silent = new SilentOT(player, ot_role, baseReceiverInput);
+            BitVector choices(SilentOT::reserve());
+            choices.randomize(G);
+            extend_iknp(choices.size(), choices);
+            silent->bootstrap(senderOutputMatrices[0], receiverOutputMatrix,
+                    choices);
+        }
+    }
+
+    if (silent)
+    {
+        silent->extend(nOTs_requested, newReceiverBits);
+        swap(senderOutputMatrices[0], silent->senderOutputMatrices[0]);
+        swap(receiverOutputMatrix, silent->receiverOutputMatrix);
+        return;
+    }
+#endif
+
+    extend_iknp(nOTs_requested, newReceiverBits);
+}
+
+void OTExtensionWithMatrix::extend_iknp(int nOTs_requested, const BitVector &newReceiverBits)
 {
     //    if (nOTs % nbaseOTs != 0)
     //        throw invalid_length(); //"nOTs must be a multiple of nbaseOTs\n");
@@ -230,13 +290,16 @@ void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVecto
     for (int i = 0; i < 4; i++)
         newReceiverInput.set_word(nOTs / 64 - i - 1, G.get_word());
 
-    // subloop for first part to interleave communication with computation
-    for (int start = 0; start < nOTs / 128; start += slice)
-    {
-        expand(start, slice);
-        this->correlate(start, slice, newReceiverInput, true);
-        transpose(start, slice);
-    }
+    if (nsubloops == 1 and slice > PIPELINE_SLICE)
+        pipelined_correlate(nOTs, newReceiverInput);
+    else
+        // subloop for first part to interleave communication with computation
+        for (int start = 0; start < nOTs / 128; start += slice)
+        {
+            expand(start, slice);
+            this->correlate(start, slice, newReceiverInput, true);
+            transpose(start, slice);
+        }
 
 #ifdef OTEXT_TIMER
     double elapsed;
@@ -264,6 +327,94 @@ void OTExtensionWithMatrix::extend_correlated(int nOTs_requested, const BitVecto
     newReceiverInput.resize(nOTs_requested);
 }
 
+void OTExtensionWithMatrix::run_local(int n,
+        const function<void(int, int)> &range)
+{
+    int n_threads = OnlineOptions::singleton.local_threads;
+    if (not workers and n_threads > 1)
+        workers = new LocalWorkers(n_threads);
+    if (workers)
+        workers->run(n, range);
+    else
+        range(0, n);
+}
+
+class IknpExchange
+{
+public:
+    TwoPartyPlayer *player;
+    OT_ROLE role;
+    vector<octetStream> *os;
+
+    int run()
+    {
+        send_if_ot_receiver(player, *os, role);
+        return 0;
+    }
+};
+
+void OTExtensionWithMatrix::pipelined_correlate(int nOTs,
+                                                BitVector &newReceiverInput)
+{
+    // slice s is prepared in step s, in transit during step s + 1,
+    // and finished by the sender in step s + 2
+    int n_squares = nOTs / 128;
+    int n_slices = DIV_CEIL(n_squares, PIPELINE_SLICE);
+    vector<octetStream> os[3];
+    Worker<IknpExchange> network;
+    IknpExchange exchange = {player, ot_role, 0};
+
+    for (int step = 0; step < n_slices + 2; step++)
+    {
+        bool exchanging = step > 0 and step <= n_slices;
+        if (exchanging)
+        {
+            exchange.os = &os[(step - 1) % 3];
+            network.request(exchange);
+        }
+
+        if (step < n_slices)
+        {
+            int start = step * PIPELINE_SLICE;
+            int size = min(PIPELINE_SLICE, n_squares - start);
+            // the PRGs of different base OTs are independent
+            run_local(nbaseOTs, [&](int begin, int end)
+                      { expand(start, size, begin, end); });
+            auto &out = os[step % 3];
+            out.clear();
+            out.resize(2);
+            if (ot_role & RECEIVER)
+            {
+                run_local(size, [&](int begin, int end)
+                          {
+                    BitMatrixSlice receiverOutputSlice(receiverOutputMatrix,
+                            start + begin, end - begin);
+                    BitMatrixSlice t1Slice(t1, start + begin, end - begin);
+                    t1Slice.rsub(receiverOutputSlice);
+                    t1Slice.sub(newReceiverInput);
+                    receiverOutputSlice.transpose(); });
+                BitMatrixSlice(t1, start, size).pack(out[0]);
+            }
+        }
+
+        if (step >= 2 and (ot_role & SENDER))
+        {
+            int start = (step - 2) * PIPELINE_SLICE;
+            int size = min(PIPELINE_SLICE, n_squares - start);
+            BitMatrixSlice(u, start, size).unpack(os[(step - 2) % 3][1]);
+            run_local(size, [&](int begin, int end)
+                      {
+                BitMatrixSlice senderOutputSlice(senderOutputMatrices[0],
+                        start + begin, end - begin);
+                senderOutputSlice.conditional_add(baseReceiverInput, u);
+                senderOutputSlice.transpose(); });
+        }
+
+        if (exchanging)
+            network.done();
+    }
+}
+
 void OTExtensionWithMatrix::expand_transposed()
 {
     for (int i = 0; i < nbaseOTs; i++)
@@ -10,6 +10,8 @@
 #include "BitMatrix.h"
 #include "Math/gf2n.h"
 
+#include <functional>
+
 #ifndef USE_KOS
 namespace osuCrypto
 {
@@ -17,6 +19,9 @@ namespace osuCrypto
 }
 #endif
 
+class SilentOT;
+class LocalWorkers;
+
 template <class U>
 class OTCorrelator : public OTExtension
 {
@@ -39,7 +44,7 @@ public:
                                                                          receiverOutputMatrix(matrices[0]), t1(matrices[1]) {}
 
     void resize(int nOTs);
-    void expand(int start, int slice);
+    void expand(int start, int slice, int begin_row = 0, int end_row = -1);
     void setup_for_correlation(BitVector &baseReceiverInput,
                                vector<U> &baseSenderOutputs,
                                U &baseReceiverOutput);
@@ -61,8 +66,20 @@ class OTExtensionWithMatrix : public OTCorrelator<BitMatrix>
     osuCrypto::Channel *channel;
 #endif
 
+    SilentOT *silent;
+    LocalWorkers *workers;
+
+    // OTs requested before starting the LPN-based extension
+    size_t n_requested;
+
     bool agreed;
 
+    // squares per slice of the pipelined extension
+    static const int PIPELINE_SLICE = 256;
+
+    void run_local(int n, const function<void(int, int)> &range);
+    void pipelined_correlate(int nOTs, BitVector &newReceiverInput);
+
 public:
     PRNG G;
 
@@ -78,6 +95,9 @@ public:
     {
         G.ReSeed();
         agreed = false;
+        silent = 0;
+        workers = 0;
+        n_requested = 0;
 #ifndef USE_KOS
         channel = 0;
 #endif
@@ -93,6 +113,7 @@ public:
     void extend(int nOTs, const BitVector &newReceiverInput);
     void extend_correlated(const BitVector &newReceiverInput);
     void extend_correlated(int nOTs, const BitVector &newReceiverInput);
+    void extend_iknp(int nOTs, const BitVector &newReceiverInput);
     void transpose(int start = 0, int slice = -1);
     void expand_transposed();
     template <class V>
@@ -0,0 +1,292 @@
+/*
+ * SilentOT.cpp
+ *
+ */
+
+#include "SilentOT.h"
+
+SilentOT::Schedule::Schedule()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        octet key[AES_BLK_SIZE] = {};
+        key[0] = i;
+        key[1] = 'S';
+        aes_schedule(keys[i], key);
+    }
+}
+
+const SilentOT::Schedule& SilentOT::schedule()
+{
+    static Schedule res;
+    return res;
+}
+
+void SilentOT::hash(int128* out, const int128* in, size_t n, int key,
+        int128 tweak)
+{
+    auto& schedule = SilentOT::schedule().keys[key];
+    __m128i tmp[8], x[8];
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        for (int j = 0; j < 8; j++)
+            x[j] = in[i + j].a ^ tweak.a;
+        ecb_aes_128_encrypt<8>(tmp, x, schedule);
+        for (int j = 0; j < 8; j++)
+            out[i + j] = tmp[j] ^ x[j];
+    }
+    for (; i < n; i++)
+    {
+        x[0] = in[i].a ^ tweak.a;
+        ecb_aes_128_encrypt<1>(tmp, x, schedule);
+        out[i] = tmp[0] ^ x[0];
+    }
+}
+
+SilentOT::SilentOT(TwoPartyPlayer* player, OT_ROLE role,
+        const BitVector& delta) :
+        OTCorrelator<BitMatrix>(player, role, true), n_used(0)
+{
+    if (role & SENDER)
+        this->delta = delta.get_int128(0);
+    G.ReSeed();
+}
+
+void SilentOT::bootstrap(const BitMatrix& sender, const BitMatrix& receiver,
+        const BitVector& choices)
+{
+    if (ot_role & SENDER)
+    {
+        q.resize(RESERVE);
+        for (int i = 0; i < RESERVE; i++)
+            q[i] = sender.squares.at(i / 128).rows[i % 128];
+    }
+    if (ot_role & RECEIVER)
+    {
+        if (choices.size() < size_t(RESERVE))
+            throw runtime_error("not enough choice bits");
+        t.resize(RESERVE);
+        for (int i = 0; i < RESERVE; i++)
+            t[i] = receiver.squares.at(i / 128).rows[i % 128];
+        b = choices;
+        b.resize(RESERVE);
+    }
+    n_used = RESERVE;
+}
+
+void SilentOT::expand_tree(int128* leaves, int128 (*sums)[2])
+{
+    // breadth-first in place, starting with the seed in leaves[0]
+    vector<int128> children[2];
+    for (int i = 0; i < H; i++)
+    {
+        size_t n = 1 << i;
+        for (int k = 0; k < 2; k++)
+        {
+            children[k].resize(n);
+            hash(children[k].data(), leaves, n, k);
+            sums[i][k] = {};
+        }
+        for (size_t j = 0; j < n; j++)
+            for (int k = 0; k < 2; k++)
+            {
+                leaves[2 * j + k] = children[k][j];
+                sums[i][k] ^= children[k][j];
+            }
+    }
+}
+
+void SilentOT::puncture_tree(int128* leaves, const int128 (*sums)[2],
+        size_t alpha)
+{
+    // the node on the path to alpha is unknown and kept at zero
+    vector<int128> children[2];
+    size_t path = 0;
+    leaves[0] = {};
+    for (int i = 0; i < H; i++)
+    {
+        size_t n = 1 << i;
+        bool keep = (alpha >> (H - i - 1)) & 1;
+        bool lose = not keep;
+        for (int k = 0; k < 2; k++)
+        {
+            children[k].resize(n);
+            hash(children[k].data(), leaves, n, k);
+            children[k][path] = {};
+        }
+        int128 sibling = sums[i][lose];
+        for (size_t j = 0; j < n; j++)
+        {
+            sibling ^= children[lose][j];
+            for (int k = 0; k < 2; k++)
+                leaves[2 * j + k] = children[k][j];
+        }
+        leaves[2 * path + lose] = sibling;
+        path = 2 * path + keep;
+        leaves[path] = {};
+    }
+}
+
+void SilentOT::encode(vector<int128>& sender, vector<int128>& receiver,
+        BitVector& noise)
+{
+    // public code, the same in every iteration
+    PRNG G;
+    octet seed[SEED_SIZE] = {};
+    G.SetSeed(seed);
+
+    auto role = ot_role;
+    uint32_t indices[D];
+    for (int i = 0; i < N; i++)
+    {
+        G.get_octets((octet*) indices, sizeof(indices));
+        // the slight bias does not matter for a public code
+        for (auto& index : indices)
+            index = (uint64_t(index) * K) >> 32;
+        if (role & SENDER)
+            for (auto index : indices)
+                sender[i] ^= q[index];
+        if (role & RECEIVER)
+        {
+            bool bit = noise.get_bit(i);
+            for (auto index : indices)
+            {
+                receiver[i] ^= t[index];
+                bit ^= b.get_bit(index);
+            }
+            noise.set_bit(i, bit);
+        }
+    }
+}
+
+void SilentOT::iterate()
+{
+    auto role = ot_role;
+    size_t m = 1 << H;
+    vector<int128> sender_leaves, receiver_leaves;
+    BitVector noise;
+    vector<octetStream> os(2);
+    int128 sums[H][2];
+
+    // single-point correlated OT for every region of the noise
+    if (role & SENDER)
+    {
+        sender_leaves.resize(N);
+        for (int j = 0; j < T; j++)
+        {
+            auto leaves = &sender_leaves[j * m];
+            leaves[0] = G.get_doubleword();
+            expand_tree(leaves, sums);
+            int128 total = delta;
+            for (size_t i = 0; i < m; i++)
+                total ^= leaves[i];
+            for (int i = 0; i < H; i++)
+            {
+                word p = K + j * H + i;
+                int128 base[2] = {q[p], q[p] ^ delta}, pads[2];
+                for (int k = 0; k < 2; k++)
+                {
+                    hash(&pads[k], &base[k], 1, 2, p);
+                    os[0].serialize(sums[i][k] ^ pads[k]);
+                }
+            }
+            os[0].serialize(total);
+        }
+    }
+
+    send_if_ot_sender(player, os, role);
+
+    if (role & RECEIVER)
+    {
+        receiver_leaves.resize(N);
+        noise.resize_zero(N);
+        for (int j = 0; j < T; j++)
+        {
+            // the receiver learns the sibling of every node on the path
+            size_t alpha = 0;
+            for (int i = 0; i < H; i++)
+            {
+                word p = K + j * H + i;
+                bool choice = b.get_bit(p);
+                alpha = 2 * alpha + not choice;
+                int128 masked[2], pad;
+                for (int k = 0; k < 2; k++)
+                    os[1].unserialize(masked[k]);
+                hash(&pad, &t[p], 1, 2, p);
+                sums[i][choice] = masked[choice] ^ pad;
+            }
+            int128 total;
+            os[1].unserialize(total);
+            auto leaves = &receiver_leaves[j * m];
+            puncture_tree(leaves, sums, alpha);
+            for (size_t i = 0; i < m; i++)
+                total ^= leaves[i];
+            leaves[alpha] = total;
+            noise.set_bit(j * m + alpha, 1);
+        }
+    }
+
+    encode(sender_leaves, receiver_leaves, noise);
+    q.swap(sender_leaves);
+    t.swap(receiver_leaves);
+    b = noise;
+    // the beginning serves as base for the next iteration
+    n_used = RESERVE;
+}
+
+void SilentOT::extend(int nOTs, const BitVector& choices)
+{
+    auto role = ot_role;
+    if ((role & RECEIVER) and size_t(nOTs) != choices.size())
+        throw runtime_error("wrong number of choice bits");
+    if (q.empty() and t.empty())
+        throw runtime_error("silent OT needs a reserve to start");
+
+    int n_rounded = DIV_CEIL(nOTs, 128) * 128;
+    if (role & SENDER)
+        senderOutputMatrices[0].resize_vertical(n_rounded);
+    if (role & RECEIVER)
+        receiverOutputMatrix.resize_vertical(n_rounded);
+
+    for (int start = 0; start < n_rounded;)
+    {
+        if (n_used >= ((role & SENDER) ? q.size() : t.size()))
+            iterate();
+        int n = min(size_t(n_rounded - start), N - n_used);
+
+        // derandomize to the choice bits of the receiver
+        vector<octetStream> os(2);
+        if (role & RECEIVER)
+        {
+            BitVector diff(n);
+            for (int i = 0; i < n; i++)
+            {
+                bool choice = start + i < nOTs and choices.get_bit(start + i);
+                diff.set_bit(i, b.get_bit(n_used + i) ^ choice);
+                receiverOutputMatrix.squares[(start + i) / 128].rows[(start + i)
+                        % 128] = t[n_used + i].a;
+            }
+            diff.pack(os[0]);
+        }
+
+        send_if_ot_receiver(player, os, role);
+
+        if (role & SENDER)
+        {
+            BitVector diff;
+            diff.unpack(os[1]);
+            for (int i = 0; i < n; i++)
+            {
+                int128 x = q[n_used + i];
+                if (diff.get_bit(i))
+                    x ^= delta;
+                senderOutputMatrices[0].squares[(start + i) / 128].rows[(start
+                        + i) % 128] = x.a;
+            }
+        }
+
+        start += n;
+        n_used += n;
+    }
+}
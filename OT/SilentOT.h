@@ -0,0 +1,82 @@
+/*
+ * SilentOT.h
+ *
+ */
+
+#ifndef OT_SILENTOT_H_
+#define OT_SILENTOT_H_
+
+#include "OTExtensionWithMatrix.h"
+#include "Tools/aes.h"
+#include "Math/gf2nlong.h"
+
+#include <vector>
+using namespace std;
+
+/**
+ * Semi-honest correlated OT from LPN following Ferret (Yang et al.,
+ * CCS 2020). Every iteration turns a reserve of correlated OTs into
+ * about ten million new ones by means of single-point correlated OT
+ * with GGM trees and a local linear code with ten non-zero entries per
+ * row, so the communication is only logarithmic in the number of OTs.
+ * The first reserve has to be provided by another extension, the
+ * following ones are taken from the previous iteration. The outputs are
+ * in the matrices of the correlator like the ones of IKNP, so the
+ * correlation is the one of the reserve. Nothing is allocated before
+ * the reserve is provided.
+ */
+class SilentOT : public OTCorrelator<BitMatrix>
+{
+    // length, dimension, and noise weight of the LPN instance
+    static const int N = 10805248;
+    static const int K = 589760;
+    static const int T = 1319;
+    // depth of the GGM trees, N = T * 2^H
+    static const int H = 13;
+    // non-zero entries per row of the local code
+    static const int D = 10;
+    static const int RESERVE = K + T * H;
+
+    struct Schedule
+    {
+        octet keys[3][176] __attribute__((aligned (16)));
+        Schedule();
+    };
+
+    int128 delta;
+    PRNG G;
+
+    // sender and receiver side of the correlation, and choice bits
+    vector<int128> q, t;
+    BitVector b;
+    size_t n_used;
+
+    static const Schedule& schedule();
+
+    // out[i] = AES(in[i] ^ tweak) ^ in[i] ^ tweak with fixed key
+    static void hash(int128* out, const int128* in, size_t n, int key,
+            int128 tweak = {});
+
+    void iterate();
+
+    void expand_tree(int128* leaves, int128 (*sums)[2]);
+    void puncture_tree(int128* leaves, const int128 (*sums)[2],
+            size_t alpha);
+    void encode(vector<int128>& sender, vector<int128>& receiver,
+            BitVector& noise);
+
+public:
+    /// number of correlated OTs needed to start
+    static int reserve() { return RESERVE; }
+
+    SilentOT(TwoPartyPlayer* player, OT_ROLE role, const BitVector& delta);
+
+    /// take the first ``reserve()`` correlated OTs from another extension
+    void bootstrap(const BitMatrix& sender, const BitMatrix& receiver,
+            const BitVector& choices);
+
+    /// correlated OTs with choice bits as receiver
+    void extend(int nOTs, const BitVector& choices);
+};
+
+#endif /* OT_SILENTOT_H_ */
@@ -159,6 +159,12 @@ string BaseMachine::memory_filename(const string& type_short, int my_number)
   return PREP_DIR "Memory-" + type_short + "-P" + to_string(my_number);
 }
 
+string BaseMachine::checkpoint_filename(const string& type_short,
+    int my_number)
+{
+  return PREP_DIR "Checkpoint-" + type_short + "-P" + to_string(my_number);
+}
+
 string BaseMachine::get_domain(string progname)
 {
   assert(not singleton);
@@ -0,0 +1,280 @@
+/*
+ * BigDomainKernels.h
+ *
+ */
+
+#ifndef PROCESSOR_BIGDOMAINKERNELS_H_
+#define PROCESSOR_BIGDOMAINKERNELS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Tools/intrinsics.h"
+
+/**
+ * Element-wise arithmetic on arrays of 128-bit words stored as
+ * little-endian pairs of 64-bit limbs, which is the layout of ``Z2<128>``
+ */
+class Z2_128_kernels
+{
+    typedef unsigned __int128 word128;
+
+    static word128 load(const uint64_t* x)
+    {
+        return word128(x[1]) << 64 | x[0];
+    }
+
+    static void store(uint64_t* dest, word128 x)
+    {
+        dest[0] = x;
+        dest[1] = x >> 64;
+    }
+
+    // the AVX2 loops read two elements ahead of writing
+    static bool safe_to_batch(const uint64_t* dest, const uint64_t* x,
+            size_t n)
+    {
+        return dest <= x or dest >= x + 2 * n;
+    }
+
+public:
+    /// ``dest[i] = x[i] + y[i]`` for ``n`` words
+    static void add(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+            size_t n)
+    {
+        size_t i = 0;
+#ifdef __AVX2__
+        if (safe_to_batch(dest, x, n) and safe_to_batch(dest, y, n))
+        {
+            // carry from the lower into the upper limb within each lane
+            __m256i sign = _mm256_set1_epi64x(1ll << 63);
+            for (; i + 2 <= n; i += 2)
+            {
+                __m256i a = _mm256_loadu_si256((__m256i*) (x + 2 * i));
+                __m256i b = _mm256_loadu_si256((__m256i*) (y + 2 * i));
+                __m256i sum = _mm256_add_epi64(a, b);
+                __m256i carry = _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign),
+                        _mm256_xor_si256(sum, sign));
+                sum = _mm256_sub_epi64(sum, _mm256_slli_si256(carry, 8));
+                _mm256_storeu_si256((__m256i*) (dest + 2 * i), sum);
+            }
+        }
+#endif
+        for (; i < n; i++)
+            store(dest + 2 * i, load(x + 2 * i) + load(y + 2 * i));
+    }
+
+    /// ``dest[i] = x[i] - y[i]`` for ``n`` words
+    static void sub(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+            size_t n)
+    {
+        size_t i = 0;
+#ifdef __AVX2__
+        if (safe_to_batch(dest, x, n) and safe_to_batch(dest, y, n))
+        {
+            __m256i sign = _mm256_set1_epi64x(1ll << 63);
+            for (; i + 2 <= n; i += 2)
+            {
+                __m256i a = _mm256_loadu_si256((__m256i*) (x + 2 * i));
+                __m256i b = _mm256_loadu_si256((__m256i*) (y + 2 * i));
+                __m256i diff = _mm256_sub_epi64(a, b);
+                __m256i borrow = _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign),
+                        _mm256_xor_si256(a, sign));
+                diff = _mm256_add_epi64(diff, _mm256_slli_si256(borrow, 8));
+                _mm256_storeu_si256((__m256i*) (dest + 2 * i), diff);
+            }
+        }
+#endif
+        for (; i < n; i++)
+            store(dest + 2 * i, load(x + 2 * i) - load(y + 2 * i));
+    }
+
+    /// product modulo 2^128 from one 64x64->128 and two 64x64->64 products
+    static void mul(uint64_t* dest, const uint64_t* x, const uint64_t* y)
+    {
+#ifdef __BMI2__
+        unsigned long long high;
+        uint64_t low = _mulx_u64(x[0], y[0], &high);
+#else
+        word128 product = word128(x[0]) * y[0];
+        uint64_t low = product, high = product >> 64;
+#endif
+        dest[1] = high + x[0] * y[1] + x[1] * y[0];
+        dest[0] = low;
+    }
+
+    /// ``dest[i * m + k] = x[i * m + k] * y[i]`` for ``n`` words of ``y``
+    static void mul(uint64_t* dest, const uint64_t* x, const uint64_t* y,
+            size_t n, int m)
+    {
+        for (size_t i = 0; i < n; i++)
+            for (int k = 0; k < m; k++)
+                mul(dest + 2 * (i * m + k), x + 2 * (i * m + k), y + 2 * i);
+    }
+
+    /// ``dest[i] = x[i] * y`` for ``n`` words and a single word ``y``
+    static void mul_scalar(uint64_t* dest, const uint64_t* x,
+            const uint64_t* y, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            mul(dest + 2 * i, x + 2 * i, y);
+    }
+
+    /**
+     * ``dest[i * m + k] = sign_x * x[i * m + k] + sign_y * unit[k] * y[i]``
+     * for ``n`` words of ``y``, where ``unit`` only contains zeros and ones
+     */
+    static void add_scaled(uint64_t* dest, const uint64_t* x,
+            const uint64_t* y, const bool* unit, size_t n, int m,
+            bool negate_x, bool negate_y)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            word128 c = load(y + 2 * i);
+            if (negate_y)
+                c = -c;
+            for (int k = 0; k < m; k++)
+            {
+                size_t j = 2 * (i * m + k);
+                word128 a = load(x + j);
+                if (negate_x)
+                    a = -a;
+                store(dest + j, unit[k] ? a + c : a);
+            }
+        }
+    }
+};
+
+/**
+ * Vector kernels for the big-domain share instructions. Shares that are
+ * plain tuples of 128-bit components (no MAC) are processed limb-wise,
+ * everything else falls back to the generic share arithmetic.
+ * Public constants are embedded by scaling ``T::constant(1)``, which is
+ * computed once per instruction instead of once per element.
+ */
+template<class T>
+class BigDomainKernels
+{
+    typedef typename T::clear clear;
+    typedef Z2_128_kernels K;
+
+    static const int N_COMPONENTS = sizeof(T) / sizeof(clear);
+
+    static uint64_t* limbs(T* x) { return (uint64_t*) x; }
+    static const uint64_t* limbs(const T* x) { return (const uint64_t*) x; }
+    static uint64_t* limbs(clear* x) { return (uint64_t*) x; }
+    static const uint64_t* limbs(const clear* x) { return (const uint64_t*) x; }
+
+    // decompose T::constant(1) into components if they are all bits
+    static bool unit_bits(const T& unit, bool* bits)
+    {
+        auto words = limbs(&unit);
+        for (int k = 0; k < N_COMPONENTS; k++)
+        {
+            if (words[2 * k + 1] != 0 or words[2 * k] > 1)
+                return false;
+            bits[k] = words[2 * k];
+        }
+        return true;
+    }
+
+    static void add_scaled(T* dest, const T* x, const clear* y,
+            const T& unit, size_t size, bool negate_x, bool negate_y)
+    {
+        bool bits[N_COMPONENTS];
+        if (native and unit_bits(unit, bits))
+            K::add_scaled(limbs(dest), limbs(x), limbs(y), bits, size,
+                    N_COMPONENTS, negate_x, negate_y);
+        else
+            for (size_t i = 0; i < size; i++)
+            {
+                T a = x[i], c = unit * y[i];
+                if (negate_x)
+                    a = T() - a;
+                if (negate_y)
+                    dest[i] = a - c;
+                else
+                    dest[i] = a + c;
+            }
+    }
+
+public:
+    static const bool native = not T::has_mac and sizeof(clear) == 16
+            and clear::N_BITS == 128 and sizeof(T) % sizeof(clear) == 0;
+
+    static T unit(int my_num, const typename T::mac_key_type& alphai)
+    {
+        return T::constant(1, my_num, alphai);
+    }
+
+    /// ``dest = x + y`` for shares or clear values
+    template<class U>
+    static void add(U* dest, const U* x, const U* y, size_t size)
+    {
+        if (native)
+            K::add(limbs(dest), limbs(x), limbs(y),
+                    size * sizeof(U) / sizeof(clear));
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] + y[i];
+    }
+
+    /// ``dest = x - y`` for shares or clear values
+    template<class U>
+    static void sub(U* dest, const U* x, const U* y, size_t size)
+    {
+        if (native)
+            K::sub(limbs(dest), limbs(x), limbs(y),
+                    size * sizeof(U) / sizeof(clear));
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] - y[i];
+    }
+
+    /// ``dest = x * y`` element-wise for shares or clear values ``x``
+    template<class U>
+    static void mul(U* dest, const U* x, const clear* y, size_t size)
+    {
+        if (native)
+            K::mul(limbs(dest), limbs(x), limbs(y), size,
+                    sizeof(U) / sizeof(clear));
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y[i];
+    }
+
+    /// ``dest = x * y`` for a single public ``y``
+    template<class U>
+    static void mul(U* dest, const U* x, const clear& y, size_t size)
+    {
+        if (native)
+            K::mul_scalar(limbs(dest), limbs(x), limbs(&y),
+                    size * sizeof(U) / sizeof(clear));
+        else
+            for (size_t i = 0; i < size; i++)
+                dest[i] = x[i] * y;
+    }
+
+    /// ``dest = x + y`` for public ``y`` (``ADDM``)
+    static void add(T* dest, const T* x, const clear* y, const T& unit,
+            size_t size)
+    {
+        add_scaled(dest, x, y, unit, size, false, false);
+    }
+
+    /// ``dest = x - y`` for public ``y`` (``SUBML``)
+    static void sub(T* dest, const T* x, const clear* y, const T& unit,
+            size_t size)
+    {
+        add_scaled(dest, x, y, unit, size, false, true);
+    }
+
+    /// ``dest = x - y`` for public ``x`` (``SUBMR``)
+    static void sub(T* dest, const clear* x, const T* y, const T& unit,
+            size_t size)
+    {
+        add_scaled(dest, y, x, unit, size, true, false);
+    }
+};
+
+#endif /* PROCESSOR_BIGDOMAINKERNELS_H_ */
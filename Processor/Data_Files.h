@@ -169,6 +169,9 @@ public:
   /// Store fresh daBit in ``a`` (arithmetic part) and ``b`` (binary part)
   virtual void get_dabit(T& a, typename T::bit_type& b);
   virtual void get_dabit_no_count(T&, typename T::bit_type&) { throw runtime_error("no daBit"); }
+  /// Store ``n`` fresh daBits without counting them
+  virtual void get_dabits_no_count(T* a, typename T::bit_type* b, size_t n)
+  { for (size_t i = 0; i < n; i++) get_dabit_no_count(a[i], b[i]); }
   virtual void get_edabits(bool strict, size_t size, T* a,
           vector<typename T::bit_type>& Sb, const vector<int>& regs)
   { get_edabits<0>(strict, size, a, Sb, regs, T::clear::characteristic_two); }
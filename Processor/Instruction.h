@@ -80,6 +80,7 @@ enum
   PLAYERID = 0xE4,
   USE_EDABIT = 0xE5,
   USE_MATMUL = 0x1F,
+  CHECKPOINT = 0xEA,
   // Addition
   ADDC = 0x20,
   ADDS = 0x21,
@@ -125,6 +126,8 @@ enum
   APPLYSHUFFLE = 0xFC,
   DELSHUFFLE = 0xFD,
   INVPERM = 0xFE,
+  RADIXSORT = 0xE8,
+  GENRADIXPERM = 0xE9,
   // Data access
   TRIPLE = 0x50,
   BIT = 0x51,
@@ -402,6 +405,11 @@ public:
   template <class sint, class sgf2n>
   void execute_big_domain_instructions(Processor<sint, sgf2n> &Proc) const;
 
+  // local arithmetic on vector elements [offset, offset + size)
+  template <class sint, class sgf2n>
+  void execute_block(Processor<sint, sgf2n> &Proc, int offset,
+                     int size) const;
+
   template <class cgf2n>
   void execute_clear_gf2n(vector<cgf2n> &registers, vector<cgf2n> &memory,
                           ArithmeticProcessor &Proc) const;
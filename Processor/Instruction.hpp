@@ -13,6 +13,7 @@
 #include "Tools/parse.h"
 #include "GC/Instruction.h"
 #include "GC/instructions.h"
+#include "Processor/InstructionHandlers.h"
 #include "Processor/Instructions_for_big_domain.h"
 
 #include "Processor/Binary_File_IO.hpp"
@@ -212,9 +213,15 @@ inline void BaseInstruction::parse_operands(istream &s, int pos, int file_pos)
   case GINPUTMASK:
   case SECSHUFFLE:
   case GSECSHUFFLE:
+  case GENRADIXPERM:
     get_ints(r, s, 2);
     n = get_int(s);
     break;
+  // instructions with 3 registers + 1 integer operand
+  case RADIXSORT:
+    get_ints(r, s, 3);
+    n = get_int(s);
+    break;
   case STARTPRIVATEOUTPUT:
   case GSTARTPRIVATEOUTPUT:
   case STOPPRIVATEOUTPUT:
@@ -277,6 +284,7 @@ inline void BaseInstruction::parse_operands(istream &s, int pos, int file_pos)
   case STARTGRIND:
   case STOPGRIND:
   case CHECK:
+  case CHECKPOINT:
     break;
   // instructions with 5 register operands
   case PRINTFLOATPLAIN:
@@ -715,6 +723,18 @@ inline unsigned BaseInstruction::get_max_reg(int reg_type) const
       return r[1] + size;
     else
       return 0;
+  // outputs of every call are the size at the second argument
+  // starting at the register in the third
+  case CISC:
+    if (reg_type == SINT)
+    {
+      int res = 0;
+      for (size_t i = 0; i < start.size(); i += start[i])
+        res = max(res, start[i + 1] + start[i + 2]);
+      return res;
+    }
+    else
+      return 0;
   case TRANS:
     if (reg_type == SBIT)
     {
@@ -754,6 +774,11 @@ inline unsigned BaseInstruction::get_max_reg(int reg_type) const
     return r[0] + start[0] * (start[1] + start[2]);
   case PSI:
     return r[0] + start[0];
+  // key bits are n vectors of the instruction size
+  case RADIXSORT:
+    return max(unsigned(max(r[0], r[1]) + size), unsigned(r[2] + size * n));
+  case GENRADIXPERM:
+    return max(unsigned(r[0] + size), unsigned(r[1] + size * n));
   case MATMULS:
   {
     unsigned res = 0;
@@ -962,6 +987,67 @@ typename T::clear Instruction::sanitize(SubProcessor<T> &proc, int reg) const
   return res;
 }
 
+template <class sint, class sgf2n>
+inline void Instruction::execute_block(Processor<sint, sgf2n> &Proc,
+                                       int offset, int size) const
+{
+  auto &Procp = Proc.Procp;
+  auto &Proc2 = Proc.Proc2;
+  (void)Proc2;
+  int r[] = {this->r[0] + offset, this->r[1] + offset, this->r[2] + offset};
+  size_t n = this->n;
+  // only memory addresses move with the block, not immediate values
+  if (opcode == LDMS or opcode == STMS)
+    n += offset;
+  auto &start = this->start;
+  (void)start;
+
+  switch (opcode)
+  {
+#define X(NAME, PRE, CODE)         \
+  case NAME:                       \
+  {                                \
+    PRE;                           \
+    for (int i = 0; i < size; i++) \
+    {                              \
+      CODE;                        \
+    }                              \
+  }                                \
+  break;
+    ARITHMETIC_INSTRUCTIONS
+#undef X
+  default:
+    throw runtime_error("instruction cannot be fused");
+  }
+}
+
+/* Sequences found by Program::fuse() run block by block, so that each
+ * block of registers stays in cache while all instructions use it.
+ * Blocks are independent, so long vectors are split across the local
+ * worker threads if there are any. */
+template <class sint, class sgf2n>
+void Program::execute_fused(Processor<sint, sgf2n> &Proc, int begin) const
+{
+  int length = fused[begin];
+  int size = p[begin].get_size();
+  int n_blocks = DIV_CEIL(size, FUSION_BLOCK_SIZE);
+  auto blocks = [&](int first, int last)
+  {
+    for (int b = first; b < last; b++)
+    {
+      int offset = b * FUSION_BLOCK_SIZE;
+      int block = min(int(FUSION_BLOCK_SIZE), size - offset);
+      for (int i = begin; i < begin + length; i++)
+        p[i].execute_block(Proc, offset, block);
+    }
+  };
+  auto workers = Proc.get_local_workers();
+  if (workers and size >= PARALLEL_THRESHOLD)
+    workers->run(n_blocks, blocks);
+  else
+    blocks(0, n_blocks);
+}
+
 #ifndef BIG_DOMAIN_FOR_RING
 
 template <class sint, class sgf2n>
@@ -1174,7 +1260,7 @@ inline void Instruction::execute(Processor<sint, sgf2n> &Proc) const
       Proc.Proc2.POpen(*this);
       return;
     case MULS:
-      Proc.Procp.muls(start, size);
+      Proc.Procp.protocol.muls(start, Proc.Procp, Proc.MCp, size);
       return;
     case GMULS:
       Proc.Proc2.protocol.muls(start, Proc.Proc2, Proc.MC2, size);
@@ -1231,6 +1317,10 @@ inline void Instruction::execute(Processor<sint, sgf2n> &Proc) const
     case INVPERM:
       Proc.Procp.inverse_permutation(*this);
       return;
+    case RADIXSORT:
+    case GENRADIXPERM:
+      Proc.Procp.radix_sort(*this);
+      return;
     case CHECK:
     {
       CheckJob job;
@@ -1328,6 +1418,9 @@ inline void Instruction::execute(Processor<sint, sgf2n> &Proc) const
     case STOPGRIND:
       CALLGRIND_STOP_INSTRUMENTATION;
       break;
+    case CHECKPOINT:
+      Proc.machine.checkpoint(Proc);
+      break;
     case NPLAYERS:
       Proc.write_Ci(r[0], Proc.P.num_players());
       break;
@@ -1454,11 +1547,125 @@ inline void Instruction::execute(Processor<sint, sgf2n> &Proc) const
   }
 }
 
+#ifdef THREADED_DISPATCH
+template <class sint, class sgf2n>
+void Program::execute_threaded(Processor<sint, sgf2n> &Proc) const
+{
+  unsigned int size = p.size();
+
+  auto &Procp = Proc.Procp;
+  auto &Proc2 = Proc.Proc2;
+
+  // binary instructions
+  typedef typename sint::bit_type T;
+  auto &processor = Proc.Procb;
+  auto &Ci = Proc.get_Ci();
+
+  // same order as InstructionHandler
+  static const void *const labels[] = {
+      &&handle_END, &&handle_DEFAULT, &&handle_CMD, &&handle_CLEAR_GF2N,
+      &&handle_REGINT, &&handle_FUSED,
+#define X(NAME, PRE, CODE) &&handle_##NAME,
+      ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) &&handle_##NAME,
+      COMBI_INSTRUCTIONS
+#undef X
+  };
+  static_assert(sizeof(labels) / sizeof(labels[0]) == N_HANDLERS,
+                "label table does not match InstructionHandler");
+
+  auto handlers = this->handlers.data();
+
+// every handler dispatches to the next instruction itself;
+// local arithmetic never changes the program counter, and
+// handlers[size] is HANDLER_END
+#define DISPATCH goto *labels[handlers[Proc.PC]]
+#define DISPATCH_CHECKED \
+  goto *labels[Proc.PC < size ? handlers[Proc.PC] : int(HANDLER_END)]
+#define FETCH                                  \
+  auto &instruction = p[Proc.PC];              \
+  auto &r = instruction.r;                     \
+  auto &n = instruction.n;                     \
+  auto &start = instruction.start;             \
+  auto &size = instruction.size;               \
+  (void)r, (void)n, (void)start, (void)size;   \
+  Proc.PC++;
+
+  DISPATCH_CHECKED;
+
+#define X(NAME, PRE, CODE)           \
+  handle_##NAME:                     \
+  {                                  \
+    FETCH                            \
+    PRE;                             \
+    for (int i = 0; i < size; i++)   \
+    {                                \
+      CODE;                          \
+    }                                \
+  }                                  \
+  DISPATCH;
+  ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) \
+  handle_##NAME:      \
+  {                   \
+    FETCH             \
+    CODE;             \
+  }                   \
+  DISPATCH_CHECKED;
+  COMBI_INSTRUCTIONS
+#undef X
+
+handle_CLEAR_GF2N:
+  {
+    FETCH
+    instruction.execute_clear_gf2n(Proc2.get_C(), Proc.machine.M2.MC, Proc);
+  }
+  DISPATCH_CHECKED;
+
+handle_REGINT:
+  {
+    FETCH
+    instruction.execute_regint(Proc, Proc.machine.Mi.MC);
+  }
+  DISPATCH_CHECKED;
+
+handle_FUSED:
+  execute_fused(Proc, Proc.PC);
+  Proc.PC += fused[Proc.PC];
+  DISPATCH;
+
+handle_CMD:
+handle_DEFAULT:
+  {
+    FETCH
+    instruction.execute(Proc);
+  }
+  DISPATCH_CHECKED;
+
+#undef FETCH
+#undef DISPATCH_CHECKED
+#undef DISPATCH
+
+handle_END:
+  return;
+}
+#endif
+
 template <class sint, class sgf2n>
 void Program::execute(Processor<sint, sgf2n> &Proc) const
 {
+#ifdef THREADED_DISPATCH
+  // the switch below remains for profiling
+  if (not Proc.profiler.active())
+  {
+    execute_threaded(Proc);
+    return;
+  }
+#endif
+
   unsigned int size = p.size();
-  Proc.PC = 0;
 
   auto &Procp = Proc.Procp;
   auto &Proc2 = Proc.Proc2;
@@ -1477,6 +1684,9 @@ void Program::execute(Processor<sint, sgf2n> &Proc) const
     auto &size = instruction.size;
     (void)start;
 
+    InstructionProfilerScope profile(Proc.profiler, instruction.get_opcode(),
+                                     Proc.PC, Proc.P);
+
 #ifdef COUNT_INSTRUCTIONS
 #ifdef TIME_INSTRUCTIONS
     RunningTimer timer;
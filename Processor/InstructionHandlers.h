@@ -0,0 +1,64 @@
+/*
+ * InstructionHandlers.h
+ *
+ */
+
+#ifndef PROCESSOR_INSTRUCTIONHANDLERS_H_
+#define PROCESSOR_INSTRUCTIONHANDLERS_H_
+
+#include "Processor/instructions.h"
+#include "GC/instructions.h"
+
+// computed goto is a GNU extension, and the switch keeps the
+// instrumentation for counting and printing instructions
+#if defined(__GNUC__) and not defined(NO_THREADED_DISPATCH) \
+    and not defined(COUNT_INSTRUCTIONS) and not defined(OUTPUT_INSTRUCTIONS)
+#define THREADED_DISPATCH
+#endif
+
+/**
+ * Handlers for threaded dispatch in ``Program::execute``, in the order
+ * of the label table there. Instructions without their own handler in
+ * the interpreter loop share ``HANDLER_DEFAULT``.
+ */
+enum InstructionHandler
+{
+    HANDLER_END,
+    HANDLER_DEFAULT,
+    HANDLER_CMD,
+    HANDLER_CLEAR_GF2N,
+    HANDLER_REGINT,
+    HANDLER_FUSED,
+#define X(NAME, PRE, CODE) HANDLER_##NAME,
+    ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) HANDLER_##NAME,
+    COMBI_INSTRUCTIONS
+#undef X
+    N_HANDLERS
+};
+
+inline InstructionHandler instruction_handler(int opcode)
+{
+    switch (opcode)
+    {
+#define X(NAME, PRE, CODE) case NAME: return HANDLER_##NAME;
+    ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) case NAME: return HANDLER_##NAME;
+    COMBI_INSTRUCTIONS
+#undef X
+#define X(NAME, PRE, CODE) case NAME:
+    CLEAR_GF2N_INSTRUCTIONS
+        return HANDLER_CLEAR_GF2N;
+    REGINT_INSTRUCTIONS
+        return HANDLER_REGINT;
+#undef X
+    case CMD:
+        return HANDLER_CMD;
+    default:
+        return HANDLER_DEFAULT;
+    }
+}
+
+#endif /* PROCESSOR_INSTRUCTIONHANDLERS_H_ */
@@ -0,0 +1,234 @@
+/*
+ * InstructionProfiler.cpp
+ *
+ */
+
+#include "InstructionProfiler.h"
+#include "Processor/instructions.h"
+#include "GC/instructions.h"
+#include "Networking/Player.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <set>
+#include <algorithm>
+#include <mutex>
+
+ProfileCost& ProfileCost::operator+=(const ProfileCost& other)
+{
+    calls += other.calls;
+    bytes += other.bytes;
+    rounds += other.rounds;
+    wall += other.wall;
+    cpu += other.cpu;
+    return *this;
+}
+
+InstructionProfiler::InstructionProfiler() :
+        enabled(false), thread_num(0), tape(-1), dropped(0), wall_start(0),
+        cpu_start(0), bytes_start(0), rounds_start(0)
+{
+}
+
+double InstructionProfiler::now(clockid_t clock_id)
+{
+    timespec t;
+    clock_gettime(clock_id, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+string InstructionProfiler::opcode_name(int opcode)
+{
+    switch (opcode)
+    {
+#define X(NAME, PRE, CODE) case NAME: return #NAME;
+    ALL_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) case NAME: return #NAME;
+    COMBI_INSTRUCTIONS
+#undef X
+    default:
+        stringstream ss;
+        ss << hex << showbase << opcode;
+        return ss.str();
+    }
+}
+
+void InstructionProfiler::activate(int thread_num)
+{
+    enabled = true;
+    this->thread_num = thread_num;
+}
+
+void InstructionProfiler::start(const Player& P)
+{
+    P.comm_counters(bytes_start, rounds_start);
+    cpu_start = now(CLOCK_THREAD_CPUTIME_ID);
+    wall_start = now(CLOCK_MONOTONIC);
+}
+
+void InstructionProfiler::stop(int opcode, int pc, const Player& P)
+{
+    double wall_end = now(CLOCK_MONOTONIC);
+    ProfileCost cost;
+    cost.calls = 1;
+    cost.wall = wall_end - wall_start;
+    cost.cpu = now(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+    size_t bytes, rounds;
+    P.comm_counters(bytes, rounds);
+    cost.bytes = bytes - bytes_start;
+    cost.rounds = rounds - rounds_start;
+
+    opcodes[opcode] += cost;
+    positions[{tape, pc}] += cost;
+
+    if (not trace.empty() and trace.back().opcode == opcode
+            and trace.back().tape == tape)
+    {
+        auto& last = trace.back();
+        last.duration = wall_end - last.begin;
+        last.cost += cost;
+    }
+    else if (trace.size() < MAX_TRACE_EVENTS)
+        trace.push_back({thread_num, tape, pc, opcode, wall_start, cost.wall,
+                cost});
+    else
+        dropped++;
+}
+
+void InstructionProfiler::merge(const InstructionProfiler& other)
+{
+    static mutex lock;
+    lock_guard<mutex> guard(lock);
+    enabled |= other.enabled;
+    for (auto& x : other.opcodes)
+        opcodes[x.first] += x.second;
+    for (auto& x : other.positions)
+        positions[x.first] += x.second;
+    trace.insert(trace.end(), other.trace.begin(), other.trace.end());
+    dropped += other.dropped;
+}
+
+namespace
+{
+
+string tape_name(const vector<string>& tape_names, int tape)
+{
+    if (tape < 0 or size_t(tape) >= tape_names.size())
+        return to_string(tape);
+    string name = tape_names[tape];
+    size_t slash = name.rfind('/');
+    if (slash != string::npos)
+        name = name.substr(slash + 1);
+    if (name.size() > 3 and name.substr(name.size() - 3) == ".bc")
+        name = name.substr(0, name.size() - 3);
+    return name;
+}
+
+void print_cost(const ProfileCost& cost)
+{
+    cerr << setw(12) << cost.calls << setw(12) << cost.wall << setw(12)
+            << cost.cpu << setw(12) << 1e-6 * cost.bytes << setw(10)
+            << cost.rounds << endl;
+}
+
+void print_header(const string& name)
+{
+    cerr << "\t" << left << setw(25) << name << right << setw(12) << "calls"
+            << setw(12) << "wall (s)" << setw(12) << "CPU (s)" << setw(12)
+            << "sent (MB)" << setw(10) << "rounds" << endl;
+}
+
+template<class T>
+vector<pair<T, ProfileCost>> sorted_by_time(const map<T, ProfileCost>& costs)
+{
+    vector<pair<T, ProfileCost>> res(costs.begin(), costs.end());
+    sort(res.begin(), res.end(),
+            [](const pair<T, ProfileCost>& a, const pair<T, ProfileCost>& b)
+            { return a.second.wall > b.second.wall; });
+    return res;
+}
+
+}
+
+void InstructionProfiler::print(const vector<string>& tape_names,
+        size_t n_positions)
+{
+    if (not enabled)
+        return;
+
+    ProfileCost total;
+    cerr << "Instruction profile (summed over threads):" << endl;
+    print_header("instruction");
+    for (auto& x : sorted_by_time(opcodes))
+    {
+        cerr << "\t" << left << setw(25) << opcode_name(x.first) << right;
+        print_cost(x.second);
+        total += x.second;
+    }
+    cerr << "\t" << left << setw(25) << "Total" << right;
+    print_cost(total);
+
+    cerr << "Most expensive tape positions:" << endl;
+    print_header("tape:pc instruction");
+    auto sorted_positions = sorted_by_time(positions);
+    sorted_positions.resize(min(n_positions, sorted_positions.size()));
+    for (auto& x : sorted_positions)
+    {
+        int tape = x.first.first, pc = x.first.second;
+        stringstream ss;
+        ss << tape_name(tape_names, tape) << ":" << pc;
+        cerr << "\t" << left << setw(25) << ss.str() << right;
+        print_cost(x.second);
+    }
+
+    if (dropped)
+        cerr << "Trace truncated after " << MAX_TRACE_EVENTS
+                << " events per thread" << endl;
+}
+
+void InstructionProfiler::write_trace(const string& filename, int my_num,
+        const vector<string>& tape_names)
+{
+    if (not enabled)
+        return;
+
+    ofstream out(filename);
+    if (out.fail())
+        throw runtime_error("cannot write profile to " + filename);
+
+    double epoch = 0;
+    if (not trace.empty())
+        epoch = min_element(trace.begin(), trace.end(),
+                [](const TraceEvent& a, const TraceEvent& b)
+                { return a.begin < b.begin; })->begin;
+
+    set<int> threads;
+    for (auto& event : trace)
+        threads.insert(event.thread);
+
+    out << "{\"traceEvents\":[" << endl;
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << my_num
+            << ",\"args\":{\"name\":\"Party " << my_num << "\"}}";
+    for (int thread : threads)
+        out << "," << endl << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+                << my_num << ",\"tid\":" << thread
+                << ",\"args\":{\"name\":\"Thread " << thread << "\"}}";
+    out << fixed << setprecision(3);
+    for (auto& event : trace)
+    {
+        out << "," << endl << "{\"name\":\"" << opcode_name(event.opcode)
+                << "\",\"cat\":\"" << tape_name(tape_names, event.tape)
+                << "\",\"ph\":\"X\",\"pid\":" << my_num << ",\"tid\":"
+                << event.thread << ",\"ts\":" << 1e6 * (event.begin - epoch)
+                << ",\"dur\":" << 1e6 * event.duration << ",\"args\":{\"pc\":"
+                << event.pc << ",\"calls\":" << event.cost.calls
+                << ",\"cpu_us\":" << 1e6 * event.cost.cpu << ",\"bytes\":"
+                << event.cost.bytes << ",\"rounds\":" << event.cost.rounds
+                << "}}";
+    }
+    out << endl << "]}" << endl;
+    cerr << "Wrote instruction trace to " << filename << endl;
+}
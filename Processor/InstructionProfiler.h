@@ -0,0 +1,110 @@
+/*
+ * InstructionProfiler.h
+ *
+ */
+
+#ifndef PROCESSOR_INSTRUCTIONPROFILER_H_
+#define PROCESSOR_INSTRUCTIONPROFILER_H_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <time.h>
+using namespace std;
+
+class Player;
+
+/**
+ * Resources attributed to an opcode or a tape position
+ */
+class ProfileCost
+{
+public:
+    size_t calls, bytes, rounds;
+    // seconds
+    double wall, cpu;
+
+    ProfileCost() : calls(0), bytes(0), rounds(0), wall(0), cpu(0) {}
+
+    ProfileCost& operator+=(const ProfileCost& other);
+};
+
+/**
+ * Runtime instruction profiler (``--profile``). Every thread attributes
+ * wall time, thread CPU time, bytes sent and communication rounds to
+ * opcodes and to (tape, program counter) positions. The trace merges
+ * consecutive executions of the same instruction into one event.
+ */
+class InstructionProfiler
+{
+    struct TraceEvent
+    {
+        int thread, tape, pc, opcode;
+        double begin, duration;
+        ProfileCost cost;
+    };
+
+    bool enabled;
+    int thread_num, tape;
+
+    map<int, ProfileCost> opcodes;
+    map<pair<int, int>, ProfileCost> positions;
+    vector<TraceEvent> trace;
+    size_t dropped;
+
+    // state at the start of the current instruction
+    double wall_start, cpu_start;
+    size_t bytes_start, rounds_start;
+
+    static double now(clockid_t clock_id);
+
+public:
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    static string opcode_name(int opcode);
+
+    InstructionProfiler();
+
+    void activate(int thread_num);
+    bool active() const { return enabled; }
+
+    void set_tape(int tape) { this->tape = tape; }
+
+    void start(const Player& P);
+    void stop(int opcode, int pc, const Player& P);
+
+    /// thread-safe aggregation of per-thread profiles
+    void merge(const InstructionProfiler& other);
+
+    void print(const vector<string>& tape_names, size_t n_positions = 20);
+    /// Chrome trace/Perfetto JSON with one process per party
+    void write_trace(const string& filename, int my_num,
+            const vector<string>& tape_names);
+};
+
+/**
+ * Profiles one instruction if the profiler is active
+ */
+class InstructionProfilerScope
+{
+    InstructionProfiler& profiler;
+    const Player& P;
+    int opcode, pc;
+
+public:
+    InstructionProfilerScope(InstructionProfiler& profiler, int opcode,
+            int pc, const Player& P) :
+            profiler(profiler), P(P), opcode(opcode), pc(pc)
+    {
+        if (profiler.active())
+            profiler.start(P);
+    }
+
+    ~InstructionProfilerScope()
+    {
+        if (profiler.active())
+            profiler.stop(opcode, pc, P);
+    }
+};
+
+#endif /* PROCESSOR_INSTRUCTIONPROFILER_H_ */
@@ -2,6 +2,31 @@
 #ifndef GARNET_INSTRUCTIONS_FOR_BIG_DOMAIN_H
 #define GARNET_INSTRUCTIONS_FOR_BIG_DOMAIN_H
 
+#include "BigDomainKernels.h"
+
+// executed once per vector by the kernels in BigDomainKernels.h
+#define BIG_DOMAIN_KERNEL_INSTRUCTIONS \
+    X(ADDS, kernels::add(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_S()[r[2]], size)) \
+    X(ADDM, kernels::add(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_C()[r[2]], kernels::unit(Proc.P.my_num(), Procp.MC.get_alphai()), size)) \
+    X(ADDC, kernels::add(&Procp.get_C()[r[0]], &Procp.get_C()[r[1]], \
+            &Procp.get_C()[r[2]], size)) \
+    X(SUBS, kernels::sub(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_S()[r[2]], size)) \
+    X(SUBML, kernels::sub(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_C()[r[2]], kernels::unit(Proc.P.my_num(), Procp.MC.get_alphai()), size)) \
+    X(SUBMR, kernels::sub(&Procp.get_S()[r[0]], &Procp.get_C()[r[1]], \
+            &Procp.get_S()[r[2]], kernels::unit(Proc.P.my_num(), Procp.MC.get_alphai()), size)) \
+    X(MULM, kernels::mul(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            &Procp.get_C()[r[2]], size)) \
+    X(MULC, kernels::mul(&Procp.get_C()[r[0]], &Procp.get_C()[r[1]], \
+            &Procp.get_C()[r[2]], size)) \
+    X(MULSI, kernels::mul(&Procp.get_S()[r[0]], &Procp.get_S()[r[1]], \
+            typename BigDomainShare::clear(int(n)), size)) \
+    X(MULCI, kernels::mul(&Procp.get_C()[r[0]], &Procp.get_C()[r[1]], \
+            typename BigDomainShare::clear(int(n)), size)) \
+
 #define ARITHMETIC_INSTRUCTIONS_FOR_BIG_DOMAIN \
     X(LDI, auto dest = &Procp.get_C()[r[0]]; typename BigDomainShare::clear tmp = int(n), \
             *dest++ = tmp)      \
@@ -14,53 +39,24 @@
             *dest++ = *source++) \
     X(MOVS, auto dest = &Procp.get_S()[r[0]]; auto source = &Procp.get_S()[r[1]], \
             *dest++ = *source++)\
-    X(ADDS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_S()[r[2]], \
-            *dest++ = *op1++ + *op2++)         \
-    X(ADDSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]], \
-            *dest++ = *op1++ + BigDomainShare::constant(int(n), Proc.P.my_num(), Procp.MC.get_alphai()))                                            \
-    X(ADDM, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ + BigDomainShare::constant(*op2++, Proc.P.my_num(), Procp.MC.get_alphai())) \
+    X(ADDSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
+            auto op2 = BigDomainShare::constant(int(n), Proc.P.my_num(), Procp.MC.get_alphai()), \
+            *dest++ = *op1++ + op2)                                                            \
     X(ADDCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
             typename BigDomainShare::clear op2 = int(n), \
             *dest++ = *op1++ + op2)            \
-    X(ADDC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ + *op2++) \
-    X(SUBS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_S()[r[2]], \
-            *dest++ = *op1++ - *op2++)             \
-    X(SUBML, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ - BigDomainShare::constant(*op2++, Proc.P.my_num(), Procp.MC.get_alphai())) \
-    X(SUBMR, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            auto op2 = &Procp.get_S()[r[2]], \
-            *dest++ = BigDomainShare::constant(*op1++, Proc.P.my_num(), Procp.MC.get_alphai()) - *op2++) \
     X(SUBSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
             auto op2 = BigDomainShare::constant(int(n), Proc.P.my_num(), Procp.MC.get_alphai()), \
             *dest++ = *op1++ - op2)                                                            \
     X(SUBSFI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
             auto op2 = BigDomainShare::constant(int(n), Proc.P.my_num(), Procp.MC.get_alphai()), \
             *dest++ = op2 - *op1++)                                                            \
-    X(MULM, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ * *op2++) \
-    X(MULCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            typename BigDomainShare::clear op2 = int(n), \
-            *dest++ = *op1++ * op2) \
-    X(MULSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            typename BigDomainShare::clear op2 = int(n), \
-            *dest++ = *op1++ * op2)            \
     X(SHLCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]], \
             *dest++ = *op1++ << n) \
     X(SHRCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]], \
             *dest++ = *op1++ >> n)             \
     X(CONVINT, auto dest = &Procp.get_C()[r[0]]; auto source = &Proc.get_Ci()[r[1]], \
             *dest++ = *source++) \
-    X(MULC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ * *op2++) \
     X(LDMSI, auto dest = &Procp.get_S()[r[0]]; auto source = &Proc.get_Ci()[r[1]], \
             *dest++ = Proc.machine.Mp_2->read_S(*source++))                             \
     X(STMSI, auto source = &Procp.get_S()[r[0]]; auto dest = &Proc.get_Ci()[r[1]], \
@@ -97,6 +93,7 @@ template<class sint, class sgf2n>
 inline void Instruction::execute_big_domain_instructions(Processor<sint, sgf2n>& Proc) const
 {
   auto& Procp = *Proc.Procp_2;
+  typedef BigDomainKernels<BigDomainShare> kernels;
   switch (opcode) {
     case LDMINT:
       cout << "LDMINT" << endl;
@@ -136,6 +133,9 @@ inline void Instruction::execute_big_domain_instructions(Processor<sint, sgf2n>&
     case GENSECSHUFFLE:
     case APPLYSHUFFLE:
     case DELSHUFFLE:
+    case RADIXSORT:
+    case GENRADIXPERM:
+    case CHECKPOINT:
     case CONDPRINTSTR:
     case STMCI:
       execute(Proc);
@@ -173,6 +173,9 @@ inline void Instruction::execute_big_domain_instructions(Processor<sint, sgf2n>&
 #define X(NAME, PRE, CODE) \
         case NAME: { PRE; for (int i = 0; i < size; i++) { CODE; } } break;
       ARITHMETIC_INSTRUCTIONS_FOR_BIG_DOMAIN
+#undef X
+#define X(NAME, CODE) case NAME: CODE; break;
+      BIG_DOMAIN_KERNEL_INSTRUCTIONS
 #undef X
     default:
       cout << "instruction with code " << opcode << "  is not impletementd by big domain" << endl;
@@ -465,6 +468,13 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
           Proc.Procp.inverse_permutation(*this);
 
         return;
+      case RADIXSORT:
+      case GENRADIXPERM:
+        if (!Proc.change_domain)
+          Proc.Procp.radix_sort(*this);
+        else
+          Proc.Procp_2->radix_sort(*this);
+        return;
       case CHECK:
         {
           CheckJob job;
@@ -571,6 +581,9 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
       case STOPGRIND:
         CALLGRIND_STOP_INSTRUMENTATION;
         break;
+      case CHECKPOINT:
+        Proc.machine.checkpoint(Proc);
+        break;
       case NPLAYERS:
         Proc.write_Ci(r[0], Proc.P.num_players());
         break;
@@ -697,11 +710,146 @@ inline void Instruction::execute(Processor<sint, sgf2n>& Proc) const
   }
 }
 
+// CMD switches between the small and the big domain
+template<class sint, class sgf2n>
+void switch_domain(Processor<sint, sgf2n>& Proc)
+{
+  auto& Procp = Proc.Procp;
+  // only work when T is Rep3Share and one of the small domain size is smaller than 2^32
+  if (!Proc.change_domain){
+    Proc.change_domain = true;
+    Proc.start_subprocessor_for_big_domain();
+    auto& Procp_for_big_domain = *(Proc.Procp_2);
+    Procp_for_big_domain.template assign_S<sint>(Procp.get_S());
+    Procp_for_big_domain.template assign_C<sint>(Procp.get_C());
+  }
+  else{
+    Proc.change_domain = false;
+    auto& Procp_for_big_domain = *(Proc.Procp_2);
+    Procp.template assign_S<BigDomainShare>(Procp_for_big_domain.get_S());
+    Procp.template assign_C<BigDomainShare>(Procp_for_big_domain.get_C());
+    Proc.stop_subprocessor_for_big_domain();
+  }
+}
+
+#ifdef THREADED_DISPATCH
+template<class sint, class sgf2n>
+void Program::execute_threaded(Processor<sint, sgf2n>& Proc) const
+{
+  unsigned int size = p.size();
+
+  auto& Procp = Proc.Procp;
+  auto& Proc2 = Proc.Proc2;
+
+  // binary instructions
+  typedef typename sint::bit_type T;
+  auto& processor = Proc.Procb;
+  auto& Ci = Proc.get_Ci();
+
+  // same order as InstructionHandler
+  static const void* const labels[] = {
+      &&handle_END, &&handle_DEFAULT, &&handle_CMD, &&handle_CLEAR_GF2N,
+      &&handle_REGINT, &&handle_FUSED,
+#define X(NAME, PRE, CODE) &&handle_##NAME,
+      ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) &&handle_##NAME,
+      COMBI_INSTRUCTIONS
+#undef X
+  };
+  static_assert(sizeof(labels) / sizeof(labels[0]) == N_HANDLERS,
+      "label table does not match InstructionHandler");
+
+  auto handlers = this->handlers.data();
+
+// see Instruction.hpp
+#define DISPATCH goto *labels[handlers[Proc.PC]]
+#define DISPATCH_CHECKED \
+  goto *labels[Proc.PC < size ? handlers[Proc.PC] : int(HANDLER_END)]
+#define FETCH \
+  auto& instruction = p[Proc.PC]; \
+  auto& r = instruction.r; \
+  auto& n = instruction.n; \
+  auto& start = instruction.start; \
+  auto& size = instruction.size; \
+  (void) r, (void) n, (void) start, (void) size; \
+  Proc.PC++;
+
+  // a tape may start in the big domain
+  goto big_domain;
+
+#define X(NAME, PRE, CODE) \
+  handle_##NAME: { FETCH PRE; for (int i = 0; i < size; i++) { CODE; } } \
+  DISPATCH;
+  ARITHMETIC_INSTRUCTIONS
+#undef X
+#define X(NAME, CODE) handle_##NAME: { FETCH CODE; } DISPATCH_CHECKED;
+  COMBI_INSTRUCTIONS
+#undef X
+
+handle_CLEAR_GF2N:
+  {
+    FETCH
+    instruction.execute_clear_gf2n(Proc2.get_C(), Proc.machine.M2.MC, Proc);
+  }
+  DISPATCH_CHECKED;
+
+handle_REGINT:
+  {
+    FETCH
+    instruction.execute_regint(Proc, Proc.machine.Mi.MC);
+  }
+  DISPATCH_CHECKED;
+
+handle_FUSED:
+  execute_fused(Proc, Proc.PC);
+  Proc.PC += fused[Proc.PC];
+  DISPATCH;
+
+handle_DEFAULT:
+  {
+    FETCH
+    instruction.execute(Proc);
+  }
+  DISPATCH_CHECKED;
+
+handle_CMD:
+  Proc.PC++;
+  switch_domain(Proc);
+big_domain:
+  // everything up to the next CMD runs in the big domain
+  while (Proc.change_domain and Proc.PC < size)
+    {
+      auto& instruction = p[Proc.PC++];
+      if (instruction.get_opcode() == CMD)
+        switch_domain(Proc);
+      else
+        instruction.execute_big_domain_instructions(Proc);
+    }
+  DISPATCH_CHECKED;
+
+#undef FETCH
+#undef DISPATCH_CHECKED
+#undef DISPATCH
+
+handle_END:
+  return;
+}
+#endif
+
 template<class sint, class sgf2n>
 void Program::execute(Processor<sint, sgf2n>& Proc) const
 {
+#ifdef THREADED_DISPATCH
+  // the switch below remains for profiling
+  if (not Proc.profiler.active())
+    {
+      execute_threaded(Proc);
+      return;
+    }
+#endif
+
   unsigned int size = p.size();
-  Proc.PC=0;
 
   auto& Procp = Proc.Procp;
   auto& Proc2 = Proc.Proc2;
@@ -720,6 +868,9 @@ void Program::execute(Processor<sint, sgf2n>& Proc) const
       auto& size = instruction.size;
       (void) start;
 
+      InstructionProfilerScope profile(Proc.profiler,
+          instruction.get_opcode(), Proc.PC, Proc.P);
+
 #ifdef COUNT_INSTRUCTIONS
 #ifdef TIME_INSTRUCTIONS
       RunningTimer timer;
@@ -735,23 +886,7 @@ void Program::execute(Processor<sint, sgf2n>& Proc) const
 
       Proc.PC++;
       if (instruction.get_opcode() == CMD){
-        // only work when T is Rep3Share and one of the small domain size is smaller than 2^32
-        if (!Proc.change_domain){
-          Proc.change_domain = true;
-          Proc.start_subprocessor_for_big_domain();
-          auto& Procp_for_big_domain = *(Proc.Procp_2);
-          Procp_for_big_domain.template assign_S<sint>(Procp.get_S());
-          Procp_for_big_domain.template assign_C<sint>(Procp.get_C());
-//          cout << "Proc.machine.Mp.MS.size() = " << Proc.machine.Mp.MS.size() << endl;
-//          cout << "Proc.machine.Mp_2->MS.size() = " << Proc.machine.Mp_2->MS.size() << endl;
-        }
-        else{
-          Proc.change_domain = false;
-          auto& Procp_for_big_domain = *(Proc.Procp_2);
-          Procp.template assign_S<BigDomainShare>(Procp_for_big_domain.get_S());
-          Procp.template assign_C<BigDomainShare>(Procp_for_big_domain.get_C());
-          Proc.stop_subprocessor_for_big_domain();
-        }
+        switch_domain(Proc);
         continue;
       }
       if (Proc.change_domain){
@@ -0,0 +1,101 @@
+/*
+ * LocalWorkers.cpp
+ *
+ */
+
+#include "LocalWorkers.h"
+#include "BaseMachine.h"
+#include "OnlineOptions.h"
+
+#include <memory>
+
+static thread_local bool in_local_thread = false;
+
+int LocalWorkers::Job::run()
+{
+    // not thread 0 even if started by it
+    BaseMachine::thread_num = -1;
+    in_local_thread = true;
+    try
+    {
+        (*range)(begin, end);
+    }
+    catch (...)
+    {
+        error = current_exception();
+    }
+    return 0;
+}
+
+LocalWorkers::LocalWorkers(int n_threads) :
+        jobs(n_threads - 1)
+{
+    for (int i = 1; i < n_threads; i++)
+        workers.push_back(new Worker<Job>);
+}
+
+LocalWorkers::~LocalWorkers()
+{
+    for (auto worker : workers)
+        delete worker;
+}
+
+void LocalWorkers::run(int n, const function<void(int, int)>& range)
+{
+    int n_parts = min(size(), n);
+    if (n_parts < 1)
+        return;
+    // the calling thread takes the first part
+    for (int i = 1; i < n_parts; i++)
+    {
+        auto& job = jobs[i - 1];
+        job.range = &range;
+        job.begin = n * i / n_parts;
+        job.end = n * (i + 1) / n_parts;
+        job.error = nullptr;
+        workers[i - 1]->request(job);
+    }
+    // nested calls from the first part run directly
+    bool was_local = in_local_thread;
+    in_local_thread = true;
+    exception_ptr error;
+    try
+    {
+        range(0, n / n_parts);
+    }
+    catch (...)
+    {
+        error = current_exception();
+    }
+    in_local_thread = was_local;
+    for (int i = 1; i < n_parts; i++)
+    {
+        workers[i - 1]->done();
+        if (not error)
+            error = jobs[i - 1].error;
+    }
+    if (error)
+        rethrow_exception(error);
+}
+
+void LocalWorkers::run_local(int n, const function<void(int, int)>& range)
+{
+    thread_local unique_ptr<LocalWorkers> workers;
+    int n_threads = OnlineOptions::singleton.local_threads;
+    if (in_local_thread or n_threads < 2)
+    {
+        range(0, n);
+        return;
+    }
+    if (not workers)
+        workers.reset(new LocalWorkers(n_threads));
+    workers->run(n, range);
+}
+
+int LocalWorkers::local_size()
+{
+    if (in_local_thread)
+        return 1;
+    else
+        return max(1, OnlineOptions::singleton.local_threads);
+}
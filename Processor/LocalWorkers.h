@@ -0,0 +1,53 @@
+/*
+ * LocalWorkers.h
+ *
+ */
+
+#ifndef PROCESSOR_LOCALWORKERS_H_
+#define PROCESSOR_LOCALWORKERS_H_
+
+#include "Tools/time-func.h"
+#include "Tools/Worker.h"
+
+#include <functional>
+#include <exception>
+#include <vector>
+using namespace std;
+
+/**
+ * Persistent threads of a processor thread that execute parts of large
+ * local instructions (``--local-threads``)
+ */
+class LocalWorkers
+{
+    class Job
+    {
+    public:
+        const function<void(int, int)>* range;
+        int begin, end;
+        exception_ptr error;
+
+        int run();
+    };
+
+    vector<Worker<Job>*> workers;
+    vector<Job> jobs;
+
+public:
+    LocalWorkers(int n_threads);
+    ~LocalWorkers();
+
+    /// number of threads including the caller
+    int size() const { return workers.size() + 1; }
+
+    /// call ``range(begin, end)`` on a partition of ``[0, n)``
+    void run(int n, const function<void(int, int)>& range);
+
+    /// ``run()`` on threads owned by the calling thread, or directly
+    /// if called from a local thread
+    static void run_local(int n, const function<void(int, int)>& range);
+    /// number of threads used by ``run_local()``
+    static int local_size();
+};
+
+#endif /* PROCESSOR_LOCALWORKERS_H_ */
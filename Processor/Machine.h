@@ -68,6 +68,7 @@ class Machine : public BaseMachine
 
   vector<Timer> join_timer;
   Timer finish_timer;
+  Timer checkpoint_timer;
 
   bool direct;
   int opening_sum;
@@ -79,6 +80,7 @@ class Machine : public BaseMachine
   OnlineOptions opts;
 
   ExecutionStats stats;
+  InstructionProfiler profiler;
 
   static void init_binary_domains(int security_parameter, int lg2);
 
@@ -108,6 +110,11 @@ class Machine : public BaseMachine
   pair<DataPositions, NamedCommStats> stop_threads();
 
   string memory_filename();
+  string checkpoint_filename();
+
+  /// Memory and main thread registers, only between tapes
+  void checkpoint(Processor<sint, sgf2n>& Proc);
+  void restore(Processor<sint, sgf2n>& Proc);
 
   template<class T>
   string prep_dir_prefix();
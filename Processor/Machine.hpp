@@ -102,6 +102,8 @@ Machine<sint, sgf2n>::Machine(Names& playerNames, bool use_encryption,
   // for OT-based preprocessing
   sint::clear::next::template init<typename sint::clear>(false);
 
+  checkpoint_timer.start();
+
   // Initialize the global memory
   auto memtype = opts.memtype;
   if (memtype.compare("old")==0)
@@ -551,6 +553,14 @@ void Machine<sint, sgf2n>:: run(const string& progname)
       stats.print();
     }
 
+  if (not opts.profile_file.empty())
+    {
+      profiler.print(bc_filenames);
+      profiler.write_trace(
+          opts.profile_file + "-P" + to_string(my_number) + ".json",
+          my_number, bc_filenames);
+    }
+
   if (not opts.file_prep_per_thread)
     {
       Data_Files<sint, sgf2n> df(*this);
@@ -571,6 +581,104 @@ string Machine<sint, sgf2n>::memory_filename()
   return BaseMachine::memory_filename(sint::type_short(), my_number);
 }
 
+template<class sint, class sgf2n>
+string Machine<sint, sgf2n>::checkpoint_filename()
+{
+  return BaseMachine::checkpoint_filename(sint::type_short(), my_number);
+}
+
+template<class sint, class sgf2n>
+void Machine<sint, sgf2n>::checkpoint(Processor<sint, sgf2n>& Proc)
+{
+  if (opts.checkpoint_interval < 0)
+    return;
+
+  if (Proc.thread_num != 0)
+    throw runtime_error("checkpoints are only possible in the main thread");
+  for (size_t i = 1; i < queues.size(); i++)
+    if (not queues[i]->available())
+      throw runtime_error("checkpoints are only possible between tapes");
+
+  // everyone follows the timer of the first party
+  auto& P = Proc.P;
+  octetStream os;
+  if (P.my_num() == 0)
+    {
+      os.store(int(checkpoint_timer.elapsed() >= opts.checkpoint_interval));
+      P.send_all(os);
+    }
+  else
+    P.receive_player(0, os);
+  if (not os.get<int>())
+    return;
+
+  // no unchecked values in the checkpoint
+  Proc.check();
+
+  os.reset_write_head();
+  os.store(progname);
+  os.store(progs[0].size());
+  Proc.pack_state(os);
+  pack_registers(os, bit_memories.MS);
+  pack_registers(os, bit_memories.MC);
+
+  // replace the previous checkpoint only when complete
+  string filename = checkpoint_filename();
+  string tmp_filename = filename + "~";
+  ofstream outf(tmp_filename, ios::out | ios::binary);
+  file_signature<sint>().output(outf);
+  os.output(outf);
+  outf << M2 << Mp << Mi;
+#ifdef BIG_DOMAIN_FOR_RING
+  outf << *Mp_2;
+#endif
+  outf << 'M';
+  outf.close();
+  if (outf.fail() or rename(tmp_filename.c_str(), filename.c_str()))
+    throw file_error(filename);
+
+  if (opts.verbose)
+    cerr << "Wrote checkpoint after " << checkpoint_timer.elapsed()
+        << " seconds" << endl;
+  checkpoint_timer.reset();
+}
+
+template<class sint, class sgf2n>
+void Machine<sint, sgf2n>::restore(Processor<sint, sgf2n>& Proc)
+{
+  // reusing preprocessing from files would be insecure
+  if (not live_prep)
+    throw runtime_error("restoring requires live preprocessing");
+
+  string filename = checkpoint_filename();
+  ifstream inpf(filename, ios::in | ios::binary);
+  if (inpf.fail())
+    throw file_error(filename);
+  check_file_signature<sint>(inpf, filename);
+
+  octetStream os;
+  os.input(inpf);
+  string name;
+  size_t size;
+  os.get(name);
+  os.get(size);
+  if (name != progname or size != progs[0].size())
+    throw runtime_error(filename + " belongs to a different program");
+  Proc.unpack_state(os);
+  unpack_registers(os, bit_memories.MS);
+  unpack_registers(os, bit_memories.MC);
+
+  inpf >> M2 >> Mp >> Mi;
+#ifdef BIG_DOMAIN_FOR_RING
+  inpf >> *Mp_2;
+#endif
+  if (inpf.get() != 'M')
+    throw file_error(filename);
+
+  cerr << "Resuming " << progname << " at instruction " << Proc.PC
+      << " of the main tape" << endl;
+}
+
 template<class sint, class sgf2n>
 template<class T>
 string Machine<sint, sgf2n>::prep_dir_prefix()
@@ -102,6 +102,9 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
   processor = new Processor<sint, sgf2n>(tinfo->thread_num,P,*MC2,*MCp,machine,progs.at(thread_num > 0));
   auto& Proc = *processor;
 
+  if (not machine.opts.profile_file.empty())
+    Proc.profiler.activate(num);
+
   // don't count communication for initialization
   P.reset_stats();
 
@@ -270,9 +273,16 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
           Proc.DataF.seekg(job.pos);
           // reset for actual usage
           Proc.DataF.reset_usage();
+
+          if (num == 0 and program == 0 and machine.opts.restore)
+            {
+              machine.restore(Proc);
+              machine.opts.restore = false;
+            }
              
           //printf("\tExecuting program");
           // Execute the program
+          Proc.profiler.set_tape(program);
           progs[program].execute(Proc);
 
           // make sure values used in other threads are safe
@@ -332,6 +342,7 @@ void thread_info<sint, sgf2n>::Sub_Main_Func()
 
   // wind down thread by thread
   machine.stats += Proc.stats;
+  machine.profiler.merge(Proc.profiler);
   // prevent faulty usage message
   Proc.DataF.set_usage(actual_usage);
   delete processor;
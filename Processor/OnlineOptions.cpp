@@ -35,6 +35,9 @@ OnlineOptions::OnlineOptions() : playerno(-1)
     opening_sum = 0;
     max_broadcast = 0;
     receive_threads = false;
+    local_threads = 1;
+    checkpoint_interval = -1;
+    restore = false;
 #ifdef VERBOSE
     verbose = true;
 #else
@@ -99,6 +102,43 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
             "-v", // Flag token.
             "--verbose" // Flag token.
     );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Profile instructions and write a trace to <prefix>-P<party>.json", // Help description.
+            "-prof", // Flag token.
+            "--profile" // Flag token.
+    );
+    opt.add(
+            "1", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Threads per tape thread for long local vector instructions (default: 1)", // Help description.
+            "-lt", // Flag token.
+            "--local-threads" // Flag token.
+    );
+    opt.add(
+            "-1", // Default.
+            0, // Required?
+            1, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Write checkpoint at checkpoint instructions at most every <seconds> "
+            "(default: -1 for never)", // Help description.
+            "-cp", // Flag token.
+            "--checkpoint" // Flag token.
+    );
+    opt.add(
+            "", // Default.
+            0, // Required?
+            0, // Number of args expected.
+            0, // Delimiter if expecting multiple args.
+            "Resume main tape from last checkpoint (requires live preprocessing)", // Help description.
+            "-rs", // Flag token.
+            "--restore" // Flag token.
+    );
     opt.add(
             "4", // Default.
             0, // Required?
@@ -134,6 +174,11 @@ OnlineOptions::OnlineOptions(ez::ezOptionParser& opt, int argc,
     verbose = opt.isSet("--verbose");
 #endif
 
+    opt.get("--profile")->getString(profile_file);
+    opt.get("--local-threads")->getInt(local_threads);
+    opt.get("--checkpoint")->getInt(checkpoint_interval);
+    restore = opt.isSet("--restore");
+
     if (security)
     {
         opt.get("-S")->getInt(security_parameter);
@@ -34,6 +34,10 @@ public:
     int trunc_error;
     int opening_sum, max_broadcast;
     bool receive_threads;
+    std::string profile_file;
+    int local_threads;
+    int checkpoint_interval;
+    bool restore;
 
     OnlineOptions();
     OnlineOptions(ez::ezOptionParser& opt, int argc, const char** argv,
@@ -18,6 +18,7 @@
 #include "Binary_File_IO.h"
 #include "Instruction.h"
 #include "ProcessorBase.h"
+#include "LocalWorkers.h"
 #include "OnlineOptions.h"
 #include "Tools/SwitchableOutput.h"
 #include "Tools/CheckVector.h"
@@ -93,6 +94,7 @@ public:
   void apply_shuffle(const Instruction &instruction, int handle);
   void delete_shuffle(int handle);
   void inverse_permutation(const Instruction &instruction);
+  void radix_sort(const Instruction &instruction);
 
   // void psi(const vector<typename T::clear> &source, const Instruction &instruction, U &proc)
   // {
@@ -180,6 +182,8 @@ class ArithmeticProcessor : public ProcessorBase
 protected:
   CheckVector<long> Ci;
 
+  LocalWorkers *local_workers;
+
 public:
   int thread_num;
 
@@ -203,11 +207,20 @@ public:
   ArithmeticProcessor() : ArithmeticProcessor(OnlineOptions::singleton, BaseMachine::thread_num)
   {
   }
-  ArithmeticProcessor(OnlineOptions opts, int thread_num) : thread_num(thread_num),
+  ArithmeticProcessor(OnlineOptions opts, int thread_num) : local_workers(0), thread_num(thread_num),
                                                             sent(0), rounds(0), opts(opts) {}
 
   virtual ~ArithmeticProcessor()
   {
+    delete local_workers;
+  }
+
+  // null unless running with several local threads
+  LocalWorkers *get_local_workers()
+  {
+    if (not local_workers and opts.local_threads > 1)
+      local_workers = new LocalWorkers(opts.local_threads);
+    return local_workers;
   }
 
   bool use_stdin()
@@ -277,6 +290,10 @@ public:
   Binary_File_IO binary_file_io;
 
   void reset(const Program &program, int arg); // Reset the state of the processor
+
+  // registers and program counter for checkpoints
+  void pack_state(octetStream &os) const;
+  void unpack_state(octetStream &os);
   string get_filename(const char *basename, bool use_number);
 
   Processor(int thread_num, Player &P,
@@ -400,9 +417,9 @@ public:
   GC::Processor<typename sint::bit_type> Procb;
   SubProcessor<sgf2n> Proc2;
   SubProcessor<sint> Procp;
-  SubProcessor<BigDomainShare> *Procp_2;
-  Preprocessing<BigDomainShare> *datafp;
-  BigDomainShare::MAC_Check *temp_mcp;
+  SubProcessor<BigDomainShare> *Procp_2 = 0;
+  Preprocessing<BigDomainShare> *datafp = 0;
+  BigDomainShare::MAC_Check *temp_mcp = 0;
 
   unsigned int PC;
   TempVars<sint, sgf2n> temp;
@@ -411,6 +428,10 @@ public:
   Binary_File_IO binary_file_io;
 
   void reset(const Program &program, int arg); // Reset the state of the processor
+
+  // registers and program counter for checkpoints
+  void pack_state(octetStream &os) const;
+  void unpack_state(octetStream &os);
   string get_filename(const char *basename, bool use_number);
 
   Processor(int thread_num, Player &P,
@@ -10,6 +10,7 @@
 #include "GC/Processor.hpp"
 #include "GC/ShareThread.hpp"
 #include "Protocols/SecureShuffle.hpp"
+#include "Protocols/OTShuffler.hpp"
 #include "Conv2dTuple.h"
 #include "MatmulsTuple.h"
 #include "MatmulsmTuple.h"
@@ -133,6 +134,107 @@ void Processor<sint, sgf2n>::reset(const Program &program, int arg)
   Ci.resize(program.num_reg(INT));
   this->arg = arg;
   Procb.reset(program);
+  PC = 0;
+}
+
+// not all share types support serialization
+template <class T>
+auto pack_register(octetStream &os, const T &x, int) -> decltype(x.pack(os), void())
+{
+  x.pack(os);
+}
+
+template <class T>
+void pack_register(octetStream &, const T &, long)
+{
+  throw runtime_error("checkpoints not supported with this share type");
+}
+
+template <class T>
+auto unpack_register(octetStream &os, T &x, int) -> decltype(x.unpack(os), void())
+{
+  x.unpack(os);
+}
+
+template <class T>
+void unpack_register(octetStream &, T &, long)
+{
+  throw runtime_error("checkpoints not supported with this share type");
+}
+
+template <class T>
+void pack_registers(octetStream &os, const vector<T> &registers)
+{
+  os.store(registers.size());
+  for (auto &x : registers)
+    pack_register(os, x, 0);
+}
+
+template <class T>
+void unpack_registers(octetStream &os, vector<T> &registers)
+{
+  size_t size;
+  os.get(size);
+  registers.resize(size);
+  for (auto &x : registers)
+    unpack_register(os, x, 0);
+}
+
+template <class sint, class sgf2n>
+void Processor<sint, sgf2n>::pack_state(octetStream &os) const
+{
+  os.store(PC);
+  os.store(arg);
+  os.store(Ci.size());
+  for (auto x : Ci)
+    os.store_int(x, 8);
+  pack_registers(os, Procp.S);
+  pack_registers(os, Procp.C);
+  pack_registers(os, Proc2.S);
+  pack_registers(os, Proc2.C);
+  pack_registers(os, Procb.S);
+  pack_registers(os, Procb.C);
+  pack_registers(os, Procb.I);
+#ifdef BIG_DOMAIN_FOR_RING
+  // the big-domain registers only exist after switching
+  os.store(int(change_domain));
+  if (change_domain)
+    {
+      pack_registers(os, Procp_2->S);
+      pack_registers(os, Procp_2->C);
+    }
+#endif
+}
+
+template <class sint, class sgf2n>
+void Processor<sint, sgf2n>::unpack_state(octetStream &os)
+{
+  os.get(PC);
+  os.get(arg);
+  size_t size;
+  os.get(size);
+  Ci.resize(size);
+  for (auto &x : Ci)
+    x = os.get_int(8);
+  unpack_registers(os, Procp.S);
+  unpack_registers(os, Procp.C);
+  unpack_registers(os, Proc2.S);
+  unpack_registers(os, Proc2.C);
+  unpack_registers(os, Procb.S);
+  unpack_registers(os, Procb.C);
+  unpack_registers(os, Procb.I);
+#ifdef BIG_DOMAIN_FOR_RING
+  change_domain = os.get<int>();
+  if (change_domain)
+    {
+      if (not Procp_2)
+        start_subprocessor_for_big_domain();
+      unpack_registers(os, Procp_2->S);
+      unpack_registers(os, Procp_2->C);
+    }
+  else if (Procp_2)
+    stop_subprocessor_for_big_domain();
+#endif
 }
 
 template <class T>
@@ -919,6 +1021,18 @@ void SubProcessor<T>::inverse_permutation(const Instruction &instruction)
                                instruction.get_start()[1]);
 }
 
+template <class T>
+void SubProcessor<T>::radix_sort(const Instruction &instruction)
+{
+  if (instruction.get_opcode() == RADIXSORT)
+    shuffler.radix_sort(S, instruction.get_size(), instruction.get_r(0),
+                        instruction.get_r(1), instruction.get_r(2),
+                        instruction.get_n(), false);
+  else
+    shuffler.radix_sort(S, instruction.get_size(), instruction.get_r(0), 0,
+                        instruction.get_r(1), instruction.get_n(), true);
+}
+
 template <class T>
 void SubProcessor<T>::input_personal(const vector<int> &args)
 {
@@ -1071,6 +1185,9 @@ void Processor<sint, sgf2n>::stop_subprocessor_for_big_domain()
   delete this->Procp_2;
   delete this->datafp;
   delete this->temp_mcp;
+  this->Procp_2 = 0;
+  this->datafp = 0;
+  this->temp_mcp = 0;
 };
 #endif
 
@@ -12,6 +12,7 @@
 using namespace std;
 
 #include "Tools/ExecutionStats.h"
+#include "InstructionProfiler.h"
 #include "Tools/SwitchableOutput.h"
 #include "OnlineOptions.h"
 
@@ -33,6 +34,7 @@ protected:
 
 public:
   ExecutionStats stats;
+  InstructionProfiler profiler;
 
   ofstream stdout_redirect_file;
 
@@ -49,6 +49,132 @@ void Program::parse(istream& s)
       s.peek();
     }
   compute_constants();
+  decode();
+}
+
+void Program::decode()
+{
+  handlers.resize(p.size() + 1);
+  for (size_t i = 0; i < p.size(); i++)
+    handlers[i] = instruction_handler(p[i].get_opcode());
+  handlers.back() = HANDLER_END;
+  fuse();
+}
+
+namespace
+{
+
+// register or memory range of a fusable instruction
+struct FusedAccess
+{
+  int space;
+  size_t base;
+  bool write;
+};
+
+// direct sint memory, as opposed to registers
+const int SINT_MEMORY = MAX_REG_TYPE;
+
+bool fused_accesses(const Instruction& instruction,
+    vector<FusedAccess>& accesses)
+{
+  int r0 = instruction.get_r(0), r1 = instruction.get_r(1),
+      r2 = instruction.get_r(2);
+  switch (instruction.get_opcode())
+  {
+  case ADDS:
+  case SUBS:
+    accesses = {{SINT, size_t(r0), true}, {SINT, size_t(r1), false},
+        {SINT, size_t(r2), false}};
+    return true;
+  case ADDM:
+  case SUBML:
+  case MULM:
+    accesses = {{SINT, size_t(r0), true}, {SINT, size_t(r1), false},
+        {CINT, size_t(r2), false}};
+    return true;
+  case SUBMR:
+    accesses = {{SINT, size_t(r0), true}, {CINT, size_t(r1), false},
+        {SINT, size_t(r2), false}};
+    return true;
+  case ADDC:
+  case SUBC:
+  case MULC:
+    accesses = {{CINT, size_t(r0), true}, {CINT, size_t(r1), false},
+        {CINT, size_t(r2), false}};
+    return true;
+  case MOVS:
+  case ADDSI:
+  case SUBSI:
+  case SUBSFI:
+  case MULSI:
+    accesses = {{SINT, size_t(r0), true}, {SINT, size_t(r1), false}};
+    return true;
+  case ADDCI:
+  case SUBCI:
+  case SUBCFI:
+  case MULCI:
+  case SHLCI:
+  case SHRCI:
+    accesses = {{CINT, size_t(r0), true}, {CINT, size_t(r1), false}};
+    return true;
+  case LDMS:
+    accesses = {{SINT, size_t(r0), true},
+        {SINT_MEMORY, instruction.get_n(), false}};
+    return true;
+  case STMS:
+    accesses = {{SINT, size_t(r0), false},
+        {SINT_MEMORY, instruction.get_n(), true}};
+    return true;
+  default:
+    return false;
+  }
+}
+
+// running the instructions block by block, possibly in parallel, is
+// only equivalent if every element depends on the same element of
+// the instruction's inputs
+bool fusion_compatible(const vector<FusedAccess>& group,
+    const vector<FusedAccess>& accesses, size_t size)
+{
+  for (auto& x : accesses)
+    for (auto& y : group)
+      if (x.space == y.space and (x.write or y.write) and x.base != y.base
+          and x.base < y.base + size and y.base < x.base + size)
+        return false;
+  return true;
+}
+
+}
+
+void Program::fuse()
+{
+  fused.assign(p.size(), 0);
+  vector<FusedAccess> group, accesses;
+  size_t i = 0;
+  while (i < p.size())
+    {
+      size_t j = i;
+      group.clear();
+      // shorter vectors are processed in one block anyway
+      while (p[i].get_size() > FUSION_BLOCK_SIZE
+          and j < p.size() and j - i < MAX_FUSED
+          and p[j].get_size() == p[i].get_size()
+          and fused_accesses(p[j], accesses)
+          and fusion_compatible(accesses, accesses, p[i].get_size())
+          and fusion_compatible(group, accesses, p[i].get_size()))
+        {
+          group.insert(group.end(), accesses.begin(), accesses.end());
+          j++;
+        }
+      // long instructions on their own may still run in parallel
+      if (j - i > 1 or (j > i and p[i].get_size() >= PARALLEL_THRESHOLD))
+        {
+          fused[i] = j - i;
+          handlers[i] = HANDLER_FUSED;
+        }
+      i = max(j, i + 1);
+    }
 }
 
 void Program::print_offline_cost() const
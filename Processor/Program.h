@@ -26,10 +26,30 @@ class Program
   // True if program contains variable-sized loop
   bool unknown_usage;
 
+  // InstructionHandler per instruction plus HANDLER_END, so that
+  // falling off the end needs no bounds check in threaded dispatch
+  vector<unsigned short> handlers;
+
+  // length of a fused sequence of local instructions starting here
+  vector<unsigned char> fused;
+
   void compute_constants();
+  void decode();
+  void fuse();
+
+  template<class sint, class sgf2n>
+  void execute_threaded(Processor<sint, sgf2n>& Proc) const;
+  template<class sint, class sgf2n>
+  void execute_fused(Processor<sint, sgf2n>& Proc, int begin) const;
 
   public:
 
+  static const int MAX_FUSED = 16;
+  // elements per pass over the fused instructions
+  static const int FUSION_BLOCK_SIZE = 256;
+  // minimal vector size for running on local worker threads
+  static const int PARALLEL_THRESHOLD = 1 << 15;
+
   bool writes_persistence;
 
   Program(int nplayers) : offline_data_used(nplayers),
@@ -7,6 +7,7 @@
 #define PROCESSOR_INSTRUCTIONS_H_
 
 #include "Instruction.h"
+#include "Math/FieldKernels.h"
 
 
 #define ARITHMETIC_INSTRUCTIONS \
@@ -66,18 +67,14 @@
     X(PREFIXSUMS, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
             sint s, \
             s += *op1++; *dest++ = s) \
-    X(MULM, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ * *op2++) \
-    X(MULC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            auto op2 = &Procp.get_C()[r[2]], \
-            *dest++ = *op1++ * *op2++) \
-    X(MULCI, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
-            typename sint::clear op2 = int(n), \
-            *dest++ = *op1++ * op2) \
-    X(MULSI, auto dest = &Procp.get_S()[r[0]]; auto op1 = &Procp.get_S()[r[1]]; \
-            typename sint::clear op2 = int(n), \
-            *dest++ = *op1++ * op2) \
+    X(MULM, FieldKernels<typename sint::clear>::mul(&Procp.get_S()[r[0]], \
+            &Procp.get_S()[r[1]], &Procp.get_C()[r[2]], size), ) \
+    X(MULC, FieldKernels<typename sint::clear>::mul(&Procp.get_C()[r[0]], \
+            &Procp.get_C()[r[1]], &Procp.get_C()[r[2]], size), ) \
+    X(MULCI, FieldKernels<typename sint::clear>::mul(&Procp.get_C()[r[0]], \
+            &Procp.get_C()[r[1]], typename sint::clear(int(n)), size), ) \
+    X(MULSI, FieldKernels<typename sint::clear>::mul(&Procp.get_S()[r[0]], \
+            &Procp.get_S()[r[1]], typename sint::clear(int(n)), size), ) \
     X(ANDC, auto dest = &Procp.get_C()[r[0]]; auto op1 = &Procp.get_C()[r[1]]; \
             auto op2 = &Procp.get_C()[r[2]], \
             *dest++ = *op1++ & *op2++) \
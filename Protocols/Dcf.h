@@ -0,0 +1,66 @@
+/*
+ * Dcf.h
+ *
+ */
+
+#ifndef PROTOCOLS_DCF_H_
+#define PROTOCOLS_DCF_H_
+
+#include "Tools/random.h"
+#include "Tools/octetStream.h"
+
+#include <array>
+#include <vector>
+using namespace std;
+
+/**
+ * Key of a distributed comparison function (Boyle et al., Eurocrypt 2021)
+ * on ``n_bits``-bit inputs of type ``T`` with outputs in ``V``. The outputs
+ * of the two keys add up to ``beta`` if the input is smaller than
+ * ``alpha`` (both taken as unsigned integers) and to zero otherwise.
+ */
+template<class T, class V = T>
+class DcfKey
+{
+    typedef array<octet, SEED_SIZE> Seed;
+
+    // expansion of a seed into left and right child
+    struct Node
+    {
+        Seed seed[2];
+        V value[2];
+        bool control[2];
+    };
+
+    struct CorrectionWord
+    {
+        Seed seed;
+        V value;
+        bool control[2];
+    };
+
+    int party;
+    Seed seed;
+    vector<CorrectionWord> cws;
+    V final_cw;
+
+    static void expand(Node& res, const Seed& seed);
+    static V convert(const Seed& seed);
+
+public:
+    static void generate(array<DcfKey, 2>& keys, const T& alpha,
+            const V& beta, int n_bits, PRNG& G);
+
+    DcfKey() : party(0) {}
+
+    /// share of ``beta * (x < alpha)`` for the party holding this key
+    V evaluate(const T& x) const;
+
+    /// comparison as unsigned integers like the keys
+    static bool less_than(const T& x, const T& y);
+
+    void pack(octetStream& os) const;
+    void unpack(octetStream& os);
+};
+
+#endif /* PROTOCOLS_DCF_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Dcf.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_DCF_HPP_
+#define PROTOCOLS_DCF_HPP_
+
+#include "Dcf.h"
+
+template<class T, class V>
+void DcfKey<T, V>::expand(Node& res, const Seed& seed)
+{
+    PRNG G;
+    G.SetSeed(seed.data());
+    for (int i = 0; i < 2; i++)
+    {
+        G.get_octets(res.seed[i].data(), SEED_SIZE);
+        res.value[i].randomize(G);
+        res.control[i] = G.get_bit();
+    }
+}
+
+template<class T, class V>
+V DcfKey<T, V>::convert(const Seed& seed)
+{
+    PRNG G;
+    G.SetSeed(seed.data());
+    V res;
+    res.randomize(G);
+    return res;
+}
+
+template<class T, class V>
+void DcfKey<T, V>::generate(array<DcfKey, 2>& keys, const T& alpha,
+        const V& beta, int n_bits, PRNG& G)
+{
+    Seed seeds[2];
+    bool controls[2] = {false, true};
+    for (int b = 0; b < 2; b++)
+    {
+        G.get_octets(seeds[b].data(), SEED_SIZE);
+        keys[b].party = b;
+        keys[b].seed = seeds[b];
+        keys[b].cws.resize(n_bits);
+    }
+
+    V value_alpha;
+    for (int i = 0; i < n_bits; i++)
+    {
+        bool keep = alpha.get_bit(n_bits - i - 1);
+        bool lose = not keep;
+
+        Node nodes[2];
+        for (int b = 0; b < 2; b++)
+            expand(nodes[b], seeds[b]);
+
+        CorrectionWord cw;
+        for (int j = 0; j < SEED_SIZE; j++)
+            cw.seed[j] = nodes[0].seed[lose][j] ^ nodes[1].seed[lose][j];
+
+        cw.value = nodes[1].value[lose] - nodes[0].value[lose] - value_alpha;
+        // leaving the path to the left means the input is smaller
+        if (lose == 0)
+            cw.value += beta;
+        // the party with control bit set subtracts the correction
+        if (controls[1])
+            cw.value = V() - cw.value;
+        value_alpha += nodes[0].value[keep] - nodes[1].value[keep];
+        if (controls[1])
+            value_alpha -= cw.value;
+        else
+            value_alpha += cw.value;
+
+        cw.control[0] = nodes[0].control[0] ^ nodes[1].control[0] ^ keep ^ 1;
+        cw.control[1] = nodes[0].control[1] ^ nodes[1].control[1] ^ keep;
+
+        for (int b = 0; b < 2; b++)
+        {
+            seeds[b] = nodes[b].seed[keep];
+            if (controls[b])
+                for (int j = 0; j < SEED_SIZE; j++)
+                    seeds[b][j] ^= cw.seed[j];
+            controls[b] = nodes[b].control[keep]
+                    ^ (controls[b] and cw.control[keep]);
+        }
+
+        for (int b = 0; b < 2; b++)
+            keys[b].cws[i] = cw;
+    }
+
+    V final_cw = convert(seeds[1]) - convert(seeds[0]) - value_alpha;
+    if (controls[1])
+        final_cw = V() - final_cw;
+    for (int b = 0; b < 2; b++)
+        keys[b].final_cw = final_cw;
+}
+
+template<class T, class V>
+V DcfKey<T, V>::evaluate(const T& x) const
+{
+    int n_bits = cws.size();
+    Seed s = seed;
+    bool t = party;
+    V res;
+    for (int i = 0; i < n_bits; i++)
+    {
+        auto& cw = cws[i];
+        bool x_i = x.get_bit(n_bits - i - 1);
+        Node node;
+        expand(node, s);
+        res += node.value[x_i];
+        if (t)
+        {
+            res += cw.value;
+            for (int j = 0; j < SEED_SIZE; j++)
+                node.seed[x_i][j] ^= cw.seed[j];
+            node.control[x_i] ^= cw.control[x_i];
+        }
+        s = node.seed[x_i];
+        t = node.control[x_i];
+    }
+    res += convert(s);
+    if (t)
+        res += final_cw;
+    return party ? V() - res : res;
+}
+
+template<class T, class V>
+bool DcfKey<T, V>::less_than(const T& x, const T& y)
+{
+    for (int i = T::size_in_limbs() - 1; i >= 0; i--)
+        if (x.get_limb(i) != y.get_limb(i))
+            return x.get_limb(i) < y.get_limb(i);
+    return false;
+}
+
+template<class T, class V>
+void DcfKey<T, V>::pack(octetStream& os) const
+{
+    os.store(party);
+    os.serialize(seed);
+    os.store(cws.size());
+    for (auto& cw : cws)
+    {
+        os.serialize(cw.seed);
+        cw.value.pack(os);
+        os.store_int(cw.control[0] + 2 * cw.control[1], 1);
+    }
+    final_cw.pack(os);
+}
+
+template<class T, class V>
+void DcfKey<T, V>::unpack(octetStream& os)
+{
+    os.get(party);
+    os.unserialize(seed);
+    size_t size;
+    os.get(size);
+    cws.resize(size);
+    for (auto& cw : cws)
+    {
+        os.unserialize(cw.seed);
+        cw.value.unpack(os);
+        int control = os.get_int(1);
+        cw.control[0] = control & 1;
+        cw.control[1] = control >> 1;
+    }
+    final_cw.unpack(os);
+}
+
+#endif /* PROTOCOLS_DCF_HPP_ */
@@ -0,0 +1,64 @@
+/*
+ * DealerFss.h
+ *
+ */
+
+#ifndef PROTOCOLS_DEALERFSS_H_
+#define PROTOCOLS_DEALERFSS_H_
+
+#include "Hemi.h"
+#include "Dcf.h"
+
+#include <deque>
+#include <map>
+
+/**
+ * Two-party protocol with a dealer (the last party) that evaluates
+ * comparison, equality test, and truncation with function secret
+ * sharing. The dealer sends masks and comparison keys in batches
+ * ahead of use, so every such instruction only takes one exchange of
+ * masked inputs between the two computing parties.
+ */
+template<class T>
+class DealerFss : public Hemi<T>
+{
+    typedef typename T::clear clear;
+    typedef DcfKey<clear> key_type;
+
+    struct Tuple
+    {
+        // shares of the input mask and of a correction term
+        clear mask, offset;
+        vector<key_type> keys;
+    };
+
+    // by truncation shift, zero for comparisons
+    map<int, deque<Tuple>> tuples;
+    SeededPRNG G;
+
+    bool is_dealer();
+    void buffer(int m, size_t n);
+    void generate(Tuple (&res)[2], int m);
+
+    clear less_than(const key_type& key, const clear& masked,
+            const clear& below_mask, const clear& bound);
+
+    void cisc(SubProcessor<T>& processor, const Instruction& instruction,
+            true_type);
+    void cisc(SubProcessor<T>& processor, const Instruction& instruction,
+            false_type);
+
+public:
+    DealerFss(Player& P) :
+            Hemi<T>(P)
+    {
+    }
+
+    /**
+     * Handles ``LTZ``, ``EQZ`` and ``Trunc`` (exact) for any bit length
+     * up to the ring size.
+     */
+    void cisc(SubProcessor<T>& processor, const Instruction& instruction);
+};
+
+#endif /* PROTOCOLS_DEALERFSS_H_ */
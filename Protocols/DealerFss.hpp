@@ -0,0 +1,197 @@
+/*
+ * DealerFss.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_DEALERFSS_HPP_
+#define PROTOCOLS_DEALERFSS_HPP_
+
+#include "DealerFss.h"
+#include "Dcf.hpp"
+#include "Hemi.hpp"
+
+template<class T>
+bool DealerFss<T>::is_dealer()
+{
+    return this->P.my_num() == this->P.num_players() - 1;
+}
+
+template<class T>
+void DealerFss<T>::generate(Tuple (&res)[2], int m)
+{
+    int n_bits = clear::N_BITS;
+    clear r, offset;
+    r.randomize(G);
+    array<key_type, 2> keys[2];
+    if (m == 0)
+        key_type::generate(keys[0], r, 1, n_bits, G);
+    else
+    {
+        // wrap-around of the masked input and carry from the lower bits
+        offset = clear() - (r >> m);
+        key_type::generate(keys[0], r, clear(1) << (n_bits - m), n_bits, G);
+        key_type::generate(keys[1], r, clear() - 1, m, G);
+    }
+
+    res[0].mask.randomize(G);
+    res[0].offset.randomize(G);
+    res[1].mask = r - res[0].mask;
+    res[1].offset = offset - res[0].offset;
+    for (int b = 0; b < 2; b++)
+        for (int i = 0; i < 1 + (m > 0); i++)
+            res[b].keys.push_back(keys[i][b]);
+}
+
+template<class T>
+void DealerFss<T>::buffer(int m, size_t n)
+{
+    auto& buffer = tuples[m];
+    if (buffer.size() >= n)
+        return;
+
+    n = max(n - buffer.size(), size_t(OnlineOptions::singleton.batch_size));
+    auto& P = this->P;
+    if (is_dealer())
+    {
+        octetStream os[2];
+        for (size_t i = 0; i < n; i++)
+        {
+            Tuple pair[2];
+            generate(pair, m);
+            for (int b = 0; b < 2; b++)
+            {
+                pair[b].mask.pack(os[b]);
+                pair[b].offset.pack(os[b]);
+                for (auto& key : pair[b].keys)
+                    key.pack(os[b]);
+            }
+            buffer.push_back({});
+        }
+        for (int b = 0; b < 2; b++)
+            P.send_to(b, os[b]);
+    }
+    else
+    {
+        octetStream os;
+        P.receive_player(P.num_players() - 1, os);
+        for (size_t i = 0; i < n; i++)
+        {
+            buffer.push_back({});
+            auto& tuple = buffer.back();
+            tuple.mask.unpack(os);
+            tuple.offset.unpack(os);
+            tuple.keys.resize(1 + (m > 0));
+            for (auto& key : tuple.keys)
+                key.unpack(os);
+        }
+    }
+}
+
+template<class T>
+typename T::clear DealerFss<T>::less_than(const key_type& key,
+        const clear& masked, const clear& below_mask, const clear& bound)
+{
+    // the masked input is shifted by half the ring to compare as unsigned
+    clear shifted = bound + (clear(1) << (clear::N_BITS - 1));
+    auto res = key.evaluate(masked - shifted) - below_mask;
+    if (this->P.my_num() == 0 and key.less_than(masked, shifted))
+        res += 1;
+    return res;
+}
+
+template<class T>
+void DealerFss<T>::cisc(SubProcessor<T>& processor,
+        const Instruction& instruction)
+{
+    cisc(processor, instruction, T::clear::characteristic_two);
+}
+
+template<class T>
+void DealerFss<T>::cisc(SubProcessor<T>&, const Instruction&, true_type)
+{
+    throw not_implemented();
+}
+
+template<class T>
+void DealerFss<T>::cisc(SubProcessor<T>& processor,
+        const Instruction& instruction, false_type)
+{
+    auto& P = this->P;
+    if (P.num_players() != 3)
+        throw runtime_error("FSS requires two parties and a dealer");
+
+    int r0 = instruction.get_r(0);
+    string tag((char *) &r0, 4);
+    bool truncation = tag == "Trun";
+    if (tag != string("LTZ\0", 4) and tag != string("EQZ\0", 4)
+            and not truncation)
+        throw runtime_error("CISC instruction not supported by FSS: " + tag);
+
+    auto& args = instruction.get_start();
+    auto& S = processor.get_S();
+    auto shift = [&](size_t i) { return truncation ? args[i + 5] : 0; };
+
+    map<int, size_t> n_inputs;
+    for (size_t i = 0; i < args.size(); i += args[i])
+        n_inputs[shift(i)] += args[i + 1];
+    for (auto& x : n_inputs)
+        buffer(x.first, x.second);
+
+    int n_bits = clear::N_BITS;
+    clear half = clear(1) << (n_bits - 1);
+    int my_num = P.my_num();
+    vector<Tuple> used;
+    octetStream masked, other;
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        auto& buffer = tuples[shift(i)];
+        for (int k = 0; k < args[i + 1]; k++)
+        {
+            used.push_back(buffer.front());
+            buffer.pop_front();
+            if (is_dealer())
+                S[args[i + 2] + k] = {};
+            else
+                (S[args[i + 3] + k] + used.back().mask
+                        + (my_num == 0 ? half : clear())).pack(masked);
+        }
+    }
+
+    if (is_dealer())
+        return;
+
+    P.exchange(1 - my_num, masked, other);
+    auto tuple = used.begin();
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        int m = shift(i);
+        for (int k = 0; k < args[i + 1]; k++)
+        {
+            clear masked_input = masked.get<clear>() + other.get<clear>();
+            auto& key = tuple->keys[0];
+            clear res;
+            if (truncation and m == 0)
+                res = S[args[i + 3] + k];
+            else if (truncation)
+            {
+                res = key.evaluate(masked_input)
+                        + tuple->keys[1].evaluate(masked_input)
+                        + tuple->offset;
+                if (my_num == 0)
+                    res += (masked_input >> m)
+                            - (clear(1) << (n_bits - 1 - m));
+            }
+            else
+            {
+                auto below_mask = key.evaluate(masked_input);
+                res = less_than(key, masked_input, below_mask, 0);
+                if (tag[0] == 'E')
+                    res = less_than(key, masked_input, below_mask, 1) - res;
+            }
+            S[args[i + 2] + k] = res;
+            tuple++;
+        }
+    }
+}
+
+#endif /* PROTOCOLS_DEALERFSS_HPP_ */
@@ -14,7 +14,7 @@ template<class T> class DealerInput;
 template<class T> class DealerMC;
 template<class T> class DirectDealerMC;
 template<class T> class DealerMatrixPrep;
-template<class T> class Hemi;
+template<class T> class DealerFss;
 
 namespace GC
 {
@@ -34,7 +34,7 @@ public:
 
     typedef DealerMC<This> MAC_Check;
     typedef DirectDealerMC<This> Direct_MC;
-    typedef Hemi<This> Protocol;
+    typedef DealerFss<This> Protocol;
     typedef DealerInput<This> Input;
     typedef DealerPrep<This> LivePrep;
     typedef ::PrivateOutput<This> PrivateOutput;
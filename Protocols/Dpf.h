@@ -0,0 +1,72 @@
+/*
+ * Dpf.h
+ *
+ */
+
+#ifndef PROTOCOLS_DPF_H_
+#define PROTOCOLS_DPF_H_
+
+#include "Tools/random.h"
+#include "Tools/octetStream.h"
+#include "Tools/aes.h"
+#include "Math/gf2nlong.h"
+
+#include <array>
+#include <vector>
+using namespace std;
+
+/**
+ * Key of a distributed point function (Boyle et al., CCS 2016) on
+ * ``n_bits``-bit indices with outputs in ``T``. The outputs of the two
+ * keys add up to ``beta`` at ``alpha`` and to zero elsewhere. Seeds are
+ * expanded with fixed-key AES, which allows evaluating the whole domain
+ * in batches of block encryptions.
+ */
+template<class T>
+class DpfKey
+{
+    // two for the children and the rest for conversion to T
+    static const int N_KEYS = 6;
+
+    struct Schedule
+    {
+        octet keys[N_KEYS][176] __attribute__((aligned (16)));
+        Schedule();
+    };
+
+    struct CorrectionWord
+    {
+        __m128i seed;
+        bool control[2];
+    };
+
+    int party;
+    __m128i seed;
+    vector<CorrectionWord> cws;
+    T final_cw;
+
+    static const Schedule& schedule();
+
+    // out[i] = AES(in[i]) ^ in[i] with fixed key
+    static void hash(__m128i* out, const __m128i* in, size_t n, int key);
+
+    static bool control(__m128i& seed);
+    static void expand(__m128i (&res)[2], bool (&controls)[2], __m128i seed);
+    static void convert(T* res, const __m128i* seeds, size_t n);
+
+public:
+    static void generate(array<DpfKey, 2>& keys, size_t alpha, const T& beta,
+            int n_bits, PRNG& G);
+
+    DpfKey() : party(0), seed() {}
+
+    /// share of ``beta * (x == alpha)``
+    T evaluate(size_t x) const;
+    /// shares for all ``2^n_bits`` indices
+    void evaluate_all(vector<T>& res) const;
+
+    void pack(octetStream& os) const;
+    void unpack(octetStream& os);
+};
+
+#endif /* PROTOCOLS_DPF_H_ */
@@ -0,0 +1,237 @@
+/*
+ * Dpf.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_DPF_HPP_
+#define PROTOCOLS_DPF_HPP_
+
+#include "Dpf.h"
+
+template<class T>
+DpfKey<T>::Schedule::Schedule()
+{
+    for (int i = 0; i < N_KEYS; i++)
+    {
+        octet key[AES_BLK_SIZE] = {};
+        key[0] = i;
+        aes_schedule(keys[i], key);
+    }
+}
+
+template<class T>
+const typename DpfKey<T>::Schedule& DpfKey<T>::schedule()
+{
+    static Schedule res;
+    return res;
+}
+
+template<class T>
+void DpfKey<T>::hash(__m128i* out, const __m128i* in, size_t n, int key)
+{
+    auto& schedule = DpfKey<T>::schedule().keys[key];
+    __m128i tmp[8];
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        ecb_aes_128_encrypt<8>(tmp, in + i, schedule);
+        for (int j = 0; j < 8; j++)
+            out[i + j] = _mm_xor_si128(tmp[j], in[i + j]);
+    }
+    for (; i < n; i++)
+    {
+        ecb_aes_128_encrypt<1>(tmp, in + i, schedule);
+        out[i] = _mm_xor_si128(tmp[0], in[i]);
+    }
+}
+
+template<class T>
+bool DpfKey<T>::control(__m128i& seed)
+{
+    // the lowest bit of a child seed serves as control bit
+    bool res = _mm_cvtsi128_si64(seed) & 1;
+    seed = _mm_and_si128(seed, _mm_set_epi64x(-1, -2));
+    return res;
+}
+
+template<class T>
+void DpfKey<T>::expand(__m128i (&res)[2], bool (&controls)[2], __m128i seed)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        hash(&res[i], &seed, 1, i);
+        controls[i] = control(res[i]);
+    }
+}
+
+template<class T>
+void DpfKey<T>::convert(T* res, const __m128i* seeds, size_t n)
+{
+    int n_blocks = DIV_CEIL(T::size(), 16);
+    if (n_blocks > N_KEYS - 2)
+        throw runtime_error("DPF output type too large");
+    vector<int128> blocks(n * n_blocks);
+    for (int j = 0; j < n_blocks; j++)
+        hash(&blocks[j * n].a, seeds, n, 2 + j);
+    octet buffer[16 * (N_KEYS - 2)];
+    for (size_t i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n_blocks; j++)
+            _mm_storeu_si128((__m128i*) buffer + j, blocks[j * n + i].a);
+        res[i].assign(buffer);
+    }
+}
+
+template<class T>
+void DpfKey<T>::generate(array<DpfKey, 2>& keys, size_t alpha,
+        const T& beta, int n_bits, PRNG& G)
+{
+    __m128i seeds[2];
+    bool controls[2] = {false, true};
+    for (int b = 0; b < 2; b++)
+    {
+        seeds[b] = G.get_doubleword();
+        keys[b].party = b;
+        keys[b].seed = seeds[b];
+        keys[b].cws.resize(n_bits);
+    }
+
+    for (int i = 0; i < n_bits; i++)
+    {
+        bool keep = (alpha >> (n_bits - i - 1)) & 1;
+        bool lose = not keep;
+
+        __m128i children[2][2];
+        bool child_controls[2][2];
+        for (int b = 0; b < 2; b++)
+            expand(children[b], child_controls[b], seeds[b]);
+
+        CorrectionWord cw;
+        cw.seed = _mm_xor_si128(children[0][lose], children[1][lose]);
+        cw.control[0] = child_controls[0][0] ^ child_controls[1][0] ^ keep ^ 1;
+        cw.control[1] = child_controls[0][1] ^ child_controls[1][1] ^ keep;
+
+        for (int b = 0; b < 2; b++)
+        {
+            seeds[b] = children[b][keep];
+            if (controls[b])
+                seeds[b] = _mm_xor_si128(seeds[b], cw.seed);
+            controls[b] = child_controls[b][keep]
+                    ^ (controls[b] and cw.control[keep]);
+            keys[b].cws[i] = cw;
+        }
+    }
+
+    T converted[2];
+    for (int b = 0; b < 2; b++)
+        convert(&converted[b], &seeds[b], 1);
+    T final_cw = beta - converted[0] + converted[1];
+    if (controls[1])
+        final_cw = T() - final_cw;
+    for (int b = 0; b < 2; b++)
+        keys[b].final_cw = final_cw;
+}
+
+template<class T>
+T DpfKey<T>::evaluate(size_t x) const
+{
+    int n_bits = cws.size();
+    __m128i s = seed;
+    bool t = party;
+    for (int i = 0; i < n_bits; i++)
+    {
+        bool x_i = (x >> (n_bits - i - 1)) & 1;
+        __m128i children[2];
+        bool controls[2];
+        expand(children, controls, s);
+        s = children[x_i];
+        if (t)
+        {
+            s = _mm_xor_si128(s, cws[i].seed);
+            controls[x_i] ^= cws[i].control[x_i];
+        }
+        t = controls[x_i];
+    }
+    T res;
+    convert(&res, &s, 1);
+    if (t)
+        res += final_cw;
+    return party ? T() - res : res;
+}
+
+template<class T>
+void DpfKey<T>::evaluate_all(vector<T>& res) const
+{
+    // breadth-first to batch the block encryptions of a level
+    vector<int128> seeds(1, seed), next, children;
+    vector<char> controls(1, party), next_controls;
+    for (auto& cw : cws)
+    {
+        size_t n = seeds.size();
+        children.resize(n);
+        next.resize(2 * n);
+        next_controls.resize(2 * n);
+        for (int k = 0; k < 2; k++)
+        {
+            hash(&children[0].a, &seeds[0].a, n, k);
+            for (size_t j = 0; j < n; j++)
+            {
+                auto& s = next[2 * j + k].a;
+                s = children[j].a;
+                bool t = control(s);
+                if (controls[j])
+                {
+                    s = _mm_xor_si128(s, cw.seed);
+                    t ^= cw.control[k];
+                }
+                next_controls[2 * j + k] = t;
+            }
+        }
+        seeds.swap(next);
+        controls.swap(next_controls);
+    }
+
+    res.resize(seeds.size());
+    convert(res.data(), &seeds[0].a, seeds.size());
+    for (size_t i = 0; i < res.size(); i++)
+    {
+        if (controls[i])
+            res[i] += final_cw;
+        if (party)
+            res[i] = T() - res[i];
+    }
+}
+
+template<class T>
+void DpfKey<T>::pack(octetStream& os) const
+{
+    os.store(party);
+    os.append((octet*) &seed, sizeof(seed));
+    os.store(cws.size());
+    for (auto& cw : cws)
+    {
+        os.append((octet*) &cw.seed, sizeof(cw.seed));
+        os.store_int(cw.control[0] + 2 * cw.control[1], 1);
+    }
+    final_cw.pack(os);
+}
+
+template<class T>
+void DpfKey<T>::unpack(octetStream& os)
+{
+    os.get(party);
+    os.consume((octet*) &seed, sizeof(seed));
+    size_t size;
+    os.get(size);
+    cws.resize(size);
+    for (auto& cw : cws)
+    {
+        os.consume((octet*) &cw.seed, sizeof(cw.seed));
+        int control = os.get_int(1);
+        cw.control[0] = control & 1;
+        cw.control[1] = control >> 1;
+    }
+    final_cw.unpack(os);
+}
+
+#endif /* PROTOCOLS_DPF_HPP_ */
@@ -56,6 +56,11 @@ public:
     void inverse_permutation(vector<T>&, size_t, size_t, size_t)
     {
     }
+
+    void radix_sort(vector<T>&, size_t, size_t, size_t, size_t, int, bool)
+    {
+        throw not_implemented();
+    }
 };
 
 template<class T>
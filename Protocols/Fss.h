@@ -14,6 +14,8 @@
 using namespace std;
 
 #include "Protocols/Fss3Prep.h"
+#include "Protocols/Dcf.h"
+#include "Protocols/Dpf.h"
 #include "Tools/octetStream.h"
 #include "Tools/random.h"
 #include "Tools/PointerVector.h"
@@ -39,6 +41,19 @@ class Fss : public ReplicatedBase, public ProtocolBase<T>
     template <class U>
     void trunc_pr(const vector<int> &regs, int size, U &proc, false_type);
 
+    void multi_interval_containment(SubProcessor<T> &proc, const Instruction &instruction, true_type);
+    void multi_interval_containment(SubProcessor<T> &proc, const Instruction &instruction, false_type);
+    void relu_trunc(SubProcessor<T> &proc, const Instruction &instruction, true_type);
+    void relu_trunc(SubProcessor<T> &proc, const Instruction &instruction, false_type);
+    void table_lookup(SubProcessor<T> &proc, const Instruction &instruction, true_type);
+    void table_lookup(SubProcessor<T> &proc, const Instruction &instruction, false_type);
+
+    // masks the input shifted by half the ring, returns the mask for the dealer
+    typename T::clear mask_input(const T &x, octetStream &masked);
+    void exchange_masked(octetStream &masked, octetStream &other, octetStream (&keys)[2]);
+    // additive shares of the evaluators to replicated sharing
+    void to_replicated(const vector<typename T::clear> &shares, const vector<T*> &dest);
+
 public:
     static const bool uses_triples = false;
 
@@ -96,7 +111,28 @@ public:
     // new added function
     void distributed_comparison_function(SubProcessor<T> &processor, const Instruction &instruction, int lambda);
 
-    void Muliti_Interval_Containment(SubProcessor<T> &processor, const Instruction &instruction, int lambda);
+    /**
+     * Indicators of the segments between sorted public breakpoints for a
+     * vector of inputs. The dealer sends one comparison key per input
+     * while the evaluators open the masked input, so all segments cost
+     * one round plus one round to convert to replicated sharing.
+     */
+    void multi_interval_containment(SubProcessor<T> &processor, const Instruction &instruction);
+
+    /**
+     * ReLU of the inputs shifted right by a compile-time number of bits
+     * (with probabilistic rounding) followed by the derivative bits, from
+     * one masked opening and one round to convert to replicated sharing.
+     */
+    void relu_trunc(SubProcessor<T> &processor, const Instruction &instruction);
+
+    /**
+     * Entries of a public table at secret indices. The dealer sends one
+     * point function key per index, which the evaluators expand over
+     * the whole table after opening the masked index, so the cost is
+     * one round plus one round to convert to replicated sharing.
+     */
+    void table_lookup(SubProcessor<T> &processor, const Instruction &instruction);
 
     // new added generate function
     void generate();
@@ -14,6 +14,8 @@
 
 #include "ReplicatedInput.h"
 #include "Fss3Share2k.h"
+#include "Dcf.hpp"
+#include "Dpf.hpp"
 
 #include "ReplicatedPO.hpp"
 #include "Math/Z2k.hpp"
@@ -32,122 +34,358 @@ void Fss<T>::init(Preprocessing<T>& prep, typename T::MAC_Check& MC)
 }
 
 template <class T>
-void Fss<T>::Muliti_Interval_Containment(SubProcessor<T> &proc, const Instruction &instruction, int lambda){
-    PRNG prng;
-    prng.ReSeed();
-    init(proc.DataF, proc.MC);
-    // auto& args = instruction.get_start();
-    // int res_address = args[2], x_base = args[3], spline_base = args[4], length = args[5];
-    // typename T::clear tmp, r_tmp, eval_res[length+1], spline_res[length],z; 
-    // vector<typename T::clear> x_add_r;
-    // bigint dcf[length];
-    // fstream r;
-    // r.open("Player-Data/2-fss/multi_r" + to_string(P.my_num()), ios::in);
-    // r >> r_tmp;
-    // // for(int i = 0; i < args.size(); i+=args[0]){
-
-    // // }
-    // for(int i = 0; i < args.size(); i+=args[0]){
-    //     fstream r;
-    //     octetStream cs[2], reshare_cs, t_cs; //cs0, cs1; 
-        
-    //     r.open("Player-Data/2-fss/multi_r" + to_string(P.my_num()), ios::in);
-    //     r >> r_tmp;
-    //     MC->init_open(P, lambda);
-    //     auto dest = &proc.S[x_base + i][0];
-    //     *dest = *dest + r_tmp;
-    //     MC->prepare_open(proc.S[args[x_base + i]]);
-    //     MC->exchange(P);
-    //     x_add_r = MC->finalize_raw();
-    //     std::cout << "x+r is " << x_add_r << std::endl;
-
-    //     //res0 = 0，后面才存放Eval结果
-    //     if(P.my_num() == EVAL_1 || P.my_num() == EVAL_2){
-    //         auto size = dcf[0].get_mpz_t()->_mp_size;
-    //         eval_res[0] = 0;
-    //         r >> z;
-    //         r_tmp = 0;
-    //         for(int j = 0; j < length; j++){
-    //             tmp = x_add_r - proc.C[spline_base + j];
-    //             dcf[j] = this->evaluate(tmp, lambda);
-    //             size = dcf[j].get_mpz_t()->_mp_size;
-    //             mpn_copyi((mp_limb_t*)eval_res[j+1].get_ptr(), dcf[j].get_mpz_t()->_mp_d, abs(size));
-
-    //             // evaluation
-    //             if(size < 0){
-    //                 eval_res[j+1] = -eval_res[j+1];
-    //             }
-    //             if(lambda == 128){
-    //                 if(j == 0){
-    //                     spline_res[j] = typename T::clear(P.my_num()) * (1  - (x_add_r - proc.C[spline_base+j]).get_bit(lambda)) - eval_res[j] + eval_res[j+1] + z;
-    //                 }
-    //                 else{
-    //                     spline_res[j] = typename T::clear(P.my_num()) * ((x_add_r - proc.C[spline_base+j-1]).get_bit(lambda)  - (x_add_r - proc.C[spline_base+j]).get_bit(lambda)) - eval_res[j] + eval_res[j+1] + z;
-    //                 }
-    //             }
-    //             else{
-    //                 if(j == 0){
-    //                     spline_res[j] = typename T::clear(P.my_num()) * (1  - (x_add_r - proc.C[spline_base+j]).get_bit(lambda - 1)) - eval_res[j] + eval_res[j+1] + z;
-    //                 }
-    //                 else{
-    //                     spline_res[j] = typename T::clear(P.my_num()) * ((x_add_r - proc.C[spline_base+j-1]).get_bit(lambda - 1)  - (x_add_r - proc.C[spline_base+j]).get_bit(lambda - 1)) - eval_res[j] + eval_res[j+1] + z;
-    //                 }
-    //             }
-    //         } 
-
-    //         typename T::clear random_val[length+1];
-    //         P.receive_player(GEN, cs[P.my_num()]);
-    //         std::cout << "recieving! " << std::endl;
-    //         for(int j = 0; j < length+1; j++){
-    //             random_val[j].unpack(cs[P.my_num()]);
-    //             proc.S[res_address + j][0] = typename T::clear(P.my_num()) + spline_res[j] - random_val[j];
-    //         }
-        
+typename T::clear Fss<T>::mask_input(const T &x, octetStream &masked)
+{
+    typedef typename T::clear value_type;
+    // comparing as unsigned after shifting by half the ring
+    value_type half = value_type(1) << (value_type::N_BITS - 1);
+    int my_num = P.my_num();
+    // the dealer shares the mask with each evaluator via the PRNGs of
+    // the replicated sharing
+    value_type r[2];
+    if (my_num == GEN)
+    {
+        for (int b = 0; b < 2; b++)
+            r[b].randomize(shared_prngs[b]);
+        return r[0] + r[1];
+    }
 
-    //         r.close();
-    //     }
-
-
-
-    //     else{
-    //         typename T::clear r_sum[length+1], r0[length+1], r1[length+1];
-    //         for(int j = 0; j < length+1; j++){
-    //             bigint r_tmp;
-    //             prng.get(r_tmp, lambda); 
-    //             auto size = r_tmp.get_mpz_t()->_mp_size;
-    //             mpn_copyi((mp_limb_t*)r0[j].get_ptr(), r_tmp.get_mpz_t()->_mp_d, abs(size));
-    //             prng.get(r_tmp, lambda); 
-    //             size = r_tmp.get_mpz_t()->_mp_size;
-    //             mpn_copyi((mp_limb_t*)r1[j].get_ptr(), r_tmp.get_mpz_t()->_mp_d, abs(size));
-                
-    //             r_sum[j] = r0[j] + r1[j];
-    //             proc.S[res_address + j][0] = r_sum[j];
-    //             r0[j].pack(cs[EVAL_1]);
-
-    //             std::cout << "packed random value r0 is " << r0[j] << std::endl;
-    //             r1[j].pack(cs[EVAL_2]);
-    //         }
-    //         P.send_to(EVAL_1, cs[EVAL_1]);
-    //         P.send_to(EVAL_2, cs[EVAL_2]);
-    //         std::cout << "finishing sending!" << std::endl;
-    //     }
-    // }
-    // typename T::clear reshare[length+1], recv_reshare[length+1];
-    // for(int j = 0; j < length+1; j++){
-    //     reshare[j] = proc.S[res_address + j][0];
-    //     reshare[j].pack(reshare_cs);
-    // }
-    
+    // party i holds (s_i, s_{i-1}), so the first evaluator holds s_0 and
+    // s_2 and the second one s_1
+    r[my_num].randomize(shared_prngs[1 - my_num]);
+    if (my_num == EVAL_1)
+        (x[0] + x[1] + half + r[my_num]).pack(masked);
+    else
+        (x[0] + r[my_num]).pack(masked);
+    return {};
+}
+
+template <class T>
+void Fss<T>::exchange_masked(octetStream &masked, octetStream &other,
+        octetStream (&keys)[2])
+{
+    // the dealer sends the keys while the evaluators open the masked
+    // inputs to each other
+    int my_num = P.my_num();
+    if (my_num == GEN)
+        for (int b = 0; b < 2; b++)
+            P.send_to(b, keys[b]);
+    else
+    {
+        P.exchange(1 - my_num, masked, other);
+        P.receive_player(GEN, keys[my_num]);
+    }
+    this->rounds++;
+}
+
+template <class T>
+void Fss<T>::to_replicated(const vector<typename T::clear> &shares,
+        const vector<T*> &dest)
+{
+    typedef typename T::clear value_type;
+    // The components the dealer shares with each evaluator come from
+    // their PRNGs (s_2 with the first and s_1 with the second evaluator),
+    // and the evaluators exchange their masked shares for s_0.
+    int my_num = P.my_num();
+    if (my_num == GEN)
+    {
+        for (auto res : dest)
+            for (int b = 0; b < 2; b++)
+                (*res)[b].randomize(shared_prngs[b]);
+        return;
+    }
+
+    assert(shares.size() == dest.size());
+    octetStream os, other;
+    for (size_t i = 0; i < dest.size(); i++)
+    {
+        auto& res = *dest[i];
+        value_type mask;
+        mask.randomize(shared_prngs[1 - my_num]);
+        auto share = shares[i] - mask;
+        share.pack(os);
+        res[1 - my_num] = mask;
+        res[my_num] = share;
+    }
+
+    P.exchange(1 - my_num, os, other);
+    for (auto res : dest)
+        (*res)[my_num] += other.get<value_type>();
+    this->rounds++;
+}
+
+template <class T>
+void Fss<T>::multi_interval_containment(SubProcessor<T> &proc, const Instruction &instruction)
+{
+    multi_interval_containment(proc, instruction, T::clear::characteristic_two);
+}
+
+template <class T>
+void Fss<T>::multi_interval_containment(SubProcessor<T> &, const Instruction &, true_type)
+{
+    throw not_implemented();
+}
+
+template <class T>
+void Fss<T>::multi_interval_containment(SubProcessor<T> &proc, const Instruction &instruction, false_type)
+{
+    typedef typename T::clear value_type;
+    int n_bits = value_type::N_BITS;
+    value_type half = value_type(1) << (n_bits - 1);
+    auto& args = instruction.get_start();
+    auto& S = proc.get_S();
+    auto& C = proc.get_C();
+    int my_num = P.my_num();
+
+    SeededPRNG G;
+    octetStream masked, other, keys[2];
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        assert(args[i] == 6);
+        int n = args[i + 1] / (args[i + 5] + 1);
+        for (int k = 0; k < n; k++)
+        {
+            auto r = mask_input(S[args[i + 3] + k], masked);
+            if (my_num == GEN)
+            {
+                array<DcfKey<value_type>, 2> pair;
+                DcfKey<value_type>::generate(pair, r, 1, n_bits, G);
+                for (int b = 0; b < 2; b++)
+                    pair[b].pack(keys[b]);
+            }
+        }
+    }
+
+    exchange_masked(masked, other, keys);
 
-    // P.send_to((P.my_num()+1)%P.num_players(), reshare_cs);
-    // P.receive_player((P.my_num()+2)%P.num_players(), reshare_cs);
-    // for(int j = 0; j < length+1; j++){
-    //     recv_reshare[j].unpack(reshare_cs);
-    //     proc.S[res_address + j][1] = recv_reshare[j];
-    // }
+    // shares of the segment indicators for the evaluators
+    vector<value_type> indicators;
+    vector<T*> dest;
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        int n_breaks = args[i + 5];
+        int n = args[i + 1] / (n_breaks + 1);
+        size_t start = indicators.size();
+        for (int k = 0; k < args[i + 1]; k++)
+            dest.push_back(&S[args[i + 2] + k]);
+        if (my_num == GEN)
+            continue;
+        indicators.resize(start + args[i + 1]);
+        for (int k = 0; k < n; k++)
+        {
+            value_type masked_input = masked.get<value_type>()
+                    + other.get<value_type>();
+            DcfKey<value_type> key;
+            key.unpack(keys[my_num]);
+            auto below_mask = key.evaluate(masked_input);
+            value_type below, prev_below;
+            for (int j = 0; j <= n_breaks; j++)
+            {
+                if (j < n_breaks)
+                {
+                    value_type bound = C[args[i + 4] + j] + half;
+                    below = key.evaluate(masked_input - bound) - below_mask;
+                    if (my_num == EVAL_1
+                            and key.less_than(masked_input, bound))
+                        below += 1;
+                }
+                else
+                    below = my_num == EVAL_1 ? 1 : 0;
+                indicators[start + j * n + k] = below - prev_below;
+                prev_below = below;
+            }
+        }
+    }
+
+    to_replicated(indicators, dest);
 }
 
+template <class T>
+void Fss<T>::relu_trunc(SubProcessor<T> &proc, const Instruction &instruction)
+{
+    relu_trunc(proc, instruction, T::clear::characteristic_two);
+}
 
+template <class T>
+void Fss<T>::relu_trunc(SubProcessor<T> &, const Instruction &, true_type)
+{
+    throw not_implemented();
+}
+
+template <class T>
+void Fss<T>::relu_trunc(SubProcessor<T> &proc, const Instruction &instruction, false_type)
+{
+    typedef typename T::clear value_type;
+    typedef FixedVec<value_type, 2> payload_type;
+    typedef DcfKey<value_type, payload_type> key_type;
+    int n_bits = value_type::N_BITS;
+    value_type half = value_type(1) << (n_bits - 1);
+    auto& args = instruction.get_start();
+    auto& S = proc.get_S();
+    int my_num = P.my_num();
+
+    // With y = x + 2^(n-1) masked by r, the derivative and the truncated
+    // result are piecewise linear in the masked value with pieces
+    // starting at r and r + 2^(n-1), so two comparison keys with the
+    // derivative and the constant term as payload suffice. Ignoring the
+    // carry from the lower bits makes the truncation probabilistic.
+    SeededPRNG G;
+    octetStream masked, other, keys[2];
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        assert(args[i] == 5);
+        int m = args[i + 4];
+        value_type top = value_type(1) << (n_bits - 1 - m);
+        for (int k = 0; k < args[i + 1] / 2; k++)
+        {
+            value_type r = mask_input(S[args[i + 3] + k], masked);
+            if (my_num != GEN)
+                continue;
+
+            bool low = not r.get_bit(n_bits - 1);
+            value_type r_shifted = r >> m;
+            payload_type below_mask, below_other, offset;
+            below_mask[0] = 1;
+            below_mask[1] = top - r_shifted;
+            below_other[0] = -1;
+            below_other[1] = r_shifted + top;
+            if (low)
+            {
+                offset[0] = 1;
+                offset[1] = value_type() - r_shifted - top;
+            }
+            else
+                below_other[1] -= top << 1;
+
+            array<key_type, 2> pairs[2];
+            key_type::generate(pairs[0], r, below_mask, n_bits, G);
+            key_type::generate(pairs[1], r + half, below_other, n_bits, G);
+            payload_type offsets[2];
+            offsets[0].randomize(G);
+            offsets[1] = offset - offsets[0];
+            for (int b = 0; b < 2; b++)
+            {
+                for (auto& pair : pairs)
+                    pair[b].pack(keys[b]);
+                offsets[b].pack(keys[b]);
+            }
+        }
+    }
+
+    exchange_masked(masked, other, keys);
+
+    vector<value_type> outputs;
+    vector<T*> dest;
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        int m = args[i + 4];
+        int n = args[i + 1] / 2;
+        size_t start = outputs.size();
+        for (int k = 0; k < args[i + 1]; k++)
+            dest.push_back(&S[args[i + 2] + k]);
+        if (my_num == GEN)
+            continue;
+        outputs.resize(start + args[i + 1]);
+        for (int k = 0; k < n; k++)
+        {
+            value_type masked_input = masked.get<value_type>()
+                    + other.get<value_type>();
+            payload_type sum;
+            for (int j = 0; j < 2; j++)
+            {
+                key_type key;
+                key.unpack(keys[my_num]);
+                sum += key.evaluate(masked_input);
+            }
+            sum += keys[my_num].get<payload_type>();
+            outputs[start + k] = sum[0] * value_type(masked_input >> m)
+                    + sum[1];
+            outputs[start + n + k] = sum[0];
+        }
+    }
+
+    to_replicated(outputs, dest);
+}
+
+template <class T>
+void Fss<T>::table_lookup(SubProcessor<T> &proc, const Instruction &instruction)
+{
+    table_lookup(proc, instruction, T::clear::characteristic_two);
+}
+
+template <class T>
+void Fss<T>::table_lookup(SubProcessor<T> &, const Instruction &, true_type)
+{
+    throw not_implemented();
+}
+
+template <class T>
+void Fss<T>::table_lookup(SubProcessor<T> &proc, const Instruction &instruction, false_type)
+{
+    typedef typename T::clear value_type;
+    auto& args = instruction.get_start();
+    auto& S = proc.get_S();
+    auto& C = proc.get_C();
+    int my_num = P.my_num();
+    auto n_bits = [&](size_t i) { return max(1, int(ceil(log2(args[i + 5])))); };
+
+    // the index masked modulo the table size rounded up to a power of two
+    // selects the rotation of the table, and the point function at the
+    // mask selects the entry
+    SeededPRNG G;
+    octetStream masked, other, keys[2];
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        assert(args[i] == 6);
+        if (n_bits(i) >= 64)
+            throw runtime_error("table too large");
+        for (int k = 0; k < args[i + 1]; k++)
+        {
+            auto r = mask_input(S[args[i + 3] + k], masked);
+            if (my_num == GEN)
+            {
+                array<DpfKey<value_type>, 2> pair;
+                size_t alpha = r.get_limb(0) & ((1ull << n_bits(i)) - 1);
+                DpfKey<value_type>::generate(pair, alpha, 1, n_bits(i), G);
+                for (int b = 0; b < 2; b++)
+                    pair[b].pack(keys[b]);
+            }
+        }
+    }
+
+    exchange_masked(masked, other, keys);
+
+    vector<value_type> results;
+    vector<T*> dest;
+    vector<value_type> point;
+    for (size_t i = 0; i < args.size(); i += args[i])
+    {
+        for (int k = 0; k < args[i + 1]; k++)
+            dest.push_back(&S[args[i + 2] + k]);
+        if (my_num == GEN)
+            continue;
+        size_t mask = (1ull << n_bits(i)) - 1;
+        size_t size = args[i + 5];
+        for (int k = 0; k < args[i + 1]; k++)
+        {
+            size_t masked_index = (masked.get<value_type>()
+                    + other.get<value_type>()).get_limb(0) & mask;
+            DpfKey<value_type> key;
+            key.unpack(keys[my_num]);
+            key.evaluate_all(point);
+            value_type res;
+            for (size_t j = 0; j <= mask; j++)
+            {
+                size_t index = (masked_index - j) & mask;
+                if (index < size)
+                    res += point[j] * C[args[i + 4] + index];
+            }
+            results.push_back(res);
+        }
+    }
+
+    to_replicated(results, dest);
+}
 
 template <class T>
 void Fss<T>::distributed_comparison_function(SubProcessor<T> &proc, const Instruction &instruction, int lambda)
@@ -558,30 +796,14 @@ void Fss<T>::cisc(SubProcessor<T> &processor, const Instruction &instruction)
         }
         
     }
-    else{
-        auto& args = instruction.get_start();
-        // std::cout << "CISC CALLED!" << std::endl;
-        std::cout << "Arguments are: " << std::endl;
-        for(auto i : args)
-            std::cout << i << std::endl;
-        octetStream cs;
-        std::cout << "MTS CALLED!" << std::endl;
-        if(P.my_num() == GEN){  
-            std::cout << "Generating fake multi dcf " << std::endl;
-            this->fss3prep->gen_fake_multi_spline_dcf(processor, 1, lambda, args[4], args[8]);  
-            signal = 1;
-            signal.pack(cs);
-            P.send_to(EVAL_1, cs);
-            P.send_to(EVAL_2, cs);
-        }
-        else{
-            P.receive_player(GEN, cs);
-            signal.unpack(cs);
-        }
-        if(signal){
-            processor.protocol.Muliti_Interval_Containment(processor, instruction, lambda);
-        }
-    }
+    else if (tag == string("MTS\0", 4))
+        multi_interval_containment(processor, instruction);
+    else if (tag == "ReLU")
+        relu_trunc(processor, instruction);
+    else if (tag == string("LUT\0", 4))
+        table_lookup(processor, instruction);
+    else
+        throw runtime_error("CISC instruction not supported by FSS: " + tag);
 }
 
 #endif // PROTOCOLS_FSS_HPP
\ No newline at end of file
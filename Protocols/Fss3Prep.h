@@ -38,8 +38,6 @@ public:
 
     void gen_fake_dcf(int beta, int lambda);
 
-    void gen_fake_multi_spline_dcf(SubProcessor<T> &processor, int beta, int lambda, int base, int length);
-    
     void get_one_no_count(Dtype dtype, T& a)
     {
         std::cout << "jumping into Fss3Prep.h get_one_no_count" << std::endl;
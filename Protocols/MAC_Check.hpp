@@ -10,6 +10,7 @@
 #include "Tools/int.h"
 #include "Tools/benchmarking.h"
 #include "Tools/Bundle.h"
+#include "Math/FieldKernels.h"
 
 #include <algorithm>
 
@@ -217,21 +218,14 @@ void MAC_Check_<U>::Check(const Player& P)
       PRNG G;
       G.SetSeed(seed);
 
-      U sj;
+      typedef FieldKernels<typename U::mac_type> kernels;
       typename U::mac_type a,gami,temp;
-      typename U::mac_type::Scalar h;
+      vector<typename U::mac_type::Scalar> h(popen_cnt);
       vector<typename U::mac_type> tau(P.num_players());
-      a.assign_zero();
-      gami.assign_zero();
-      for (int i=0; i<popen_cnt; i++)
-        {
-          h.almost_randomize(G);
-          temp = vals[i] * h;
-          a = (a + temp);
-
-          temp = h * macs[i];
-          gami = (gami + temp);
-        }
+      for (auto& x : h)
+        x.almost_randomize(G);
+      a = kernels::inner_product(vals.data(), h.data(), popen_cnt);
+      gami = kernels::inner_product(h.data(), macs.data(), popen_cnt);
 
       temp = this->alphai * a;
       tau[P.my_num()] = (gami - temp);
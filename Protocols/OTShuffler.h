@@ -0,0 +1,93 @@
+/*
+ * OTShuffler.h
+ *
+ */
+
+#ifndef PROTOCOLS_OTSHUFFLER_H_
+#define PROTOCOLS_OTSHUFFLER_H_
+
+#include "SecureShuffle.h"
+#include "Tools/random.h"
+#include "Tools/octetStream.h"
+
+class OffsetPlayer;
+class OTExtensionWithMatrix;
+
+/**
+ * Two-party shuffling with permutation correlations. Each party holds
+ * a local permutation and obtains a masked sharing of its permutation
+ * applied to random masks of the other party, with one oblivious
+ * transfer per switch of the Waksman network of the permutation.
+ * Applying a shuffle then takes one message per permutation.
+ * Falls back to ``SecureShuffle`` for more than two parties.
+ */
+template<class T>
+class OTShuffler : public SecureShuffle<T>
+{
+    typedef typename T::clear clear;
+
+    struct Switch
+    {
+        int in[2], out[2];
+        // position of configuration bit, -1 if fixed to straight
+        int bit;
+    };
+
+    struct Layer
+    {
+        int depth;
+        vector<Switch> switches;
+    };
+
+    struct Shuffle
+    {
+        int n_shuffle;
+        vector<vector<bool>> config;
+    };
+
+    SubProcessor<T>& proc;
+    SeededPRNG G;
+
+    vector<Shuffle> shuffles;
+
+    OffsetPlayer* player;
+    OTExtensionWithMatrix* ot_ext;
+
+    bool two_party();
+    void setup_ot();
+
+    static vector<Layer> layers(int n, bool reverse);
+    static void route(vector<clear>& values, const vector<Layer>& layers,
+            const vector<vector<bool>>& config, int unit_size);
+
+    // masks for every layer of the network of the other party
+    vector<vector<clear>> send_correlation(const vector<Layer>& layers,
+            int unit_size, octetStream& os);
+    // own permutation of the first masks minus the last masks
+    vector<clear> receive_correlation(const vector<Layer>& layers,
+            const vector<vector<bool>>& config, int unit_size,
+            octetStream& os);
+
+public:
+    OTShuffler(vector<T>& a, size_t n, int unit_size, size_t output_base,
+            size_t input_base, SubProcessor<T>& proc);
+
+    OTShuffler(SubProcessor<T>& proc);
+
+    ~OTShuffler();
+
+    int generate(int n_shuffle);
+
+    /**
+     * Applies the permutation of the first party followed by the one of
+     * the second party (in reverse order and inverted if ``reverse``).
+     * The correlations come from one batch of oblivious transfers in
+     * both directions, followed by two rounds of masked shares.
+     */
+    void apply(vector<T>& a, size_t n, int unit_size, size_t output_base,
+            size_t input_base, int handle, bool reverse);
+
+    void del(int handle);
+};
+
+#endif /* PROTOCOLS_OTSHUFFLER_H_ */
@@ -0,0 +1,325 @@
+/*
+ * OTShuffler.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_OTSHUFFLER_HPP_
+#define PROTOCOLS_OTSHUFFLER_HPP_
+
+#include "OTShuffler.h"
+#include "Tools/Waksman.h"
+#include "OT/BaseOT.h"
+#include "OT/OTExtensionWithMatrix.h"
+
+template<class T>
+OTShuffler<T>::OTShuffler(vector<T>& a, size_t n, int unit_size,
+        size_t output_base, size_t input_base, SubProcessor<T>& proc) :
+        OTShuffler(proc)
+{
+    if (two_party())
+    {
+        apply(a, n, unit_size, output_base, input_base,
+                generate(n / unit_size), false);
+        shuffles.pop_back();
+    }
+    else
+    {
+        int handle = SecureShuffle<T>::generate(n / unit_size);
+        SecureShuffle<T>::apply(a, n, unit_size, output_base, input_base,
+                handle, false);
+        SecureShuffle<T>::del(handle);
+    }
+}
+
+template<class T>
+OTShuffler<T>::OTShuffler(SubProcessor<T>& proc) :
+        SecureShuffle<T>(proc), proc(proc), player(0), ot_ext(0)
+{
+}
+
+template<class T>
+OTShuffler<T>::~OTShuffler()
+{
+    if (ot_ext)
+        delete ot_ext;
+    if (player)
+        delete player;
+}
+
+template<class T>
+bool OTShuffler<T>::two_party()
+{
+    return proc.P.num_players() == 2;
+}
+
+template<class T>
+void OTShuffler<T>::setup_ot()
+{
+    if (ot_ext)
+        return;
+
+    player = new OffsetPlayer(proc.P, 1);
+    BaseOT base_ot(128, 128, player);
+    base_ot.exec_base();
+    ot_ext = new OTExtensionWithMatrix(base_ot, player, true);
+}
+
+template<class T>
+int OTShuffler<T>::generate(int n_shuffle)
+{
+    if (not two_party())
+        return SecureShuffle<T>::generate(n_shuffle);
+
+    // nothing to configure for empty shuffles
+    if (n_shuffle == 0)
+    {
+        shuffles.push_back({0, {}});
+        return shuffles.size() - 1;
+    }
+
+    int n_pow2 = 1 << int(ceil(log2(n_shuffle)));
+    vector<int> perm;
+    for (int j = 0; j < n_pow2; j++)
+        perm.push_back(j);
+    for (int i = 0; i < n_shuffle; i++)
+    {
+        int j = G.get_uint(n_shuffle - i);
+        swap(perm[i], perm[i + j]);
+    }
+
+    shuffles.push_back({n_shuffle, {}});
+    if (n_pow2 > 1)
+        shuffles.back().config = Waksman::configure(perm);
+    return shuffles.size() - 1;
+}
+
+template<class T>
+void OTShuffler<T>::del(int handle)
+{
+    if (two_party())
+        shuffles.at(handle).config.clear();
+    else
+        SecureShuffle<T>::del(handle);
+}
+
+template<class T>
+vector<typename OTShuffler<T>::Layer> OTShuffler<T>::layers(int n,
+        bool reverse)
+{
+    // same wiring as SecureShuffle::iter_waksman()
+    vector<pair<int, bool>> depths;
+    for (int depth = 0; depth < log2(n); depth++)
+        depths.push_back({depth, true});
+    for (int depth = log2(n) - 2; depth >= 0; depth--)
+        depths.push_back({depth, false});
+
+    Waksman waksman(n);
+    vector<Layer> res;
+    for (auto& x : depths)
+    {
+        int depth = x.first;
+        bool inwards = x.second;
+        bool outwards = not inwards;
+        int size = n / (2 << depth);
+        res.push_back({depth, {}});
+        for (int k = 0; k < n / 2; k++)
+        {
+            int j = k % size;
+            int base = 2 * (k / size) * size;
+            Switch s;
+            s.in[0] = base + j + j * inwards;
+            s.in[1] = s.in[0] + inwards + size * outwards;
+            s.out[0] = base + j + j * outwards;
+            s.out[1] = s.out[0] + outwards + size * inwards;
+            s.bit = base + j + size * (outwards ^ reverse);
+            if (not waksman.matters(depth, s.bit))
+                s.bit = -1;
+            res.back().switches.push_back(s);
+        }
+    }
+    return res;
+}
+
+template<class T>
+void OTShuffler<T>::route(vector<clear>& values, const vector<Layer>& layers,
+        const vector<vector<bool>>& config, int unit_size)
+{
+    vector<clear> tmp(values.size());
+    for (auto& layer : layers)
+    {
+        for (auto& s : layer.switches)
+        {
+            bool swapped = s.bit >= 0 and config.at(layer.depth).at(s.bit);
+            for (int j = 0; j < 2; j++)
+                for (int l = 0; l < unit_size; l++)
+                    tmp[s.out[j] * unit_size + l] =
+                            values[s.in[j ^ swapped] * unit_size + l];
+        }
+        values.swap(tmp);
+    }
+}
+
+template<class T>
+vector<vector<typename T::clear>> OTShuffler<T>::send_correlation(
+        const vector<Layer>& layers, int unit_size, octetStream& os)
+{
+    int n = layers.empty() ? 1 : 2 * layers[0].switches.size();
+    vector<vector<clear>> masks(layers.size() + 1,
+            vector<clear>(n * unit_size));
+    for (auto& mask : masks)
+        for (auto& x : mask)
+            x.randomize(G);
+
+    int k = 0;
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        auto& in = masks[i];
+        auto& out = masks[i + 1];
+        for (auto& s : layers[i].switches)
+        {
+            if (s.bit < 0)
+            {
+                // nothing to hide for fixed switches
+                for (int j = 0; j < 2; j++)
+                    for (int l = 0; l < unit_size; l++)
+                        out[s.out[j] * unit_size + l] = in[s.in[j]
+                                * unit_size + l];
+                continue;
+            }
+
+            for (int choice = 0; choice < 2; choice++)
+            {
+                PRNG pad;
+                pad.SetSeed(ot_ext->get_sender_output(choice, k));
+                for (int j = 0; j < 2; j++)
+                    for (int l = 0; l < unit_size; l++)
+                        (in[s.in[j ^ choice] * unit_size + l]
+                                - out[s.out[j] * unit_size + l]
+                                + pad.get<clear>()).pack(os);
+            }
+            k++;
+        }
+    }
+    return masks;
+}
+
+template<class T>
+vector<typename T::clear> OTShuffler<T>::receive_correlation(
+        const vector<Layer>& layers, const vector<vector<bool>>& config,
+        int unit_size, octetStream& os)
+{
+    int n = layers.empty() ? 1 : 2 * layers[0].switches.size();
+    vector<clear> res(n * unit_size), tmp(n * unit_size);
+
+    int k = 0;
+    for (auto& layer : layers)
+    {
+        for (auto& s : layer.switches)
+        {
+            if (s.bit < 0)
+            {
+                for (int j = 0; j < 2; j++)
+                    for (int l = 0; l < unit_size; l++)
+                        tmp[s.out[j] * unit_size + l] = res[s.in[j]
+                                * unit_size + l];
+                continue;
+            }
+
+            bool swapped = config.at(layer.depth).at(s.bit);
+            PRNG pad;
+            pad.SetSeed(ot_ext->get_receiver_output(k));
+            for (int choice = 0; choice < 2; choice++)
+                for (int j = 0; j < 2; j++)
+                    for (int l = 0; l < unit_size; l++)
+                    {
+                        clear x = os.get<clear>();
+                        if (choice == swapped)
+                            tmp[s.out[j] * unit_size + l] = res[s.in[j
+                                    ^ swapped] * unit_size + l] + x
+                                    - pad.get<clear>();
+                    }
+            k++;
+        }
+        res.swap(tmp);
+    }
+    return res;
+}
+
+template<class T>
+void OTShuffler<T>::apply(vector<T>& a, size_t n, int unit_size,
+        size_t output_base, size_t input_base, int handle, bool reverse)
+{
+    if (not two_party())
+    {
+        SecureShuffle<T>::apply(a, n, unit_size, output_base, input_base,
+                handle, reverse);
+        return;
+    }
+
+    assert(not T::malicious);
+    auto& shuffle = shuffles.at(handle);
+    int n_shuffle = n / unit_size;
+    assert(size_t(n_shuffle * unit_size) == n);
+    assert(n_shuffle == shuffle.n_shuffle);
+    if (n_shuffle == 0)
+        return;
+    int n_pow2 = 1 << int(ceil(log2(n_shuffle)));
+    auto network = layers(n_pow2, reverse);
+
+    // one OT per switch and direction, choice bits from own network
+    vector<bool> bits;
+    for (auto& layer : network)
+        for (auto& s : layer.switches)
+            if (s.bit >= 0)
+                bits.push_back(shuffle.config.at(layer.depth).at(s.bit));
+    if (not bits.empty())
+    {
+        setup_ot();
+        BitVector choices(DIV_CEIL(bits.size(), 128) * 128);
+        for (size_t i = 0; i < bits.size(); i++)
+            choices.set_bit(i, bits[i]);
+        ot_ext->transfer(choices.size(), choices, 1);
+    }
+
+    // the party permuting second masks its input right away
+    int my_num = proc.P.my_num();
+    int first = reverse;
+    vector<clear> share(n_pow2 * unit_size);
+    for (size_t i = 0; i < n; i++)
+        share[i] = a[input_base + i];
+
+    octetStream os;
+    auto masks = send_correlation(network, unit_size, os);
+    if (my_num != first)
+        for (size_t i = 0; i < share.size(); i++)
+            (share[i] - masks[0][i]).pack(os);
+    proc.P.exchange(1 - my_num, os);
+    auto delta = receive_correlation(network, shuffle.config, unit_size, os);
+
+    if (my_num == first)
+    {
+        for (auto& x : share)
+            x += os.get<clear>();
+        route(share, network, shuffle.config, unit_size);
+        os.reset_write_head();
+        for (size_t i = 0; i < share.size(); i++)
+            (share[i] + delta[i] - masks[0][i]).pack(os);
+        proc.P.send_to(1 - my_num, os);
+        share = masks.back();
+    }
+    else
+    {
+        share = masks.back();
+        proc.P.receive_player(1 - my_num, os);
+        for (auto& x : share)
+            x += os.get<clear>();
+        route(share, network, shuffle.config, unit_size);
+        for (size_t i = 0; i < share.size(); i++)
+            share[i] += delta[i];
+    }
+
+    for (size_t i = 0; i < n; i++)
+        a[output_base + i] = share[i];
+}
+
+#endif /* PROTOCOLS_OTSHUFFLER_HPP_ */
@@ -0,0 +1,210 @@
+/*
+ * PackedShamir.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIR_H_
+#define PROTOCOLS_PACKEDSHAMIR_H_
+
+#include "Replicated.h"
+#include "Tools/Bundle.h"
+#include "Tools/PointerVector.h"
+
+/**
+ * Evaluation points for packed Shamir secret sharing. Party ``i`` uses
+ * ``i + 1`` as in plain Shamir, lane 0 uses zero, and the other lanes
+ * follow the parties, which works in both prime fields and GF(2^n).
+ */
+template<class U>
+class PackedShamirPoints
+{
+public:
+    static U party(int i)
+    {
+        return i + 1;
+    }
+    static U lane(int l, int n_players)
+    {
+        return l ? n_players + l : 0;
+    }
+
+    static vector<U> lagrange(const vector<U>& points, const U& target);
+
+    static vector<vector<U>> packing(int n_players, int n_lanes);
+    static vector<vector<U>> reconstruction(int n_players, int n_lanes,
+            int n_shares);
+};
+
+/**
+ * Sharing of values at all lanes with given degree, where the shares
+ * of the first ``n_random`` parties are random
+ */
+template<class U>
+class PackedShamirDealer
+{
+    vector<vector<U>> coefficients;
+
+public:
+    int n_random;
+
+    PackedShamirDealer(int n_players, int degree, int n_lanes);
+
+    void deal(vector<U>& shares, const vector<U>& lanes,
+            const vector<U>& random) const;
+};
+
+/**
+ * Random sharings from everyone's dealings combined with a
+ * hyper-invertible matrix
+ */
+template<class T>
+class PackedShamirRandom
+{
+    typedef typename T::open_type open_type;
+
+    const Player& P;
+    int n, threshold, k;
+
+    vector<vector<open_type>> hyper;
+    map<int, PackedShamirDealer<open_type>> dealers;
+
+    SeededPRNG secure_prng;
+    vector<SeededPRNG> send_prngs;
+    vector<PRNG> recv_prngs;
+    vector<octetStream> received;
+
+    void setup_prngs();
+
+public:
+    PackedShamirRandom(const Player& P);
+
+    PackedShamirDealer<open_type>& get_dealer(int degree);
+
+    vector<vector<open_type>> tuples(const vector<int>& degrees,
+            const vector<int>& lanes, size_t n_tuples);
+};
+
+/**
+ * Packed Shamir secret sharing protocol.
+ * Sharings have degree ``t + k - 1`` for ``k`` lanes. Multiplication
+ * puts up to ``k`` local products into one polynomial of degree
+ * ``2t + 3k - 3`` masked by a double sharing, which requires
+ * ``n >= 2t + 3k - 2`` parties. Round-robin kings reconstruct all lanes
+ * and reshare them: results in specific lanes with one polynomial,
+ * results for all lanes by sending the masked values. Operands whose
+ * local product is not defined are moved to all lanes in a round before.
+ */
+template<class T>
+class PackedShamir : public ProtocolBase<T>
+{
+    typedef typename T::open_type open_type;
+    typedef PackedShamirPoints<open_type> Points;
+
+    enum GroupType
+    {
+        PACKED, ALL_LANES, SUM,
+    };
+
+    struct Product
+    {
+        // already packed if lane is -2
+        open_type value;
+        int lane;
+        int output;
+    };
+
+    struct Group
+    {
+        GroupType type;
+        int king;
+        vector<int> slots;
+        vector<open_type> values;
+        vector<open_type> mask;
+    };
+
+    struct DotProduct
+    {
+        // products by lane, for all lanes, and already packed
+        vector<open_type> shares;
+        int lane;
+        // terms with an operand to be moved to all lanes first
+        vector<array<T, 2>> terms;
+    };
+
+    struct Deferred
+    {
+        size_t index;
+        DotProduct dotprod;
+        int output;
+    };
+
+    int n, threshold, k, degree, product_degree;
+
+    vector<vector<open_type>> packing, reconstruction;
+    PackedShamirRandom<T> randomness;
+
+    vector<Product> products;
+    vector<Deferred> deferred;
+    vector<Group> groups;
+    PointerVector<T> results;
+
+    vector<vector<open_type>> packed_masks, lane_masks;
+
+    Bundle<octetStream> oss, oss2;
+    vector<octetStream> received, received2;
+
+    DotProduct dotprod;
+
+    int next_king;
+
+    static bool compatible(int lane, int other);
+    static bool moved(const array<T, 2>& term, int i);
+
+    void prepare(const open_type& product, int lane, int output);
+    void prepare_product(const T& x, const T& y, int output);
+
+    DotProduct new_dotprod();
+    void add_term(DotProduct& dotprod, const T& x, const T& y);
+    Product product(const DotProduct& dotprod, int output);
+    void finish(DotProduct& dotprod, int output);
+
+    int add_group(GroupType type);
+    void run(const vector<Product>& products, vector<T>& results);
+    void reshare(const Group& group, const vector<open_type>& values);
+
+    void buffer_random();
+    void buffer_masks(vector<vector<open_type>>& masks, bool all_lanes,
+            size_t n_masks);
+
+public:
+    static const bool uses_triples = false;
+
+    Player& P;
+
+    PackedShamir(Player& P);
+
+    PackedShamir branch()
+    {
+        return P;
+    }
+
+    int get_n_relevant_players()
+    {
+        return threshold + 1;
+    }
+
+    void init_mul();
+    void prepare_mul(const T& x, const T& y, int n = -1);
+    void exchange();
+    T finalize_mul(int n = -1);
+
+    void init_dotprod();
+    void prepare_dotprod(const T& x, const T& y);
+    void next_dotprod();
+    T finalize_dotprod(int length);
+
+    void muls(const vector<int>& reg, SubProcessor<T>& proc,
+            typename T::MAC_Check& MC, int size);
+};
+
+#endif /* PROTOCOLS_PACKEDSHAMIR_H_ */
@@ -0,0 +1,628 @@
+/*
+ * PackedShamir.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIR_HPP_
+#define PROTOCOLS_PACKEDSHAMIR_HPP_
+
+#include "PackedShamir.h"
+#include "PackedShamirShare.h"
+#include "Shamir.hpp"
+#include "Tools/benchmarking.h"
+
+template<class U>
+vector<U> PackedShamirPoints<U>::lagrange(const vector<U>& points,
+        const U& target)
+{
+    vector<U> res;
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        U x = 1;
+        for (size_t i = 0; i < points.size(); i++)
+            if (i != j)
+                x *= (target - points[i]) / (points[j] - points[i]);
+        res.push_back(x);
+    }
+    return res;
+}
+
+template<class U>
+vector<vector<U>> PackedShamirPoints<U>::packing(int n_players, int n_lanes)
+{
+    vector<U> lanes;
+    for (int l = 0; l < n_lanes; l++)
+        lanes.push_back(lane(l, n_players));
+    vector<vector<U>> res;
+    for (int i = 0; i < n_players; i++)
+        res.push_back(lagrange(lanes, party(i)));
+    return res;
+}
+
+template<class U>
+vector<vector<U>> PackedShamirPoints<U>::reconstruction(int n_players,
+        int n_lanes, int n_shares)
+{
+    vector<U> parties;
+    for (int i = 0; i < n_shares; i++)
+        parties.push_back(party(i));
+    vector<vector<U>> res;
+    for (int l = 0; l < n_lanes; l++)
+        res.push_back(lagrange(parties, lane(l, n_players)));
+    return res;
+}
+
+template<class U>
+PackedShamirDealer<U>::PackedShamirDealer(int n_players, int degree,
+        int n_lanes) :
+        n_random(degree + 1 - n_lanes)
+{
+    assert(n_random >= 0);
+    vector<U> points;
+    for (int l = 0; l < n_lanes; l++)
+        points.push_back(PackedShamirPoints<U>::lane(l, n_players));
+    for (int i = 0; i < n_random; i++)
+        points.push_back(PackedShamirPoints<U>::party(i));
+    for (int i = n_random; i < n_players; i++)
+        coefficients.push_back(
+                PackedShamirPoints<U>::lagrange(points,
+                        PackedShamirPoints<U>::party(i)));
+}
+
+template<class U>
+void PackedShamirDealer<U>::deal(vector<U>& shares, const vector<U>& lanes,
+        const vector<U>& random) const
+{
+    assert(int(random.size()) == n_random);
+    shares.assign(random.begin(), random.end());
+    for (auto& x : coefficients)
+    {
+        assert(x.size() == lanes.size() + random.size());
+        U share;
+        for (size_t l = 0; l < lanes.size(); l++)
+            share += x[l] * lanes[l];
+        for (size_t i = 0; i < random.size(); i++)
+            share += x[lanes.size() + i] * random[i];
+        shares.push_back(share);
+    }
+}
+
+template<class T>
+PackedShamirRandom<T>::PackedShamirRandom(const Player& P) :
+        P(P)
+{
+    n = P.num_players();
+    threshold = ShamirMachine::s().threshold;
+    k = T::n_lanes();
+    Shamir<T>::get_hyper(hyper, threshold, n);
+}
+
+template<class T>
+PackedShamirDealer<typename T::open_type>& PackedShamirRandom<T>::get_dealer(
+        int degree)
+{
+    auto it = dealers.find(degree);
+    if (it == dealers.end())
+        it = dealers.insert({degree, {n, degree, k}}).first;
+    return it->second;
+}
+
+template<class T>
+void PackedShamirRandom<T>::setup_prngs()
+{
+    vector<octetStream> to_send(n), to_receive;
+    send_prngs.resize(n);
+    for (int i = 0; i < n; i++)
+        to_send[i].append(send_prngs[i].get_seed(), SEED_SIZE);
+    P.send_receive_all(to_send, to_receive);
+    recv_prngs.resize(n);
+    for (int i = 0; i < n; i++)
+        if (i != P.my_num())
+            recv_prngs[i].SetSeed(to_receive[i].consume(SEED_SIZE));
+}
+
+template<class T>
+vector<vector<typename T::open_type>> PackedShamirRandom<T>::tuples(
+        const vector<int>& degrees, const vector<int>& lanes,
+        size_t n_tuples)
+{
+    // everyone deals sharings of random secrets, -1 denotes packing all
+    // secrets, otherwise secret l is shared for all lanes;
+    // the random shares come from pairwise keys as in ShamirInput
+    assert(degrees.size() == lanes.size());
+    if (send_prngs.empty())
+        setup_prngs();
+    int me = P.my_num();
+    size_t n_dealt = DIV_CEIL(n_tuples, hyper.size());
+    vector<octetStream> to_send(n);
+    vector<open_type> secrets(k), values, random, shares;
+    for (size_t j = 0; j < n_dealt; j++)
+    {
+        for (auto& x : secrets)
+            x.randomize(secure_prng);
+        for (size_t c = 0; c < degrees.size(); c++)
+        {
+            auto& dealer = get_dealer(degrees[c]);
+            if (lanes[c] < 0)
+                values = secrets;
+            else
+                values.assign(k, secrets[lanes[c]]);
+            random.resize(dealer.n_random);
+            for (int i = 0; i < dealer.n_random; i++)
+                random[i].randomize(send_prngs[i]);
+            dealer.deal(shares, values, random);
+            for (int i = 0; i < n; i++)
+                if (i >= dealer.n_random or i == me)
+                    shares[i].pack(to_send[i]);
+        }
+    }
+    P.send_receive_all(to_send, received);
+    received[me] = to_send[me];
+
+    // n - t combinations are unknown to any t parties
+    vector<vector<open_type>> res;
+    vector<vector<open_type>> dealt(n, vector<open_type>(degrees.size()));
+    for (size_t j = 0; j < n_dealt; j++)
+    {
+        for (int i = 0; i < n; i++)
+            for (size_t c = 0; c < degrees.size(); c++)
+            {
+                if (i != me and me < get_dealer(degrees[c]).n_random)
+                    dealt[i][c].randomize(recv_prngs[i]);
+                else
+                    dealt[i][c] = received[i].template get<open_type>();
+            }
+        for (auto& row : hyper)
+        {
+            res.push_back(vector<open_type>(degrees.size()));
+            for (int i = 0; i < n; i++)
+                for (size_t c = 0; c < degrees.size(); c++)
+                    res.back()[c] += row[i] * dealt[i][c];
+        }
+    }
+    return res;
+}
+
+template<class T>
+PackedShamir<T>::PackedShamir(Player& P) :
+        randomness(P), oss(P), oss2(P), next_king(0), P(P)
+{
+    if (not P.is_encrypted())
+        insecure("unencrypted communication");
+    n = P.num_players();
+    threshold = ShamirMachine::s().threshold;
+    k = T::n_lanes();
+    degree = threshold + k - 1;
+    product_degree = 2 * degree + k - 1;
+    if (product_degree >= n)
+        throw runtime_error("too many lanes for packed Shamir");
+    packing = Points::packing(n, k);
+    reconstruction = Points::reconstruction(n, k, product_degree + 1);
+    T::set_lane_factors(packing[P.my_num()]);
+    dotprod = new_dotprod();
+}
+
+template<class T>
+void PackedShamir<T>::init_mul()
+{
+    products.clear();
+    deferred.clear();
+    results.clear();
+}
+
+template<class T>
+bool PackedShamir<T>::compatible(int lane, int other)
+{
+    // packed polynomials only multiply with sharings for all lanes
+    if (lane < -1 or other < -1)
+        return lane == -1 or other == -1;
+    return lane < 0 or other < 0 or lane == other;
+}
+
+template<class T>
+bool PackedShamir<T>::moved(const array<T, 2>& term, int i)
+{
+    // packed polynomials, and the second operand in another lane
+    return term[i].lane < -1
+            or (i == 1 and term[0].lane >= 0 and term[1].lane >= 0);
+}
+
+template<class T>
+void PackedShamir<T>::prepare(const open_type& product, int lane, int output)
+{
+    if (lane >= 0)
+        output = lane;
+    products.push_back({product, lane, output});
+}
+
+template<class T>
+void PackedShamir<T>::prepare_product(const T& x, const T& y, int output)
+{
+    if (x.lane >= -1 and y.lane >= -1 and compatible(x.lane, y.lane))
+        prepare(x * y, T::merge(x.lane, y.lane), output);
+    else
+    {
+        auto dotprod = new_dotprod();
+        add_term(dotprod, x, y);
+        finish(dotprod, output);
+    }
+}
+
+template<class T>
+void PackedShamir<T>::prepare_mul(const T& x, const T& y, int)
+{
+    prepare_product(x, y, -1);
+}
+
+template<class T>
+void PackedShamir<T>::muls(const vector<int>& reg, SubProcessor<T>& proc,
+        typename T::MAC_Check&, int size)
+{
+    assert(reg.size() % 3 == 0);
+    int n_regs = reg.size() / 3;
+
+    // element j of a vector goes to lane j mod k unless already in a lane
+    init_mul();
+    for (int i = 0; i < n_regs; i++)
+        for (int j = 0; j < size; j++)
+        {
+            auto& x = proc.S[reg[3 * i + 1] + j];
+            auto& y = proc.S[reg[3 * i + 2] + j];
+            prepare_product(x, y, size > 1 ? j % k : -1);
+        }
+    exchange();
+    for (int i = 0; i < n_regs; i++)
+        for (int j = 0; j < size; j++)
+            proc.S[reg[3 * i] + j] = finalize_mul();
+
+    this->counter += n_regs * size;
+}
+
+template<class T>
+typename PackedShamir<T>::DotProduct PackedShamir<T>::new_dotprod()
+{
+    return {vector<open_type>(k + 2), -1, {}};
+}
+
+template<class T>
+void PackedShamir<T>::add_term(DotProduct& dotprod, const T& x, const T& y)
+{
+    if (not compatible(x.lane, y.lane))
+        dotprod.terms.push_back({{x, y}});
+    else if (x.lane < -1 or y.lane < -1)
+    {
+        dotprod.shares[k + 1] += open_type(x) * open_type(y);
+        dotprod.lane = -2;
+    }
+    else
+    {
+        int lane = T::merge(x.lane, y.lane);
+        dotprod.shares[lane < 0 ? k : lane] += x * y;
+        if (lane >= 0 and dotprod.lane != lane)
+            dotprod.lane = dotprod.lane == -1 ? lane : -2;
+    }
+}
+
+template<class T>
+typename PackedShamir<T>::Product PackedShamir<T>::product(
+        const DotProduct& dotprod, int output)
+{
+    auto& shares = dotprod.shares;
+    int lane = dotprod.lane;
+    if (lane < -1)
+    {
+        // terms for all lanes count once
+        auto& factors = packing[P.my_num()];
+        open_type sum = shares[k + 1] + factors[0] * shares[k];
+        for (int l = 0; l < k; l++)
+            sum += factors[l] * shares[l];
+        return {sum, lane, -1};
+    }
+    else
+    {
+        auto sum = shares[k];
+        if (lane >= 0)
+            sum += shares[lane];
+        return {sum, lane, lane >= 0 ? lane : output};
+    }
+}
+
+template<class T>
+void PackedShamir<T>::finish(DotProduct& dotprod, int output)
+{
+    if (dotprod.terms.empty())
+        products.push_back(product(dotprod, output));
+    else
+    {
+        deferred.push_back({products.size(), dotprod, output});
+        products.push_back({});
+    }
+}
+
+template<class T>
+int PackedShamir<T>::add_group(GroupType type)
+{
+    groups.push_back({type, next_king, vector<int>(k, -1),
+        vector<open_type>(k), {}});
+    next_king = (next_king + 1) % n;
+    return groups.size() - 1;
+}
+
+template<class T>
+void PackedShamir<T>::exchange()
+{
+    if (not deferred.empty())
+    {
+        // operands without a common lane go to all lanes first
+        vector<Product> moves;
+        for (auto& x : deferred)
+            for (auto& term : x.dotprod.terms)
+                for (int i = 0; i < 2; i++)
+                    if (moved(term, i))
+                        moves.push_back({term[i], term[i].lane, -1});
+        vector<T> res;
+        run(moves, res);
+
+        size_t pos = 0;
+        for (auto& x : deferred)
+        {
+            auto terms = move(x.dotprod.terms);
+            x.dotprod.terms.clear();
+            for (auto& term : terms)
+            {
+                for (int i = 0; i < 2; i++)
+                    if (moved(term, i))
+                        term[i] = res.at(pos++);
+                add_term(x.dotprod, term[0], term[1]);
+            }
+            assert(x.dotprod.terms.empty());
+            products[x.index] = product(x.dotprod, x.output);
+        }
+        deferred.clear();
+    }
+
+    run(products, results);
+    results.reset();
+}
+
+template<class T>
+void PackedShamir<T>::run(const vector<Product>& products,
+        vector<T>& results)
+{
+    // products in specific lanes share polynomials across lanes,
+    // products for all lanes fill polynomials in order, except for
+    // values moved from a lane, and packed ones take a polynomial each
+    groups.clear();
+    vector<int> lane_counts(k), packed_groups, moved_counts(k), moved_groups;
+    int free_group = -1, free_slot = k;
+    auto slot_group = [&](GroupType type, vector<int>& counts,
+            vector<int>& lane_groups, int lane) -> Group&
+    {
+        int& count = counts.at(lane);
+        if (count == int(lane_groups.size()))
+            lane_groups.push_back(add_group(type));
+        return groups[lane_groups[count++]];
+    };
+    for (size_t i = 0; i < products.size(); i++)
+    {
+        auto& product = products[i];
+        if (product.lane < -1)
+        {
+            auto& group = groups[add_group(SUM)];
+            group.slots[0] = i;
+            group.values[0] = product.value;
+        }
+        else if (product.output >= 0)
+        {
+            auto& group = slot_group(PACKED, lane_counts, packed_groups,
+                    product.output);
+            group.slots[product.output] = i;
+            group.values[product.output] = product.value;
+        }
+        else if (product.lane >= 0)
+        {
+            auto& group = slot_group(ALL_LANES, moved_counts, moved_groups,
+                    product.lane);
+            group.slots[product.lane] = i;
+            group.values[product.lane] = product.value;
+        }
+        else
+        {
+            if (free_slot == k)
+            {
+                free_group = add_group(ALL_LANES);
+                free_slot = 0;
+            }
+            auto& group = groups[free_group];
+            group.slots[free_slot] = i;
+            group.values[free_slot++] = product.value;
+        }
+    }
+    size_t n_packed = packed_groups.size();
+
+    if (packed_masks.size() < n_packed)
+        buffer_masks(packed_masks, false, n_packed - packed_masks.size());
+    if (lane_masks.size() < groups.size() - n_packed)
+        buffer_masks(lane_masks, true,
+                groups.size() - n_packed - lane_masks.size());
+
+    // parties up to the product degree send their masked packing
+    int me = P.my_num();
+    oss.reset();
+    vector<vector<bool>> channels(n, vector<bool>(n));
+    for (auto& group : groups)
+    {
+        auto& masks = group.type == PACKED ? packed_masks : lane_masks;
+        group.mask = masks.back();
+        masks.pop_back();
+
+        for (int i = 0; i <= product_degree; i++)
+            channels[i][group.king] = true;
+        if (me <= product_degree)
+        {
+            open_type sum = group.mask[0];
+            if (group.type == SUM)
+                sum += group.values[0];
+            else
+                for (int l = 0; l < k; l++)
+                    if (group.slots[l] >= 0)
+                        sum += packing[me][l] * group.values[l];
+            sum.pack(oss[group.king]);
+        }
+    }
+    P.send_receive_all(channels, oss, received);
+    received[me] = oss.mine;
+
+    // kings reconstruct all lanes and reshare
+    oss2.reset();
+    vector<vector<bool>> channels2(n, vector<bool>(n));
+    vector<open_type> shares(product_degree + 1), values(k);
+    for (auto& group : groups)
+    {
+        channels2[group.king].assign(n, true);
+        if (group.king != me)
+            continue;
+        for (int i = 0; i <= product_degree; i++)
+            shares[i] = received[i].template get<open_type>();
+        for (int l = 0; l < k; l++)
+        {
+            values[l] = 0;
+            for (int i = 0; i <= product_degree; i++)
+                values[l] += reconstruction[l][i] * shares[i];
+        }
+        reshare(group, values);
+    }
+    P.send_receive_all(channels2, oss2, received2);
+    received2[me] = oss2.mine;
+
+    results.clear();
+    results.resize(products.size());
+    for (auto& group : groups)
+    {
+        auto& os = received2[group.king];
+        switch (group.type)
+        {
+        case PACKED:
+        {
+            auto value = os.template get<open_type>() - group.mask[1];
+            for (int l = 0; l < k; l++)
+                if (group.slots[l] >= 0)
+                    results[group.slots[l]] = T(value, l);
+            break;
+        }
+        case ALL_LANES:
+            for (int l = 0; l < k; l++)
+                if (group.slots[l] >= 0)
+                    results[group.slots[l]] = os.template get<open_type>()
+                            - group.mask[1 + l];
+            break;
+        case SUM:
+        {
+            auto value = os.template get<open_type>();
+            for (int l = 0; l < k; l++)
+                value -= group.mask[1 + l];
+            results[group.slots[0]] = value;
+            break;
+        }
+        }
+    }
+}
+
+template<class T>
+void PackedShamir<T>::reshare(const Group& group,
+        const vector<open_type>& values)
+{
+    switch (group.type)
+    {
+    case PACKED:
+        // polynomial of degree k - 1 through the masked lanes
+        for (int i = 0; i < n; i++)
+        {
+            open_type share;
+            for (int l = 0; l < k; l++)
+                share += packing[i][l] * values[l];
+            share.pack(oss2[i]);
+        }
+        break;
+    case ALL_LANES:
+        for (int l = 0; l < k; l++)
+            if (group.slots[l] >= 0)
+                for (auto& os : oss2)
+                    values[l].pack(os);
+        break;
+    case SUM:
+    {
+        open_type sum;
+        for (auto& x : values)
+            sum += x;
+        for (auto& os : oss2)
+            sum.pack(os);
+        break;
+    }
+    }
+}
+
+template<class T>
+T PackedShamir<T>::finalize_mul(int)
+{
+    return results.next();
+}
+
+template<class T>
+void PackedShamir<T>::init_dotprod()
+{
+    init_mul();
+    dotprod = new_dotprod();
+}
+
+template<class T>
+void PackedShamir<T>::prepare_dotprod(const T& x, const T& y)
+{
+    add_term(dotprod, x, y);
+}
+
+template<class T>
+void PackedShamir<T>::next_dotprod()
+{
+    finish(dotprod, -1);
+    dotprod = new_dotprod();
+}
+
+template<class T>
+T PackedShamir<T>::finalize_dotprod(int)
+{
+    return finalize_mul();
+}
+
+template<class T>
+void PackedShamir<T>::buffer_random()
+{
+    for (auto& x : randomness.tuples({degree}, {0},
+            OnlineOptions::singleton.batch_size))
+        this->random.push_back(x[0]);
+}
+
+template<class T>
+void PackedShamir<T>::buffer_masks(vector<vector<open_type>>& masks,
+        bool all_lanes, size_t n_masks)
+{
+    // same secrets with the degree of the products and of the sharing,
+    // the latter either packed or for all lanes
+    vector<int> degrees = {product_degree}, lanes = {-1};
+    if (all_lanes)
+        for (int l = 0; l < k; l++)
+        {
+            degrees.push_back(degree);
+            lanes.push_back(l);
+        }
+    else
+    {
+        degrees.push_back(degree);
+        lanes.push_back(-1);
+    }
+    n_masks = max(n_masks, size_t(DIV_CEIL(OnlineOptions::singleton.batch_size, k)));
+    auto tuples = randomness.tuples(degrees, lanes, n_masks);
+    masks.insert(masks.end(), tuples.begin(), tuples.end());
+}
+
+#endif /* PROTOCOLS_PACKEDSHAMIR_HPP_ */
@@ -0,0 +1,48 @@
+/*
+ * PackedShamirInput.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRINPUT_H_
+#define PROTOCOLS_PACKEDSHAMIRINPUT_H_
+
+#include "ShamirInput.h"
+#include "PackedShamir.h"
+
+/**
+ * Packed Shamir secret sharing input protocol.
+ * Inputs are shared for all lanes, the first ``t`` parties derive their
+ * shares from pairwise keys.
+ */
+template<class T>
+class PackedShamirInput : public IndividualInput<T>
+{
+    typedef typename T::open_type open_type;
+
+    PackedShamirDealer<open_type> dealer;
+
+    vector<open_type> lanes, randomness, dealt;
+
+public:
+    PackedShamirInput(SubProcessor<T>& proc, typename T::MAC_Check&) :
+            PackedShamirInput<T>(&proc, proc.P)
+    {
+    }
+
+    PackedShamirInput(SubProcessor<T>* proc, Player& P) :
+            IndividualInput<T>(proc, P),
+            dealer(P.num_players(), ShamirMachine::s().threshold + T::n_lanes() - 1,
+                    T::n_lanes())
+    {
+    }
+
+    PackedShamirInput(typename T::MAC_Check&, Preprocessing<T>&, Player& P) :
+            PackedShamirInput<T>(0, P)
+    {
+    }
+
+    void add_mine(const open_type& input, int n_bits = -1);
+    void finalize_other(int player, T& target, octetStream& o, int n_bits = -1);
+};
+
+#endif /* PROTOCOLS_PACKEDSHAMIRINPUT_H_ */
@@ -0,0 +1,47 @@
+/*
+ * PackedShamirInput.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRINPUT_HPP_
+#define PROTOCOLS_PACKEDSHAMIRINPUT_HPP_
+
+#include "PackedShamirInput.h"
+#include "ShamirInput.hpp"
+#include "PackedShamir.hpp"
+
+template<class T>
+void PackedShamirInput<T>::add_mine(const open_type& input, int)
+{
+    auto& P = this->P;
+
+    randomness.resize(dealer.n_random);
+    for (int i = 0; i < dealer.n_random; i++)
+        randomness[i].randomize(this->send_prngs[i]);
+    lanes.assign(T::n_lanes(), input);
+    dealer.deal(dealt, lanes, randomness);
+
+    for (int i = 0; i < P.num_players(); i++)
+        if (i == P.my_num())
+            this->shares.push_back(dealt[i]);
+        else if (i >= dealer.n_random)
+            dealt[i].pack(this->os[i]);
+
+    this->senders[P.my_num()] = true;
+}
+
+template<class T>
+void PackedShamirInput<T>::finalize_other(int player, T& target,
+        octetStream& o, int n_bits)
+{
+    if (this->P.my_num() < dealer.n_random)
+    {
+        open_type share;
+        share.randomize(this->recv_prngs.at(player));
+        target = share;
+    }
+    else
+        IndividualInput<T>::finalize_other(player, target, o, n_bits);
+}
+
+#endif /* PROTOCOLS_PACKEDSHAMIRINPUT_HPP_ */
@@ -0,0 +1,46 @@
+/*
+ * PackedShamirMC.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRMC_H_
+#define PROTOCOLS_PACKEDSHAMIRMC_H_
+
+#include "MAC_Check_Base.h"
+#include "PackedShamir.h"
+#include "Tools/Bundle.h"
+
+/**
+ * Packed Shamir secret sharing opening protocol.
+ * Shares are packed in polynomials of degree ``t + 2k - 2`` by lane,
+ * which the first ``t + 2k - 1`` parties broadcast. Polynomials with
+ * shares in specific lanes are masked with a random polynomial that is
+ * zero in the opened lanes and random in the others, and so are
+ * the ones summed over the lanes except that the mask sums up to zero.
+ */
+template<class T>
+class PackedShamirMC : public MAC_Check_Base<T>
+{
+    typedef typename T::open_type open_type;
+    typedef PackedShamirPoints<open_type> Points;
+
+    vector<vector<open_type>> packing, reconstruction;
+    int n_senders;
+
+    Bundle<octetStream>* os;
+    PackedShamirRandom<T>* randomness;
+    vector<vector<open_type>> masks;
+
+    PackedShamirMC(const PackedShamirMC&);
+
+public:
+    PackedShamirMC(typename T::mac_key_type = {}, int = 0, int = 0) :
+            n_senders(0), os(0), randomness(0)
+    {
+    }
+    ~PackedShamirMC();
+
+    void exchange(const Player& P);
+};
+
+#endif /* PROTOCOLS_PACKEDSHAMIRMC_H_ */
@@ -0,0 +1,164 @@
+/*
+ * PackedShamirMC.hpp
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRMC_HPP_
+#define PROTOCOLS_PACKEDSHAMIRMC_HPP_
+
+#include "PackedShamirMC.h"
+#include "PackedShamir.hpp"
+
+template<class T>
+PackedShamirMC<T>::~PackedShamirMC()
+{
+    if (os)
+        delete os;
+    if (randomness)
+        delete randomness;
+}
+
+template<class T>
+void PackedShamirMC<T>::exchange(const Player& P)
+{
+    int n = P.num_players();
+    int k = T::n_lanes();
+    int threshold = ShamirMachine::s().threshold;
+    if (not os)
+    {
+        os = new Bundle<octetStream>(P);
+        randomness = new PackedShamirRandom<T>(P);
+        n_senders = threshold + 2 * k - 1;
+        assert(n_senders <= n);
+        packing = Points::packing(n, k);
+        reconstruction = Points::reconstruction(n, k, n_senders);
+    }
+
+    // lane-specific shares by lane, shares for all lanes in order,
+    // summed shares on their own
+    auto& secrets = this->secrets;
+    vector<vector<int>> groups;
+    vector<bool> masked;
+    vector<int> lane_counts(k), packed_groups;
+    int free_group = -1, free_slot = k;
+    size_t n_masked = 0;
+    for (size_t i = 0; i < secrets.size(); i++)
+    {
+        int lane = secrets[i].lane;
+        if (lane < -1)
+        {
+            groups.push_back(vector<int>(k, -1));
+            groups.back()[0] = i;
+            masked.push_back(true);
+            n_masked++;
+        }
+        else if (lane >= 0)
+        {
+            int& count = lane_counts[lane];
+            if (count == int(packed_groups.size()))
+            {
+                // a single lane is plain Shamir
+                packed_groups.push_back(groups.size());
+                groups.push_back(vector<int>(k, -1));
+                masked.push_back(k > 1);
+                n_masked += k > 1;
+            }
+            groups[packed_groups[count++]][lane] = i;
+        }
+        else
+        {
+            if (free_slot == k)
+            {
+                free_group = groups.size();
+                groups.push_back(vector<int>(k, -1));
+                masked.push_back(false);
+                free_slot = 0;
+            }
+            groups[free_group][free_slot++] = i;
+        }
+    }
+
+    // random polynomial of the opening degree with the same secrets
+    // for all lanes
+    if (masks.size() < n_masked)
+    {
+        vector<int> degrees = {threshold + 2 * k - 2}, lanes = {-1};
+        for (int l = 0; l < k; l++)
+        {
+            degrees.push_back(threshold + k - 1);
+            lanes.push_back(l);
+        }
+        auto tuples = randomness->tuples(degrees, lanes,
+                max(n_masked - masks.size(),
+                        size_t(DIV_CEIL(OnlineOptions::singleton.batch_size,
+                                k))));
+        masks.insert(masks.end(), tuples.begin(), tuples.end());
+    }
+
+    int me = P.my_num();
+    os->reset();
+    for (size_t j = 0; j < groups.size(); j++)
+    {
+        auto& group = groups[j];
+        open_type sum;
+        if (masked[j])
+        {
+            auto& mask = masks.back();
+            sum = mask[0];
+            if (group[0] >= 0 and secrets[group[0]].lane < -1)
+            {
+                sum += secrets[group[0]];
+                for (int l = 0; l < k; l++)
+                    sum -= packing[me][0] * mask[1 + l];
+            }
+            else
+                for (int l = 0; l < k; l++)
+                    if (group[l] >= 0)
+                        sum += packing[me][l]
+                                * (secrets[group[l]] - mask[1 + l]);
+            masks.pop_back();
+        }
+        else
+            for (int l = 0; l < k; l++)
+                if (group[l] >= 0)
+                    sum += packing[me][l] * secrets[group[l]];
+        if (me < n_senders)
+            sum.pack(os->mine);
+    }
+
+    vector<bool> my_senders(n), my_receivers(n);
+    for (int i = 0; i < n; i++)
+    {
+        my_senders[i] = i < n_senders;
+        my_receivers[i] = me < n_senders;
+    }
+    P.partial_broadcast(my_senders, my_receivers, *os);
+
+    auto& values = this->values;
+    values.resize(secrets.size());
+    vector<open_type> shares(n_senders), lanes(k);
+    for (auto& group : groups)
+    {
+        for (int i = 0; i < n_senders; i++)
+            shares[i] = (*os)[i].template get<open_type>();
+        for (int l = 0; l < k; l++)
+        {
+            lanes[l] = 0;
+            for (int i = 0; i < n_senders; i++)
+                lanes[l] += reconstruction[l][i] * shares[i];
+        }
+        if (group[0] >= 0 and secrets[group[0]].lane < -1)
+        {
+            open_type value;
+            for (auto& x : lanes)
+                value += x;
+            values[group[0]] = value;
+        }
+        else
+            for (int l = 0; l < k; l++)
+                if (group[l] >= 0)
+                    values[group[l]] = lanes[l];
+    }
+}
+
+#endif /* PROTOCOLS_PACKEDSHAMIRMC_HPP_ */
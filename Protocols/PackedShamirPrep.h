@@ -0,0 +1,33 @@
+/*
+ * PackedShamirPrep.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRPREP_H_
+#define PROTOCOLS_PACKEDSHAMIRPREP_H_
+
+#include "ReplicatedPrep.h"
+
+/**
+ * Packed Shamir preprocessing, all results are shared for all lanes
+ */
+template<class T>
+class PackedShamirPrep : public ReplicatedPrep<T>
+{
+public:
+    PackedShamirPrep(SubProcessor<T>* proc, DataPositions& usage) :
+            BufferPrep<T>(usage), BitPrep<T>(proc, usage),
+            ReplicatedRingPrep<T>(proc, usage),
+            RingPrep<T>(proc, usage),
+            SemiHonestRingPrep<T>(proc, usage),
+            ReplicatedPrep<T>(proc, usage)
+    {
+    }
+
+    void buffer_inputs(int player)
+    {
+        this->buffer_inputs_as_usual(player, this->proc);
+    }
+};
+
+#endif /* PROTOCOLS_PACKEDSHAMIRPREP_H_ */
@@ -0,0 +1,187 @@
+/*
+ * PackedShamirShare.h
+ *
+ */
+
+#ifndef PROTOCOLS_PACKEDSHAMIRSHARE_H_
+#define PROTOCOLS_PACKEDSHAMIRSHARE_H_
+
+#include "ShamirShare.h"
+
+#include <mutex>
+
+template<class T> class PackedShamir;
+template<class T> class PackedShamirMC;
+template<class T> class PackedShamirInput;
+template<class T> class PackedShamirPrep;
+template<class T> class PrivateOutput;
+
+/**
+ * Packed Shamir secret sharing share. A polynomial holds several secrets
+ * at distinct points (lanes). ``lane`` is the one this share stands for,
+ * or -1 if the secret is the same in all lanes, which is the case for
+ * inputs, preprocessing, and constants. Only SIMD multiplication puts
+ * results into specific lanes. Combining shares in different lanes
+ * multiplies them with the Lagrange polynomials of their lanes, which
+ * results in a polynomial of degree ``t + 2k - 2`` whose values at the
+ * lanes sum up to the secret, denoted by -2.
+ */
+template<class T>
+class PackedShamirShare : public ShamirShare<T>
+{
+    typedef PackedShamirShare This;
+    typedef ShamirShare<T> super;
+
+public:
+    typedef PackedShamir<This> Protocol;
+    typedef PackedShamirMC<This> MAC_Check;
+    typedef PackedShamirMC<This> Direct_MC;
+    typedef PackedShamirInput<This> Input;
+    typedef ::PrivateOutput<This> PrivateOutput;
+    typedef PackedShamirPrep<This> LivePrep;
+    typedef PackedShamirShare Honest;
+
+    static const bool packed = true;
+
+    int lane;
+
+    static string type_short()
+    {
+        return "P" + super::type_short() + "K" + to_string(n_lanes());
+    }
+    static string type_string()
+    {
+        return "packed Shamir " + T::type_string();
+    }
+
+    static int n_lanes()
+    {
+        return PackedShamirOptions::singleton.pack;
+    }
+
+    // Lagrange polynomials of the lanes at the point of this party
+    static vector<T> lane_factors;
+
+    static void set_lane_factors(const vector<T>& factors)
+    {
+        static mutex lock;
+        lock_guard<mutex> guard(lock);
+        if (lane_factors.empty())
+            lane_factors = factors;
+        assert(lane_factors == factors);
+    }
+
+    static int merge(int lane, int other)
+    {
+        if (lane == -1 or lane == other)
+            return other;
+        if (other == -1)
+            return lane;
+        return -2;
+    }
+
+    static This constant(T value, int, const typename super::mac_key_type& = {})
+    {
+        return This(value);
+    }
+
+    PackedShamirShare() :
+            lane(-1)
+    {
+    }
+    template<class U>
+    PackedShamirShare(const U& other) :
+            super(other), lane(-1)
+    {
+    }
+    PackedShamirShare(const T& value, int lane) :
+            super(value), lane(lane)
+    {
+    }
+
+    This operator+(const This& other) const
+    {
+        int res = merge(lane, other.lane);
+        if (res < -1)
+            return {T(summed()) + other.summed(), res};
+        return {T(*this) + other, res};
+    }
+    This operator-(const This& other) const
+    {
+        int res = merge(lane, other.lane);
+        if (res < -1)
+            return {T(summed()) - other.summed(), res};
+        return {T(*this) - other, res};
+    }
+    This operator-() const
+    {
+        return {-T(*this), lane};
+    }
+    This operator*(const T& other) const
+    {
+        return {T(*this) * other, lane};
+    }
+    // local product of degree twice the sharing
+    T operator*(const This& other) const
+    {
+        assert(merge(lane, other.lane) >= -1);
+        return T(*this) * T(other);
+    }
+
+    // sharing with the secret as sum over the lanes
+    This summed() const
+    {
+        if (lane < -1)
+            return *this;
+        return {T(*this) * lane_factors.at(max(lane, 0)), -2};
+    }
+
+    This& operator+=(const This& other)
+    {
+        return *this = *this + other;
+    }
+    This& operator-=(const This& other)
+    {
+        return *this = *this - other;
+    }
+    This& operator*=(const T& other)
+    {
+        return *this = *this * other;
+    }
+
+    This operator<<(int i) const
+    {
+        return *this * (T(1) << i);
+    }
+    This& operator<<=(int i)
+    {
+        return *this = *this << i;
+    }
+
+    // lanes are not serialized
+    void pack(octetStream& os) const
+    {
+        check_serializable();
+        T::pack(os);
+    }
+    void pack(octetStream& os, const T& rec_factor) const
+    {
+        check_serializable();
+        super::pack(os, rec_factor);
+    }
+    void check_serializable() const
+    {
+        if (lane != -1)
+            throw runtime_error("cannot serialize share in specific lane");
+    }
+    void unpack(octetStream& os, bool full = true)
+    {
+        super::unpack(os, full);
+        lane = -1;
+    }
+};
+
+template<class T>
+vector<T> PackedShamirShare<T>::lane_factors;
+
+#endif /* PROTOCOLS_PACKEDSHAMIRSHARE_H_ */
@@ -11,9 +11,28 @@ class Rep3Shuffler
 {
     SubProcessor<T>& proc;
 
+    typedef typename T::clear clear;
+
     vector<array<vector<int>, 2>> shuffles;
 
+    PRNG& shared_prng(int other);
+    vector<clear> random(size_t n, PRNG& G);
+    void local_permute(vector<clear>& values, const vector<int>& perm,
+            int unit_size, bool reverse);
+
+    // vectors in the current order of a sort, permuted together
+    typedef vector<vector<T>> Rows;
+
+    vector<T> destinations(const vector<T>& bits);
+    vector<int> open_permutation(const vector<T>& values);
+    void permute(Rows& rows, const vector<T>& destinations);
+    void gather(Rows& rows, const vector<T>& sources, vector<T>& a,
+            const vector<size_t>& bases);
+
 public:
+    // key bits carried through the shuffles between two gathers
+    static const int RADIX_SORT_WINDOW = 4;
+
     Rep3Shuffler(vector<T>& a, size_t n, int unit_size, size_t output_base,
             size_t input_base, SubProcessor<T>& proc);
 
@@ -21,6 +40,13 @@ public:
 
     int generate(int n_shuffle);
 
+    /**
+     * Applies the composition of three permutations, each known to one
+     * pair of parties. Every pair holds the whole input or receives the
+     * missing part masked by randomness from a shared PRNG, so there is
+     * one round of masked messages for the permutations and one round to
+     * restore replicated sharing.
+     */
     void apply(vector<T>& a, size_t n, int unit_size, size_t output_base,
             size_t input_base, int handle, bool reverse);
 
@@ -28,6 +54,9 @@ public:
             size_t input_base);
 
     void del(int handle);
+
+    void radix_sort(vector<T>& a, size_t n, size_t output_base,
+            size_t input_base, size_t bits_base, int n_bits, bool permutation);
 };
 
 #endif /* PROTOCOLS_REP3SHUFFLER_H_ */
@@ -43,6 +43,37 @@ int Rep3Shuffler<T>::generate(int n_shuffle)
     return shuffles.size() - 1;
 }
 
+template<class T>
+PRNG& Rep3Shuffler<T>::shared_prng(int other)
+{
+    int offset = (other - proc.P.my_num() + 3) % 3;
+    assert(offset != 0);
+    return proc.protocol.shared_prngs[offset == 1 ? 0 : 1];
+}
+
+template<class T>
+vector<typename T::clear> Rep3Shuffler<T>::random(size_t n, PRNG& G)
+{
+    vector<clear> res(n);
+    for (auto& x : res)
+        x.randomize(G);
+    return res;
+}
+
+template<class T>
+void Rep3Shuffler<T>::local_permute(vector<clear>& values,
+        const vector<int>& perm, int unit_size, bool reverse)
+{
+    vector<clear> res(values.size());
+    for (size_t j = 0; j < values.size() / unit_size; j++)
+        for (int k = 0; k < unit_size; k++)
+            if (reverse)
+                res[j * unit_size + k] = values[perm.at(j) * unit_size + k];
+            else
+                res[perm.at(j) * unit_size + k] = values[j * unit_size + k];
+    values.swap(res);
+}
+
 template<class T>
 void Rep3Shuffler<T>::apply(vector<T>& a, size_t n, int unit_size,
         size_t output_base, size_t input_base, int handle, bool reverse)
@@ -52,67 +83,113 @@ void Rep3Shuffler<T>::apply(vector<T>& a, size_t n, int unit_size,
     assert(not T::dishonest_majority);
     assert(n % unit_size == 0);
 
+    auto& P = proc.P;
     auto& shuffle = shuffles.at(handle);
-    vector<T> to_shuffle;
-    for (size_t i = 0; i < n; i++)
-        to_shuffle.push_back(a[input_base + i]);
+    int me = P.my_num();
+
+    // the permutation of stage i is known to firsts[i] and the next party
+    array<int, 3> firsts = {{0, 1, 2}};
+    if (reverse)
+        firsts = {{2, 1, 0}};
+    auto stage = [&](vector<clear>& values, int i)
+    {
+        if (me == firsts[i])
+            local_permute(values, shuffle[0], unit_size, reverse);
+        else if (me == (firsts[i] + 1) % 3)
+            local_permute(values, shuffle[1], unit_size, reverse);
+    };
 
-    typename T::Input input(proc);
+    // parties left out of the three stages
+    int receiver = (firsts[0] + 2) % 3;
+    int sender = (firsts[1] + 2) % 3;
+    int helper = (firsts[2] + 2) % 3;
 
-    vector<typename T::clear> to_share(n);
+    // two-party sharing by sender and helper, the first pair
+    vector<clear> value(n);
+    for (size_t i = 0; i < n; i++)
+        if (me == firsts[0])
+            value[i] = a[input_base + i].sum();
+        else if (me != receiver)
+            value[i] = a[input_base + i][0];
+    stage(value, 0);
 
-    for (int ii = 0; ii < 3; ii++)
+    // the sender passes its part to the receiver for the second stage,
+    // the helper passes its part to the sender for the third stage
+    octetStream os;
+    if (me == sender)
     {
-        int i;
-        if (reverse)
-            i = 2 - ii;
-        else
-            i = ii;
+        auto mask = random(n, shared_prng(helper));
+        for (size_t i = 0; i < n; i++)
+            (value[i] + mask[i]).pack(os);
+        P.send_to(receiver, os);
+        P.receive_player(helper, os);
+        for (auto& x : value)
+            x.unpack(os);
+    }
+    else if (me == helper)
+    {
+        auto mask = random(n, shared_prng(sender));
+        for (size_t i = 0; i < n; i++)
+            value[i] -= mask[i];
+        stage(value, 1);
+        mask = random(n, shared_prng(receiver));
+        for (size_t i = 0; i < n; i++)
+            (value[i] + mask[i]).pack(os);
+        P.send_to(sender, os);
+    }
+    else
+    {
+        P.receive_player(sender, os);
+        for (auto& x : value)
+            x.unpack(os);
+        stage(value, 1);
+        auto mask = random(n, shared_prng(helper));
+        for (size_t i = 0; i < n; i++)
+            value[i] -= mask[i];
+    }
+    stage(value, 2);
 
-        if (proc.P.get_player(i) == 0)
+    // the helper gets its two shares from the shared PRNGs,
+    // the others exchange their parts of the remaining share
+    int next = (helper + 1) % 3, previous = (helper + 2) % 3;
+    if (me == helper)
+    {
+        auto mine = random(n, shared_prng(next));
+        auto other = random(n, shared_prng(previous));
+        for (size_t i = 0; i < n; i++)
         {
-            for (size_t j = 0; j < n / unit_size; j++)
-                for (int k = 0; k < unit_size; k++)
-                    if (reverse)
-                        to_share.at(j * unit_size + k) = to_shuffle.at(
-                                shuffle[0].at(j) * unit_size + k).sum();
-                    else
-                        to_share.at(shuffle[0].at(j) * unit_size + k) =
-                                to_shuffle.at(j * unit_size + k).sum();
+            a[output_base + i][0] = mine[i];
+            a[output_base + i][1] = other[i];
         }
-        else if (proc.P.get_player(i) == 1)
+    }
+    else
+    {
+        auto known = random(n, shared_prng(helper));
+        octetStream to_send, to_receive;
+        for (size_t i = 0; i < n; i++)
         {
-            for (size_t j = 0; j < n / unit_size; j++)
-                for (int k = 0; k < unit_size; k++)
-                    if (reverse)
-                        to_share[j * unit_size + k] = to_shuffle[shuffle[1][j]
-                                * unit_size + k][0];
-                    else
-                        to_share[shuffle[1][j] * unit_size + k] = to_shuffle[j
-                                * unit_size + k][0];
+            value[i] -= known[i];
+            value[i].pack(to_send);
         }
-
-        input.reset_all(proc.P);
-
-        if (proc.P.get_player(i) < 2)
-            for (auto& x : to_share)
-                input.add_mine(x);
-
-        for (int k = 0; k < 2; k++)
-            input.add_other((-i + 3 + k) % 3);
-
-        input.exchange();
-        to_shuffle.clear();
-
-        for (size_t j = 0; j < n; j++)
+        P.exchange(me == next ? previous : next, to_send, to_receive);
+        for (size_t i = 0; i < n; i++)
         {
-            T x = input.finalize((-i + 3) % 3) + input.finalize((-i + 4) % 3);
-            to_shuffle.push_back(x);
+            clear x;
+            x.unpack(to_receive);
+            x += value[i];
+            auto& res = a[output_base + i];
+            if (me == next)
+            {
+                res[0] = x;
+                res[1] = known[i];
+            }
+            else
+            {
+                res[0] = known[i];
+                res[1] = x;
+            }
         }
     }
-
-    for (size_t i = 0; i < n; i++)
-        a[output_base + i] = to_shuffle[i];
 }
 
 template<class T>
@@ -128,4 +205,197 @@ void Rep3Shuffler<T>::inverse_permutation(vector<T>&, size_t, size_t, size_t)
     throw runtime_error("inverse permutation not implemented");
 }
 
+/**
+ * Stable destinations when sorting by one bit: zeros keep their order
+ * before the ones. Local prefix sums and one multiplication round.
+ */
+template<class T>
+vector<T> Rep3Shuffler<T>::destinations(const vector<T>& bits)
+{
+    size_t n = bits.size();
+    int my_num = proc.P.my_num();
+    auto alphai = proc.MC.get_alphai();
+
+    vector<T> ones(n);
+    T sum;
+    for (size_t j = 0; j < n; j++)
+    {
+        sum += bits[j];
+        ones[j] = sum;
+    }
+    T zeros = T::constant(n, my_num, alphai) - sum;
+
+    // zero: j - ones[j], one: zeros + ones[j] - 1
+    auto& protocol = proc.protocol;
+    protocol.init_mul();
+    for (size_t j = 0; j < n; j++)
+        protocol.prepare_mul(bits[j],
+                zeros + ones[j] + ones[j]
+                        - T::constant(j + 1, my_num, alphai));
+    protocol.exchange();
+
+    vector<T> res(n);
+    for (size_t j = 0; j < n; j++)
+        res[j] = T::constant(j, my_num, alphai) - ones[j]
+                + protocol.finalize_mul();
+    protocol.counter += n;
+    return res;
+}
+
+template<class T>
+vector<int> Rep3Shuffler<T>::open_permutation(const vector<T>& values)
+{
+    size_t n = values.size();
+    auto& MC = proc.MC;
+    MC.init_open(proc.P, n);
+    for (auto& x : values)
+        MC.prepare_open(x);
+    MC.exchange(proc.P);
+
+    vector<int> res(n);
+    vector<bool> seen(n);
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t k = Integer(MC.finalize_open()).get();
+        if (k >= n or seen[k])
+            throw runtime_error("invalid permutation in radix sort");
+        seen[k] = true;
+        res[j] = k;
+    }
+    return res;
+}
+
+/**
+ * Moves element ``j`` of all rows to secret position ``destinations[j]``
+ * by revealing the shuffled destinations.
+ */
+template<class T>
+void Rep3Shuffler<T>::permute(Rows& rows, const vector<T>& destinations)
+{
+    size_t n = destinations.size();
+    int unit_size = rows.size() + 1;
+    vector<T> buffer(n * unit_size);
+    for (size_t j = 0; j < n; j++)
+    {
+        buffer[j * unit_size] = destinations[j];
+        for (size_t k = 0; k < rows.size(); k++)
+            buffer[j * unit_size + k + 1] = rows[k][j];
+    }
+
+    apply(buffer, buffer.size(), unit_size, 0, 0, generate(n), false);
+    shuffles.pop_back();
+
+    vector<T> shuffled(n);
+    for (size_t j = 0; j < n; j++)
+        shuffled[j] = buffer[j * unit_size];
+    auto indices = open_permutation(shuffled);
+
+    for (size_t j = 0; j < n; j++)
+        for (size_t k = 0; k < rows.size(); k++)
+            rows[k][indices[j]] = buffer[j * unit_size + k + 1];
+}
+
+/**
+ * Sets row ``k`` to the vector at ``a[bases[k]]`` in the order given by
+ * the secret indices ``sources``. The revealed indices are hidden by a
+ * shuffle that is undone afterwards.
+ */
+template<class T>
+void Rep3Shuffler<T>::gather(Rows& rows, const vector<T>& sources,
+        vector<T>& a, const vector<size_t>& bases)
+{
+    size_t n = sources.size();
+    int handle = generate(n);
+    vector<T> buffer = sources;
+    apply(buffer, n, 1, 0, 0, handle, false);
+    auto indices = open_permutation(buffer);
+
+    int unit_size = bases.size();
+    buffer.resize(n * unit_size);
+    for (size_t j = 0; j < n; j++)
+        for (int k = 0; k < unit_size; k++)
+            buffer[j * unit_size + k] = a.at(bases[k] + indices[j]);
+    apply(buffer, buffer.size(), unit_size, 0, 0, handle, true);
+    shuffles.pop_back();
+
+    rows.assign(unit_size, vector<T>(n));
+    for (size_t j = 0; j < n; j++)
+        for (int k = 0; k < unit_size; k++)
+            rows[k][j] = buffer[j * unit_size + k];
+}
+
+/**
+ * Stable radix sort by ``n_bits`` key bits (least significant first,
+ * ``n`` shares each from ``bits_base``). Outputs the sorted input or,
+ * with ``permutation``, the destination of every input element.
+ *
+ * Each bit costs one multiplication round, one shuffle of all carried
+ * vectors, and one opening. Up to ``RADIX_SORT_WINDOW`` upcoming key
+ * bits are carried along with the original indices, so the secret
+ * gather of the next bits is only needed once per window.
+ */
+template<class T>
+void Rep3Shuffler<T>::radix_sort(vector<T>& a, size_t n, size_t output_base,
+        size_t input_base, size_t bits_base, int n_bits, bool permutation)
+{
+    int my_num = proc.P.my_num();
+    auto alphai = proc.MC.get_alphai();
+
+    // original index of the element at every position
+    vector<T> origins(n);
+    for (size_t j = 0; j < n; j++)
+        origins[j] = T::constant(j, my_num, alphai);
+
+    Rows rows;
+    for (int i = 0; i < n_bits; i += RADIX_SORT_WINDOW)
+    {
+        int end = min(n_bits, i + RADIX_SORT_WINDOW);
+        bool last = end == n_bits;
+
+        vector<size_t> bases;
+        for (int k = i; k < end; k++)
+            bases.push_back(bits_base + k * n);
+        if (last and not permutation)
+            bases.push_back(input_base);
+
+        if (i == 0)
+        {
+            rows.clear();
+            for (auto base : bases)
+                rows.push_back(vector<T>(a.begin() + base, a.begin() + base + n));
+        }
+        else
+            gather(rows, origins, a, bases);
+
+        bool track = permutation or not last;
+        if (track)
+            rows.push_back(origins);
+
+        for (int k = i; k < end; k++)
+        {
+            auto dest = destinations(rows.front());
+            rows.erase(rows.begin());
+            permute(rows, dest);
+        }
+
+        if (track)
+        {
+            origins = rows.back();
+            rows.pop_back();
+        }
+    }
+
+    if (permutation)
+    {
+        // the element from origins[j] ends up at j
+        rows = {{}};
+        for (size_t j = 0; j < n; j++)
+            rows[0].push_back(T::constant(j, my_num, alphai));
+        permute(rows, origins);
+    }
+
+    for (size_t j = 0; j < n; j++)
+        a[output_base + j] = rows.at(0)[j];
+}
+
 #endif
@@ -11,6 +11,7 @@
 #include "Processor/TruncPrTuple.h"
 #include "Tools/benchmarking.h"
 #include "Tools/Bundle.h"
+#include "Tools/BitVector.h"
 
 #include "ReplicatedInput.h"
 #include "Rep3Share2k.h"
@@ -550,106 +551,81 @@ void Replicated<T>::change_domain(const vector<int>& regs, int reg_size, U& proc
   assert(proc.P.num_players() == 3);
   assert(proc.Proc != 0);
   typedef typename T::clear value_type;
-  typedef typename T::clear bit_type;
-  ReplicatedInput<T> input(P);
 
   int n = regs.size() / 4;
   int ring_bit_length =  regs[2];
+  size_t n_elements = n * reg_size;
+  int my_num = P.my_num();
 
-  vector<T> dabits;
-  vector<typename T::bit_type> bits;
-  vector<bit_type> lsbs_mask_0;
-  vector<bit_type> lsbs_mask_1;
-  dabits.resize(n * reg_size);
-  bits.resize(n * reg_size);
-  lsbs_mask_0.resize(n * reg_size);
-  lsbs_mask_1.resize(n * reg_size);
-  for (int i = 0; i < n * reg_size; i++){
-    proc.DataF.get_dabit_no_count(dabits[i], bits[i]);
-  }
-  if (P.my_num() == 0){
-    octetStream cs;
-    octetStream cs_2;
-    for (int i = 0; i < n; i++){
-      for (int k = 0; k < reg_size; k++){
-        value_type temp = proc.S[regs[4 * i + 1] + k].sum();
-        temp = temp - ((temp >> ring_bit_length) << ring_bit_length);
-        input.add_mine(temp);
-        value_type overflow_0 = temp >> (ring_bit_length - 1);
-        input.add_mine(overflow_0);
-
-        lsbs_mask_0[i * reg_size + k] = (bit_type) (overflow_0 & 0x1) ^ bits[i * reg_size + k][0] ^ bits[i * reg_size + k][1];
-        lsbs_mask_0[i * reg_size + k].pack(cs);
-        lsbs_mask_0[i * reg_size + k].pack(cs_2);
-        }
-    }
-    P.send_to(1, cs);
-    P.send_to(2, cs_2);
-    octetStream cs1;
+  vector<T> dabits(n_elements);
+  vector<typename T::bit_type> bits(n_elements);
+  proc.DataF.get_dabits_no_count(dabits.data(), bits.data(), n_elements);
 
-    P.receive_player(1, cs1);
-    for (int i = 0; i < n * reg_size; i++){
-      lsbs_mask_1[i] = cs1.get<bit_type>();
-    }
-  }
-  if (P.my_num() == 1){
+  value_type size(1);
+  size = size << (ring_bit_length - 1);
 
-    octetStream cs;
-    octetStream cs_2;
-    for (int i = 0; i < n; i++){
-      for (int k = 0; k < reg_size; k++){
-        value_type temp = proc.S[regs[4 * i + 1] + k][0];
-        input.add_mine(temp);
-
-        value_type overflow_1 = -((-temp).arith_right_shift( ring_bit_length - 1));;
-        input.add_mine(overflow_1);
-
-        lsbs_mask_1[i * reg_size + k] = (bit_type) (overflow_1 & 0x1) ^ bits[i * reg_size + k][0];
-        lsbs_mask_1[i * reg_size + k].pack(cs);
-        lsbs_mask_1[i * reg_size + k].pack(cs_2);
+  // party 0 inputs the sum of its two components minus the overflow,
+  // the third component is known to parties 1 and 2 and shared locally,
+  // so only party 0's input and the packed LSB masks go over the wire
+  vector<T> wholes(n_elements);
+  BitVector lsbs_mask_0(n_elements), lsbs_mask_1(n_elements);
+  vector<octetStream> to_send(3), to_receive;
+  for (int i = 0; i < n; i++){
+    for (int k = 0; k < reg_size; k++){
+      size_t j = i * reg_size + k;
+      auto& source = proc.S[regs[4 * i + 1] + k];
+      auto& whole = wholes[j];
+      if (my_num == 0){
+        value_type temp = source.sum();
+        temp = temp - ((temp >> ring_bit_length) << ring_bit_length);
+        value_type overflow_0 = temp >> (ring_bit_length - 1);
+        whole[0].randomize(shared_prngs[0]);
+        whole[1] = temp - overflow_0 * size - whole[0];
+        whole[1].pack(to_send[2]);
+        lsbs_mask_0.set_bit(j, overflow_0.get_bit(0) ^
+            ((bits[j][0].get() ^ bits[j][1].get()) & 1));
+      }
+      else{
+        // party 1 holds the component at index 0, party 2 at index 1
+        int index = my_num - 1;
+        value_type temp = source[index];
+        value_type overflow_1 = -((-temp).arith_right_shift(ring_bit_length - 1));
+        if (my_num == 1)
+          whole[1].randomize(shared_prngs[1]);
+        whole[index] += temp - overflow_1 * size;
+        lsbs_mask_1.set_bit(j, overflow_1.get_bit(0) ^ (bits[j][index].get() & 1));
       }
-    }
-    P.send_to(0, cs);
-    P.send_to(2, cs_2);
-    octetStream cs0;
-
-    P.receive_player(0, cs0);
-    for (int i = 0; i < n * reg_size; i++){
-      lsbs_mask_0[i] = cs0.get<bit_type>();
-    }
-  }
-  if (P.my_num() == 2){
-
-    octetStream cs0;
-    octetStream cs1;
-    P.receive_player(0, cs0);
-    P.receive_player(1, cs1);
-    for (int i = 0; i < n * reg_size; i++){
-      lsbs_mask_0[i] = cs0.get<bit_type>();
-      lsbs_mask_1[i] = cs1.get<bit_type>();
     }
   }
 
-  input.add_other(0);
-  input.add_other(1);
-  input.exchange();
-
-  value_type size(1);
-  size = size << (ring_bit_length - 1);
+  vector<vector<bool>> channels(3, vector<bool>(3, false));
+  channels[0][1] = channels[0][2] = channels[1][0] = true;
+  if (my_num == 0){
+    lsbs_mask_0.pack(to_send[1]);
+    lsbs_mask_0.pack(to_send[2]);
+  }
+  if (my_num == 1)
+    lsbs_mask_1.pack(to_send[0]);
+  P.send_receive_all(channels, to_send, to_receive);
+  if (my_num == 2)
+    for (size_t j = 0; j < n_elements; j++)
+      wholes[j][0].unpack(to_receive[0]);
+  if (my_num != 0)
+    lsbs_mask_0.unpack(to_receive[0]);
+  else
+    lsbs_mask_1.unpack(to_receive[1]);
+  lsbs_mask_0.add(lsbs_mask_1);
 
   for (int i = 0; i < n; i++) {
     for (int k = 0; k < reg_size; k++) {
-      auto temp_0 = input.finalize(0);
-      auto overflow_0 = input.finalize(0);
-      auto temp_1 = input.finalize(1);
-      auto overflow_1 = input.finalize(1);
-      auto lsb_mask = lsbs_mask_0[i * reg_size + k] ^ lsbs_mask_1[i * reg_size + k];
+      size_t j = i * reg_size + k;
+      value_type lsb_mask = lsbs_mask_0.get_bit(j);
 
-      auto lsb = dabits[i * reg_size + k]  -  dabits[i * reg_size + k] * 2 * lsb_mask;
-      if (P.my_num() < 2)
-        lsb[P.my_num()] = lsb[P.my_num()] + lsb_mask;
+      auto lsb = dabits[j]  -  dabits[j] * 2 * lsb_mask;
+      if (my_num < 2)
+        lsb[my_num] = lsb[my_num] + lsb_mask;
 
-      proc.S[regs[4 * i] + k] = temp_0 + temp_1 - (overflow_0 + overflow_1 - lsb) * size;
+      proc.S[regs[4 * i] + k] = wholes[j] + lsb * size;
     }
   }
 }
@@ -109,6 +109,7 @@ public:
             int vector_size);
 
     virtual void get_dabit_no_count(T& a, typename T::bit_type& b);
+    virtual void get_dabits_no_count(T* a, typename T::bit_type* b, size_t n);
 
     /// Get fresh random value
     virtual T get_random();
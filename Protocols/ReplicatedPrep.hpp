@@ -1111,6 +1111,33 @@ void BufferPrep<T>::get_dabit_no_count(T& a, typename T::bit_type& b)
     dabits.pop_back();
 }
 
+template<class T>
+void BufferPrep<T>::get_dabits_no_count(T* a, typename T::bit_type* b,
+        size_t n)
+{
+    size_t done = 0;
+    while (done < n)
+    {
+        if (dabits.empty())
+        {
+            InScope in_scope(this->do_count, false);
+            ThreadQueues* queues = 0;
+            buffer_dabits(queues);
+            assert(not dabits.empty());
+        }
+        size_t m = min(n - done, dabits.size());
+        auto it = dabits.end();
+        for (size_t i = 0; i < m; i++)
+        {
+            --it;
+            a[done + i] = it->first;
+            b[done + i] = it->second;
+        }
+        dabits.erase(it, dabits.end());
+        done += m;
+    }
+}
+
 template<class T>
 void BufferPrep<T>::get_personal_dabit(int player, T& a, typename T::bit_type& b)
 {
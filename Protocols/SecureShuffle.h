@@ -7,6 +7,7 @@
 #define PROTOCOLS_SECURESHUFFLE_H_
 
 #include <vector>
+#include <map>
 using namespace std;
 
 template<class T> class SubProcessor;
@@ -24,6 +25,10 @@ class SecureShuffle
     size_t n_shuffle;
     bool exact;
 
+    // configured shuffles not used yet by size
+    map<int, vector<vector<vector<vector<T>>>>> pool;
+    map<int, int> batch_sizes;
+
     /**
      * Generates and returns a newly generated random permutation. This permutation is generated locally.
      *
@@ -45,6 +50,16 @@ class SecureShuffle
      * @param n_shuffle The size of the permutation to generate.
      */
     void configure(int config_player, vector<int>* perm, int n);
+    void configure(int config_player, const vector<vector<int>>& perms, int n,
+            vector<vector<vector<T>>>& configs);
+
+    /**
+     * Configures a batch of shuffles of size ``n_shuffle`` with one input
+     * round per relevant player. The batch size doubles with every
+     * refill of the same size up to ``POOL_SIZE`` elements. Applying a
+     * pooled shuffle still evaluates the networks in O(log n) rounds.
+     */
+    void buffer(int n_shuffle);
     void player_round(int config_player);
 
     void waksman(vector<T>& a, int depth, int start);
@@ -57,6 +72,8 @@ class SecureShuffle
     void post(vector<T>& a, size_t n, size_t input_base);
 
 public:
+    static const int POOL_SIZE = 1 << 16;
+
     SecureShuffle(vector<T>& a, size_t n, int unit_size,
             size_t output_base, size_t input_base, SubProcessor<T>& proc);
 
@@ -96,6 +113,9 @@ public:
     void inverse_permutation(vector<T>& stack, size_t n, size_t output_base, size_t input_base);
 
     void del(int handle);
+
+    void radix_sort(vector<T>& a, size_t n, size_t output_base,
+            size_t input_base, size_t bits_base, int n_bits, bool permutation);
 };
 
 #endif /* PROTOCOLS_SECURESHUFFLE_H_ */
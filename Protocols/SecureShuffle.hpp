@@ -37,6 +37,9 @@ void SecureShuffle<T>::apply(vector<T>& a, size_t n, int unit_size, size_t outpu
 {
     this->unit_size = unit_size;
 
+    if (n == 0)
+        return;
+
     pre(a, n, input_base);
 
     auto& shuffle = shuffles.at(handle);
@@ -140,6 +143,14 @@ void SecureShuffle<T>::del(int handle)
     shuffles.at(handle).clear();
 }
 
+template<class T>
+void SecureShuffle<T>::radix_sort(vector<T>&, size_t, size_t, size_t, size_t,
+        int, bool)
+{
+    throw runtime_error("native radix sort only implemented for "
+            "three-party replicated secret sharing");
+}
+
 template<class T>
 void SecureShuffle<T>::pre(vector<T>& a, size_t n, size_t input_base)
 {
@@ -233,81 +244,128 @@ template<class T>
 int SecureShuffle<T>::generate(int n_shuffle)
 {
     int res = shuffles.size();
-    shuffles.push_back({});
-    auto& shuffle = shuffles.back();
 
+    // nothing to configure or pool for empty shuffles
+    if (n_shuffle == 0)
+    {
+        shuffles.push_back({});
+        return res;
+    }
+
+    auto& available = pool[n_shuffle];
+    if (available.empty())
+        buffer(n_shuffle);
+
+    shuffles.push_back(move(available.back()));
+    available.pop_back();
+    return res;
+}
+
+template<class T>
+void SecureShuffle<T>::buffer(int n_shuffle)
+{
+    auto& batch_size = batch_sizes[n_shuffle];
+    batch_size = max(1, min(2 * batch_size, POOL_SIZE / n_shuffle));
+
+    auto& available = pool[n_shuffle];
+    available.resize(batch_size);
     for (auto i: proc.protocol.get_relevant_players()) {
-        vector<int> perm;
+        vector<vector<int>> perms(batch_size);
         if (proc.P.my_num() == i)
-            perm = generate_random_permutation(n_shuffle);
-        configure(i, &perm, n_shuffle);
+            for (auto& perm : perms)
+                perm = generate_random_permutation(n_shuffle);
+        vector<vector<vector<T>>> configs;
+        configure(i, perms, n_shuffle, configs);
 
-        shuffle.push_back(config);
+        for (int j = 0; j < batch_size; j++)
+            available[j].push_back(move(configs[j]));
     }
-
-    return res;
 }
 
 template<class T>
 void SecureShuffle<T>::configure(int config_player, vector<int> *perm, int n) {
+    vector<vector<int>> perms(1);
+    if (proc.P.my_num() == config_player)
+        perms[0] = *perm;
+    vector<vector<vector<T>>> configs;
+    configure(config_player, perms, n, configs);
+    config = configs.at(0);
+}
+
+template<class T>
+void SecureShuffle<T>::configure(int config_player,
+        const vector<vector<int>>& perms, int n,
+        vector<vector<vector<T>>>& configs) {
     auto &P = proc.P;
     auto &input = proc.input;
     input.reset_all(P);
     int n_pow2 = 1 << int(ceil(log2(n)));
     Waksman waksman(n_pow2);
 
-    // The player specified by config_player configures the shared waksman network
-    // using its personal permutation
-    if (P.my_num() == config_player) {
-        auto config_bits = waksman.configure(*perm);
-        for (size_t i = 0; i < config_bits.size(); i++) {
-            auto &x = config_bits[i];
-            for (size_t j = 0; j < x.size(); j++)
-                if (waksman.matters(i, j) and not waksman.is_double(i, j))
-                    input.add_mine(int(x[j]));
-                else if (waksman.is_double(i, j))
-                    assert(x[j] == x[j - 1]);
-                else
-                    assert(x[j] == 0);
-        }
-        // The other player waits for its share of the configured waksman network
-    } else
-        for (size_t i = 0; i < waksman.n_bits(); i++)
-            input.add_other(config_player);
+    // The player specified by config_player configures the shared waksman networks
+    // using its personal permutations
+    for (auto& perm : perms)
+    {
+        if (P.my_num() == config_player) {
+            auto config_bits = waksman.configure(perm);
+            for (size_t i = 0; i < config_bits.size(); i++) {
+                auto &x = config_bits[i];
+                for (size_t j = 0; j < x.size(); j++)
+                    if (waksman.matters(i, j) and not waksman.is_double(i, j))
+                        input.add_mine(int(x[j]));
+                    else if (waksman.is_double(i, j))
+                        assert(x[j] == x[j - 1]);
+                    else
+                        assert(x[j] == 0);
+            }
+            // The other player waits for its share of the configured waksman network
+        } else
+            for (size_t i = 0; i < waksman.n_bits(); i++)
+                input.add_other(config_player);
+    }
 
     input.exchange();
-    config.clear();
+    configs.clear();
     typename T::Protocol checker(P);
     checker.init(proc.DataF, proc.MC);
     checker.init_dotprod();
     auto one = T::constant(1, P.my_num(), proc.MC.get_alphai());
-    for (size_t i = 0; i < waksman.n_rounds(); i++)
+    for (size_t k = 0; k < perms.size(); k++)
     {
-        config.push_back({});
-        for (int j = 0; j < n_pow2; j++)
+        configs.push_back({});
+        auto& network = configs.back();
+        for (size_t i = 0; i < waksman.n_rounds(); i++)
         {
-            if (waksman.matters(i, j) and not waksman.is_double(i, j))
+            network.push_back({});
+            for (int j = 0; j < n_pow2; j++)
             {
-                config.back().push_back(input.finalize(config_player));
-                if (T::malicious)
-                    checker.prepare_dotprod(config.back().back(),
-                            one - config.back().back());
+                if (waksman.matters(i, j) and not waksman.is_double(i, j))
+                {
+                    network.back().push_back(input.finalize(config_player));
+                    if (T::malicious)
+                        checker.prepare_dotprod(network.back().back(),
+                                one - network.back().back());
+                }
+                else if (waksman.is_double(i, j))
+                    network.back().push_back(network.back().back());
+                else
+                    network.back().push_back({});
             }
-            else if (waksman.is_double(i, j))
-                config.back().push_back(config.back().back());
-            else
-                config.back().push_back({});
         }
+        if (T::malicious)
+            checker.next_dotprod();
     }
 
     if (T::malicious)
     {
-        checker.next_dotprod();
         checker.exchange();
-        assert(
-                typename T::clear(
-                        proc.MC.open(checker.finalize_dotprod(waksman.n_bits()),
-                                P)) == 0);
+        auto& MC = proc.MC;
+        MC.init_open(P, perms.size());
+        for (size_t k = 0; k < perms.size(); k++)
+            MC.prepare_open(checker.finalize_dotprod(waksman.n_bits()));
+        MC.exchange(P);
+        for (size_t k = 0; k < perms.size(); k++)
+            assert(typename T::clear(MC.finalize_open()) == 0);
         checker.check();
     }
 }
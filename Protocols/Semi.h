@@ -7,6 +7,7 @@
 #define PROTOCOLS_SEMI_H_
 
 #include "SPDZ.h"
+#include "OTShuffler.h"
 #include "Processor/TruncPrTuple.h"
 
 #include "Tools_PSI/SimpleIndex.h"
@@ -28,6 +29,8 @@ class Semi : public SPDZ<T>
   SeededPRNG G;
 
 public:
+  typedef OTShuffler<T> Shuffler;
+
   Semi(Player &P) : SPDZ<T>(P)
   {
   }
@@ -616,98 +619,61 @@ public:
     assert(proc.P.num_players() == 2);
     assert(proc.Proc != 0);
     typedef typename T::clear value_type;
-    typedef typename T::clear bit_type;
 
     int n = regs.size() / 4;
     int ring_bit_length = regs[2];
+    size_t n_elements = n * reg_size;
+    int my_num = this->P.my_num();
 
-    vector<T> dabits;
-    vector<typename T::bit_type> bits;
-    vector<bit_type> lsbs_mask_0;
-    vector<bit_type> lsbs_mask_1;
-    dabits.resize(n * reg_size);
-    bits.resize(n * reg_size);
-    lsbs_mask_0.resize(n * reg_size);
-    lsbs_mask_1.resize(n * reg_size);
-    for (int i = 0; i < n * reg_size; i++)
-    {
-      proc.DataF.get_dabit_no_count(dabits[i], bits[i]);
-    }
-    if (this->P.my_num() == 0)
-    {
-      octetStream cs;
-      for (int i = 0; i < n; i++)
-      {
-        for (int k = 0; k < reg_size; k++)
-        {
-          value_type d0 = proc.S[regs[4 * i + 1] + k];
-          proc.input.add_mine(d0);
-          value_type overflow_0 = d0 >> (ring_bit_length - 1);
-          proc.input.add_mine(overflow_0);
-          lsbs_mask_0[i * reg_size + k] = (bit_type)(overflow_0 & 0x1) ^ bits[i * reg_size + k];
-          lsbs_mask_0[i * reg_size + k].pack(cs);
-        }
-      }
-      this->P.send_to(1, cs);
-      octetStream cs1;
-
-      this->P.receive_player(1, cs1);
-      for (int i = 0; i < n * reg_size; i++)
-      {
-        lsbs_mask_1[i] = cs1.get<bit_type>();
-      }
-    }
-    if (this->P.my_num() == 1)
-    {
-
-      octetStream cs;
-
-      for (int i = 0; i < n; i++)
-      {
-        for (int k = 0; k < reg_size; k++)
-        {
-          value_type d1 = proc.S[regs[4 * i + 1] + k];
-          proc.input.add_mine(d1);
+    vector<T> dabits(n_elements);
+    vector<typename T::bit_type> bits(n_elements);
+    proc.DataF.get_dabits_no_count(dabits.data(), bits.data(), n_elements);
 
-          value_type overflow_1 = -((-d1).arith_right_shift(ring_bit_length - 1));
-          ;
-          proc.input.add_mine(overflow_1);
-
-          lsbs_mask_1[i * reg_size + k] = (bit_type)(overflow_1 & 0x1) ^ bits[i * reg_size + k];
-          lsbs_mask_1[i * reg_size + k].pack(cs);
-        }
-      }
-      this->P.send_to(0, cs);
-      octetStream cs0;
+    value_type size(1);
+    size = size << (ring_bit_length - 1);
 
-      this->P.receive_player(0, cs0);
-      for (int i = 0; i < n * reg_size; i++)
+    // the overflow is folded into the input, only its LSB masked
+    // with a daBit goes over the wire, one bit per element
+    BitVector lsb_masks(n_elements), other_masks;
+    for (int i = 0; i < n; i++)
+    {
+      for (int k = 0; k < reg_size; k++)
       {
-        lsbs_mask_0[i] = cs0.get<bit_type>();
+        size_t j = i * reg_size + k;
+        value_type d = proc.S[regs[4 * i + 1] + k];
+        value_type overflow;
+        if (my_num == 0)
+          overflow = d >> (ring_bit_length - 1);
+        else
+          overflow = -((-d).arith_right_shift(ring_bit_length - 1));
+        proc.input.add_mine(d - overflow * size);
+        lsb_masks.set_bit(j, overflow.get_bit(0) ^ (bits[j].get() & 1));
       }
     }
 
+    octetStream cs;
+    lsb_masks.pack(cs);
+    this->P.exchange(1 - my_num, cs);
+    other_masks.unpack(cs);
+    lsb_masks.add(other_masks);
+
     proc.input.add_other(0);
     proc.input.add_other(1);
     proc.input.exchange();
 
-    value_type size(1);
-    size = size << (ring_bit_length - 1);
-
     for (int i = 0; i < n; i++)
     {
       for (int k = 0; k < reg_size; k++)
       {
+        size_t j = i * reg_size + k;
         auto d0 = proc.input.finalize(0);
-        auto overflow_0 = proc.input.finalize(0);
         auto d1 = proc.input.finalize(1);
-        auto overflow_1 = proc.input.finalize(1);
-        auto lsb_mask = lsbs_mask_0[i * reg_size + k] ^ lsbs_mask_1[i * reg_size + k];
-        auto lsb = dabits[i * reg_size + k] - dabits[i * reg_size + k] * 2 * lsb_mask;
-        if (this->P.my_num() == 0)
+        value_type lsb_mask = lsb_masks.get_bit(j);
+        auto lsb = dabits[j] - dabits[j] * 2 * lsb_mask;
+        if (my_num == 0)
           lsb = lsb + lsb_mask;
 
-        proc.S[regs[4 * i] + k] = d0 + d1 - (overflow_0 + overflow_1 - lsb) * size;
+        proc.S[regs[4 * i] + k] = d0 + d1 + lsb * size;
       }
     }
   }
@@ -41,6 +41,8 @@ public:
     static const bool has_split = false;
     static const bool has_mac = false;
     static const bool malicious = false;
+    // shares carry more than their values, see PackedShamirShare
+    static const bool packed = false;
 
     static const false_type triple_matmul;
 
@@ -21,6 +21,9 @@ class Vss : public Semi<T>
     MatrixMC<T> mc;
 
 public:
+    // reconstruction is not a plain sum of shares
+    typedef SecureShuffle<T> Shuffler;
+
     Vss(Player &P) : Semi<T>(P)
     {
     }
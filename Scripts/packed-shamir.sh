@@ -0,0 +1,18 @@
+#!/usr/bin/env bash
+
+HERE=$(cd `dirname $0`; pwd)
+SPDZROOT=$HERE/..
+
+export PLAYERS=${PLAYERS:-6}
+
+if test "$THRESHOLD"; then
+    t="-T $THRESHOLD"
+fi
+
+if test "$PACK"; then
+    k="-K $PACK"
+fi
+
+. $HERE/run-common.sh
+
+run_player packed-shamir-party.x $* $t $k || exit 1
@@ -0,0 +1,11 @@
+#!/bin/bash
+
+./compile.py -R 64 test_checkpoint || exit 1
+
+mkdir -p Programs/Public-Input
+echo 1234 > Programs/Public-Input/test_checkpoint
+Scripts/semi2k.sh test_checkpoint --checkpoint 0 || exit 1
+
+# the second run cannot read the input
+rm Programs/Public-Input/test_checkpoint
+Scripts/semi2k.sh test_checkpoint --restore || exit 1
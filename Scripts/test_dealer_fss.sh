@@ -0,0 +1,4 @@
+#!/bin/bash
+
+./compile.py -R 64 -C -K LTZ,EQZ,Trunc test_dealer_fss || exit 1
+Scripts/dealer-ring.sh test_dealer_fss || exit 1
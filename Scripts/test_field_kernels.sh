@@ -0,0 +1,4 @@
+#!/bin/bash
+
+make field-kernels-test.x || exit 1
+./field-kernels-test.x || exit 1
@@ -0,0 +1,4 @@
+#!/bin/bash
+
+./compile.py -R 64 -C -K MTS,ReLUTrunc,LUT test_fss || exit 1
+Scripts/fss-ring.sh test_fss || exit 1
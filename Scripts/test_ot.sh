@@ -0,0 +1,7 @@
+#!/bin/bash
+
+make ot-test.x || exit 1
+
+./ot-test.x 0 & sender=$!
+./ot-test.x 1 || exit 1
+wait $sender || exit 1
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+./compile.py test_packed_shamir || exit 1
+
+# one lane is plain Shamir with king-based multiplication,
+# two lanes is the most six parties allow with one corruption
+for pack in 1 2; do
+    PLAYERS=6 THRESHOLD=1 PACK=$pack Scripts/packed-shamir.sh \
+	   test_packed_shamir || exit 1
+done
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# more triples than one round produces, so that the next proof runs
+# in the background
+n=600000
+
+make pairwise-offline.x Check-Offline.x || exit 1
+
+for lt in 1 3; do
+    rm -f Player-Data/2-p-128/Triples-p-P*
+    ./pairwise-offline.x -p 0 -n $n -lt $lt -o & pid=$!
+    ./pairwise-offline.x -p 1 -n $n -lt $lt -o || exit 1
+    wait $pid || exit 1
+    # the checker only stops when running out of triples, and it fails
+    # later for lack of GF(2^n) keys
+    out=$(./Check-Offline.x 2 -m 2>&1)
+    echo "$out" | grep gfp
+    ! echo "$out" | grep -q 'value is wrong' || exit 1
+    echo "$out" | grep -q "after [1-9][0-9]* triples of type SPDZ gfp" || exit 1
+done
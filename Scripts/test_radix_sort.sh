@@ -0,0 +1,4 @@
+#!/bin/bash
+
+./compile.py -R 64 --radixsort test_radix_sort || exit 1
+Scripts/ring.sh test_radix_sort || exit 1
@@ -0,0 +1,4 @@
+#!/bin/bash
+
+make rns-test.x || exit 1
+./rns-test.x || exit 1
@@ -0,0 +1,9 @@
+#!/bin/bash
+
+./compile.py -R 64 test_shuffle || exit 1
+
+# semi2k uses the generic shuffler, replicated-ring the masked
+# three-party protocol with pooled configurations
+for protocol in semi2k ring; do
+    Scripts/$protocol.sh test_shuffle || exit 1
+done
@@ -0,0 +1,122 @@
+/*
+ * field-kernels-test.cpp
+ *
+ * Compares the vector kernels for prime fields with element-wise
+ * arithmetic, see Scripts/test_field_kernels.sh
+ */
+
+#include "Math/FieldKernels.h"
+#include "Math/gfp.hpp"
+#include "Protocols/Share.h"
+
+template<class T>
+bool equal(const T& x, const T& y)
+{
+    return x == y;
+}
+
+template<class T>
+bool equal(const Share<T>& x, const Share<T>& y)
+{
+    return x.get_share() == y.get_share() and x.get_mac() == y.get_mac();
+}
+
+template<class T>
+void check(const vector<T>& actual, const vector<T>& expected,
+        const string& name)
+{
+    assert(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); i++)
+        if (not equal(actual[i], expected[i]))
+        {
+            cerr << name << " wrong at " << i << " of " << actual.size()
+                    << endl;
+            exit(1);
+        }
+}
+
+template<class T>
+void test(int lgp)
+{
+    typedef FieldKernels<T> kernels;
+    typedef Share<T> share_type;
+    T::init_default(lgp);
+    cout << "testing " << T::type_string() << " with " << lgp << "-bit prime"
+            << (kernels::native() ? "" : " without kernels") << endl;
+
+    SeededPRNG G;
+    // beyond 1024, the inner product propagates carries within the loop
+    for (size_t size : {1, 7, 8, 9, 100, 1001, 5000})
+    {
+        vector<T> x(size), y(size), res(size), expected(size);
+        vector<share_type> shares(size), share_res(size),
+                share_expected(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            x[i].randomize(G);
+            y[i].randomize(G);
+            shares[i].set_share(x[i]);
+            shares[i].set_mac(y[i] + x[i]);
+        }
+        T scalar;
+        scalar.randomize(G);
+
+        for (size_t i = 0; i < size; i++)
+            expected[i] = x[i] * y[i];
+        kernels::mul(res.data(), x.data(), y.data(), size);
+        check(res, expected, "mul");
+
+        for (size_t i = 0; i < size; i++)
+            expected[i] = x[i] * scalar;
+        kernels::mul(res.data(), x.data(), scalar, size);
+        check(res, expected, "scalar mul");
+
+        // in place
+        res = x;
+        for (size_t i = 0; i < size; i++)
+            expected[i] = x[i] * y[i];
+        kernels::mul(res.data(), res.data(), y.data(), size);
+        check(res, expected, "in-place mul");
+
+        for (size_t i = 0; i < size; i++)
+            share_expected[i] = shares[i] * y[i];
+        kernels::mul(share_res.data(), shares.data(), y.data(), size);
+        check(share_res, share_expected, "share mul");
+
+        for (size_t i = 0; i < size; i++)
+            share_expected[i] = shares[i] * scalar;
+        kernels::mul(share_res.data(), shares.data(), scalar, size);
+        check(share_res, share_expected, "scalar share mul");
+
+        share_res = shares;
+        kernels::mul(share_res.data(), share_res.data(), scalar, size);
+        check(share_res, share_expected, "in-place scalar share mul");
+
+        T sum;
+        for (size_t i = 0; i < size; i++)
+            sum += x[i] * y[i];
+        check<T>({kernels::inner_product(x.data(), y.data(), size)}, {sum},
+                "inner product");
+
+        // unreduced coefficients as in MAC checking
+        vector<T> z(size);
+        sum = {};
+        for (size_t i = 0; i < size; i++)
+        {
+            z[i].almost_randomize(G);
+            sum += z[i] * y[i];
+        }
+        check<T>({kernels::inner_product(z.data(), y.data(), size)}, {sum},
+                "inner product with unreduced values");
+    }
+}
+
+int main()
+{
+    test<gfp_<0, 2>>(128);
+    test<gfp_<1, 2>>(100);
+    test<gfp_<2, 3>>(190);
+    test<gfp_<3, 4>>(255);
+    // fallback to element-wise arithmetic
+    test<gfp_<4, 1>>(60);
+}
@@ -0,0 +1,133 @@
+/*
+ * ot-test.cpp
+ *
+ * Checks the transposition of bit matrices and the correlation
+ * q = t ^ b * delta of OT extensions, see Scripts/test_ot.sh
+ */
+
+#include "OT/SilentOT.h"
+#include "Networking/Player.h"
+#include "Processor/OnlineOptions.h"
+
+// compare the vectorized transposition with single bits
+void check_transpose()
+{
+    PRNG G;
+    G.ReSeed();
+    for (int k = 0; k < 100; k++)
+    {
+        square128 x, y;
+        x.randomize(G);
+        y = x;
+        y.transpose();
+        for (int i = 0; i < 128; i++)
+            for (int j = 0; j < 128; j++)
+                if (x.get_bit(i, j) != y.get_bit(j, i))
+                {
+                    cerr << "wrong transposition at " << i << ", " << j
+                            << endl;
+                    exit(1);
+                }
+    }
+    cout << "transposition correct" << endl;
+}
+
+// receiver sends choices and outputs for the sender to check
+void check(TwoPartyPlayer& P, OT_ROLE role, int nOTs, const BitMatrix& sender,
+        const BitMatrix& receiver, const BitVector& choices, int128 delta,
+        const string& name)
+{
+    octetStream os;
+    if (role & RECEIVER)
+    {
+        choices.pack(os);
+        for (int i = 0; i < nOTs; i++)
+            os.serialize(int128(receiver.squares.at(i / 128).rows[i % 128]));
+        P.send(os);
+        return;
+    }
+
+    P.receive(os);
+    BitVector b;
+    b.unpack(os);
+    for (int i = 0; i < nOTs; i++)
+    {
+        int128 t, q = sender.squares.at(i / 128).rows[i % 128];
+        os.unserialize(t);
+        if (b.get_bit(i))
+            t ^= delta;
+        if (q != t)
+        {
+            cerr << name << ": wrong correlation at " << i << " of " << nOTs
+                    << endl;
+            exit(1);
+        }
+    }
+    cout << name << ": " << nOTs << " correct OTs" << endl;
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " <player number 0/1> [<port>]"
+                << endl;
+        exit(1);
+    }
+
+    check_transpose();
+
+    int my_num = atoi(argv[1]);
+    int port = argc > 2 ? atoi(argv[2]) : 14000;
+    Names N(my_num, 2, "localhost", port);
+    RealTwoPartyPlayer P(N, 1 - my_num, "ot");
+    OT_ROLE role = my_num == 0 ? SENDER : RECEIVER;
+
+    PRNG G;
+    G.ReSeed();
+    int128 delta = G.get_doubleword();
+    auto ext = OTExtensionWithMatrix::setup(P, delta, role, true);
+
+    // bootstrapping from IKNP and requests within and across iterations
+    SilentOT silent(&P, role, BitVector(&delta, 128));
+    BitVector choices(SilentOT::reserve());
+    choices.randomize(G);
+    ext.extend_iknp(choices.size(), choices);
+    silent.bootstrap(ext.senderOutputMatrices[0], ext.receiverOutputMatrix,
+            choices);
+    for (int nOTs : {1000, 100, 6000000, 5000000})
+    {
+        choices.resize(nOTs);
+        choices.randomize(G);
+        silent.extend(nOTs, choices);
+        check(P, role, nOTs, silent.senderOutputMatrices[0],
+                silent.receiverOutputMatrix, choices, delta, "silent");
+    }
+
+    // the extension switches once the requests exceed the reserve
+    for (int nOTs : {1000, SilentOT::reserve(), 1000})
+    {
+        choices.resize(nOTs);
+        choices.randomize(G);
+        ext.extend_correlated(nOTs, choices);
+        check(P, role, nOTs, ext.senderOutputMatrices[0],
+                ext.receiverOutputMatrix, choices, delta, "extension");
+    }
+
+    // IKNP with several pipeline slices of 256 squares,
+    // with and without threads
+    int nOTs = 100000;
+    for (bool passive : {true, false})
+        for (int n_threads : {1, 3})
+        {
+            OnlineOptions::singleton.local_threads = n_threads;
+            auto iknp = OTExtensionWithMatrix::setup(P, delta, role, passive);
+            choices.resize(nOTs);
+            choices.randomize(G);
+            iknp.extend_iknp(nOTs, choices);
+            check(P, role, nOTs, iknp.senderOutputMatrices[0],
+                    iknp.receiverOutputMatrix, choices, delta,
+                    string(passive ? "passive" : "active") + " IKNP with "
+                            + to_string(n_threads) + " threads");
+        }
+}
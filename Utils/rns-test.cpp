@@ -0,0 +1,112 @@
+/*
+ * rns-test.cpp
+ *
+ * Compares the transforms and products with word-size primes
+ * (FFT_Data::use_rns) with the ones modulo the ciphertext prime,
+ * see Scripts/test_rns.sh. Transforms for power-of-two m always use
+ * the ciphertext prime, the ones for prime m use Bluestein's algorithm.
+ */
+
+#include "FHE/Ring_Element.h"
+#include "FHE/NTL-Subs.h"
+#include "Processor/OnlineOptions.h"
+#include "Tools/time-func.h"
+
+// prime with lgp bits that allows both kinds of transforms for m
+bigint find_prime(int m, int lgp)
+{
+    bigint step = bigint(m) << (numBits(m) + 1);
+    bigint p = ((bigint(1) << (lgp - 1)) / step + 1) * step + 1;
+    while (not probPrime(p))
+        p += step;
+    return p;
+}
+
+// Phi_m has all coefficients one for prime m, so the ring does not
+// need NTL
+Ring prime_ring(int m)
+{
+    vector<int> pi, pi_inv(m, -1), poly(m, 1);
+    for (int i = 1; i < m; i++)
+    {
+        pi_inv[i] = pi.size();
+        pi.push_back(i);
+    }
+    octetStream o;
+    o.store(m);
+    o.store(m - 1);
+    o.store(pi);
+    o.store(pi_inv);
+    o.store(poly);
+    Ring R;
+    R.unpack(o);
+    return R;
+}
+
+void check(const Ring_Element& actual, const Ring_Element& expected,
+        const string& name)
+{
+    if (not actual.equals(expected))
+    {
+        cerr << name << " differs with word-size primes" << endl;
+        exit(1);
+    }
+}
+
+void test(int m, int lgp)
+{
+    Ring R;
+    if (((m - 1) & m) == 0)
+        init(R, m);
+    else
+        R = prime_ring(m);
+    bigint p = find_prime(m, lgp);
+    FFT_Data FFTD(R, Zp_Data(p));
+
+    PRNG G;
+    G.ReSeed();
+    Ring_Element a(FFTD, polynomial), b(FFTD, polynomial);
+    a.randomize(G);
+    b.randomize(G);
+
+    Ring_Element evaluated[2], product[2];
+    Timer timers[2];
+    for (int use_rns = 0; use_rns < 2; use_rns++)
+    {
+        FFT_Data::use_rns = use_rns;
+        Ring_Element x = a;
+        x.change_rep(evaluation);
+        evaluated[use_rns] = x;
+        x.change_rep(polynomial);
+        check(x, a, "round trip");
+        // the second product excludes setting up the primes
+        for (int i = 0; i < 2; i++)
+        {
+            timers[use_rns].reset();
+            timers[use_rns].start();
+            mul(product[use_rns], a, b);
+            timers[use_rns].stop();
+        }
+    }
+
+    check(evaluated[1], evaluated[0], "evaluation");
+    check(product[1], product[0], "product");
+    cout << "m=" << m << " with " << numBits(p) << "-bit prime correct, "
+            << "product " << timers[0].elapsed() << " vs "
+            << timers[1].elapsed() << " seconds with word-size primes"
+            << endl;
+}
+
+int main()
+{
+    for (int n_threads : {1, 3})
+    {
+        OnlineOptions::singleton.local_threads = n_threads;
+        cout << "using " << n_threads << " local threads" << endl;
+        for (int lgp : {64, 130, 330})
+        {
+            for (int m : {16, 64, 1024, 8192, 31, 127, 1031, 4099})
+                test(m, lgp);
+        }
+    }
+}